@@ -0,0 +1,62 @@
+#!/bin/sh
+#
+# Loads, organizes and renders synthetic directories of increasing size.
+# The per-contact cost should stay flat as the directory grows; if it
+# climbs with the size then something has gone quadratic.
+#
+# The largest directory is then loaded with 1 to N parser threads
+# (BENCH_JOBS, e.g. "1 2 4 8") to show how --jobs scales.
+#
+# Finally every phase is timed separately for each size, once with the
+# plain directory and once with BENCH_ZONES zones and UTF-8 names of
+# BENCH_NAME_LENGTH characters. The results go to bench/data/phases.json
+# so that versions can be compared.
+#
+# Usage: bench/bench.sh <timezoner> <generate> <phases> <sizes...>
+#
+TIMEZONER=$1
+GENERATE=$2
+PHASES=$3
+shift 3
+
+mkdir -p bench/data
+
+for size in "$@"; do
+	config="bench/data/contacts-$size.cfg"
+
+	if [ ! -f "$config" ]; then
+		"$GENERATE" "$size" > "$config" || exit 1
+	fi
+
+	if [ ! -f "bench/data/contacts-$size-utf8.cfg" ]; then
+		"$GENERATE" "$size" "${BENCH_ZONES:-128}" "${BENCH_NAME_LENGTH:-48}" > "bench/data/contacts-$size-utf8.cfg" || exit 1
+	fi
+
+	echo "== $size contacts =="
+	for grouping in -T -U; do
+		echo "  $grouping:"
+		"$TIMEZONER" -f "$config" --mmap -m $grouping --stats 2>&1 > /dev/null | sed 's/^/    /'
+	done
+done
+
+echo "== $size contacts, parsing with --jobs =="
+for jobs in ${BENCH_JOBS:-1 2 4 8}; do
+	echo "  $jobs:"
+	"$TIMEZONER" -f "$config" -j "$jobs" -m --stats 2>&1 > /dev/null | grep '^Loaded' | sed 's/^/    /'
+done
+
+echo "== phases =="
+version=$(git describe --always --dirty 2>/dev/null || echo unknown)
+{
+	printf '{"version": "%s", "runs": [\n' "$version"
+	separator=""
+	for size in "$@"; do
+		for config in "bench/data/contacts-$size.cfg" "bench/data/contacts-$size-utf8.cfg"; do
+			printf '%s' "$separator"
+			"$PHASES" "$config" || exit 1
+			separator=","
+		done
+	done
+	printf ']}\n'
+} > bench/data/phases.json
+cat bench/data/phases.json
@@ -0,0 +1,171 @@
+/*
+ * Copyright (C) 2019-2025, Joe Marrero. http://www.joemarrero.com/
+ * Copyright (C) 2017, End Point Corporation. http://www.endpoint.com/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+/*
+ * Generates a synthetic timezoner configuration on stdout for benchmarking.
+ *
+ *   generate <contacts> [zones] [name-length]
+ *
+ * Contacts are spread over the first 'zones' zones (40 by default, up to
+ * 128). A name length gives every contact a UTF-8 name of at least that
+ * many characters, mixing accented Latin, Greek, Cyrillic, Hangul and CJK
+ * so that wide characters are exercised; such lines may be longer than
+ * the streaming parser allows, so read them with --mmap.
+ */
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+static const char* ZONES[] = {
+	"America/New_York", "America/Chicago", "America/Denver", "America/Los_Angeles",
+	"America/Anchorage", "America/Phoenix", "America/Sao_Paulo", "America/Mexico_City",
+	"America/Toronto", "America/Bogota", "America/Argentina/Buenos_Aires", "America/St_Johns",
+	"Europe/London", "Europe/Berlin", "Europe/Paris", "Europe/Madrid",
+	"Europe/Istanbul", "Europe/Moscow", "Europe/Kyiv", "Europe/Lisbon",
+	"Africa/Cairo", "Africa/Lagos", "Africa/Johannesburg", "Africa/Nairobi",
+	"Asia/Kolkata", "Asia/Kathmandu", "Asia/Tokyo", "Asia/Shanghai",
+	"Asia/Singapore", "Asia/Dubai", "Asia/Tehran", "Asia/Seoul",
+	"Australia/Sydney", "Australia/Adelaide", "Australia/Perth", "Pacific/Auckland",
+	"Pacific/Honolulu", "Pacific/Chatham", "Atlantic/Reykjavik", "UTC",
+	/* only used when more zones are asked for */
+	"America/Halifax", "America/Lima", "America/Santiago", "America/Caracas",
+	"America/Havana", "America/Guatemala", "America/Panama", "America/Montevideo",
+	"America/Asuncion", "America/La_Paz", "America/Manaus", "America/Noronha",
+	"America/Nuuk", "America/Edmonton", "America/Vancouver", "America/Winnipeg",
+	"America/Regina", "America/Boise", "America/Juneau", "America/Adak",
+	"Europe/Dublin", "Europe/Amsterdam", "Europe/Brussels", "Europe/Zurich",
+	"Europe/Rome", "Europe/Vienna", "Europe/Prague", "Europe/Warsaw",
+	"Europe/Budapest", "Europe/Bucharest", "Europe/Athens", "Europe/Helsinki",
+	"Europe/Stockholm", "Europe/Oslo", "Europe/Copenhagen", "Europe/Riga",
+	"Europe/Vilnius", "Europe/Tallinn", "Europe/Minsk", "Europe/Samara",
+	"Africa/Casablanca", "Africa/Algiers", "Africa/Tunis", "Africa/Accra",
+	"Africa/Abidjan", "Africa/Kinshasa", "Africa/Khartoum", "Africa/Addis_Ababa",
+	"Africa/Maputo", "Africa/Windhoek", "Asia/Karachi", "Asia/Dhaka",
+	"Asia/Yangon", "Asia/Bangkok", "Asia/Jakarta", "Asia/Manila",
+	"Asia/Hong_Kong", "Asia/Taipei", "Asia/Ho_Chi_Minh", "Asia/Kabul",
+	"Asia/Tashkent", "Asia/Almaty", "Asia/Yekaterinburg", "Asia/Novosibirsk",
+	"Asia/Vladivostok", "Asia/Jerusalem", "Asia/Riyadh", "Asia/Baghdad",
+	"Asia/Baku", "Asia/Colombo", "Asia/Pyongyang", "Asia/Ulaanbaatar",
+	"Australia/Brisbane", "Australia/Darwin", "Australia/Hobart", "Australia/Eucla",
+	"Australia/Lord_Howe", "Pacific/Fiji", "Pacific/Guam", "Pacific/Tongatapu",
+	"Pacific/Kiritimati", "Pacific/Marquesas", "Pacific/Pago_Pago", "Pacific/Port_Moresby",
+	"Atlantic/Azores", "Atlantic/Cape_Verde", "Indian/Maldives", "Indian/Mauritius"
+};
+
+#define DEFAULT_ZONES     (40)
+
+static const char* FIRST_NAMES[] = {
+	"Edward", "Henry", "John", "Samuel", "William", "Israel", "Anne", "Mary", "Grace", "Ching"
+};
+
+static const char* LAST_NAMES[] = {
+	"Teach", "Morgan", "Auger", "Bellamy", "Kidd", "Hands", "Bonny", "Read", "O'Malley", "Shih"
+};
+
+static const char* UTF8_FIRST_NAMES[] = {
+	"Zoë", "Łukasz", "Søren", "Ἀλέξανδρος", "Владимир", "太郎", "Ngọc Ánh", "François", "Jürgen", "지민"
+};
+
+static const char* UTF8_LAST_NAMES[] = {
+	"Müller", "Ødegård", "Čapek", "山田", "Иванова", "Nguyễn", "García Núñez", "Σπυρίδων", "Þórsdóttir", "김"
+};
+
+#define countof(array)    (sizeof(array) / sizeof(array[0]))
+
+static size_t utf8_length( const char* s );
+
+
+int main( int argc, char* argv[] )
+{
+	if( argc < 2 )
+	{
+		fprintf( stderr, "Usage: %s <contacts> [zones] [name-length]\n", argv[0] );
+		return -1;
+	}
+
+	long contacts = atol( argv[1] );
+	size_t zones  = argc > 2 ? (size_t) atol( argv[2] ) : DEFAULT_ZONES;
+	size_t name_length = argc > 3 ? (size_t) atol( argv[3] ) : 0;
+
+	if( zones < 1 || zones > countof(ZONES) )
+	{
+		zones = zones < 1 ? DEFAULT_ZONES : countof(ZONES);
+	}
+
+	unsigned long seed = 2463534242UL; // deterministic output
+
+	printf( "# Timezone           Email                  Name                OfficePhone         MobilePhone\n" );
+
+	for( long i = 0; i < contacts; i++ )
+	{
+		char name[ 1024 ];
+
+		seed ^= seed << 13;
+		seed ^= seed >> 17;
+		seed ^= seed << 5;
+		seed &= 0xFFFFFFFFUL;
+
+		const char* zone  = ZONES[ seed % zones ];
+		const char* first = FIRST_NAMES[ (seed >> 8) % countof(FIRST_NAMES) ];
+		const char* last  = LAST_NAMES[ (seed >> 16) % countof(LAST_NAMES) ];
+
+		if( name_length > 0 )
+		{
+			size_t length = snprintf( name, sizeof(name), "%s %s %ld",
+			                          UTF8_FIRST_NAMES[ (seed >> 8) % countof(UTF8_FIRST_NAMES) ],
+			                          UTF8_LAST_NAMES[ (seed >> 16) % countof(UTF8_LAST_NAMES) ], i );
+
+			// More surnames until it's long enough (or the buffer is full).
+			for( unsigned long part = seed >> 4; utf8_length( name ) < name_length && length < sizeof(name) - 32; part /= 3 )
+			{
+				const char* more = UTF8_LAST_NAMES[ (part + length) % countof(UTF8_LAST_NAMES) ];
+				length += snprintf( name + length, sizeof(name) - length, "-%s", more );
+			}
+		}
+		else
+		{
+			snprintf( name, sizeof(name), "%s %s %ld", first, last, i );
+		}
+
+		printf( "%-20s \"%s.%s%ld@example.com\"  \"%s\"  \"+1 %03lu 555 %04lu\"  \"+1 %03lu 555 %04lu\"\n",
+		        zone, first, last, i, name,
+		        (seed >> 4) % 1000, (unsigned long) i % 10000,
+		        (seed >> 12) % 1000, (seed >> 20) % 10000 );
+	}
+
+	return 0;
+}
+
+/*
+ * Characters (not bytes) in a UTF-8 string.
+ */
+size_t utf8_length( const char* s )
+{
+	size_t length = 0;
+
+	for( ; *s; s++ )
+	{
+		length += ((unsigned char) *s & 0xC0) != 0x80;
+	}
+
+	return length;
+}
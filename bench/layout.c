@@ -0,0 +1,257 @@
+/*
+ * Copyright (C) 2019-2025, Joe Marrero. http://www.joemarrero.com/
+ * Copyright (C) 2017, End Point Corporation. http://www.endpoint.com/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+/*
+ * Compares grouping and sorting contacts as an array of structs (the
+ * layout timezoner used to organize) with the columnar contact store.
+ *
+ *   layout [contacts] [repetitions]
+ *
+ * "first" is a one-shot run: building the store is included. "regroup"
+ * is what --watch does every minute once the store exists.
+ */
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <wchar.h>
+#include <locale.h>
+#include <time.h>
+#include <collections/tree-map.h>
+#include "../src/timezoner.h"
+#include "../src/arena.h"
+#include "../src/store.h"
+#include "../src/zone.h"
+
+static const char* ZONES[] = {
+	"America/New_York", "America/Chicago", "America/Denver", "America/Los_Angeles",
+	"America/Anchorage", "America/Phoenix", "America/Sao_Paulo", "America/Mexico_City",
+	"America/Toronto", "America/Bogota", "America/Argentina/Buenos_Aires", "America/St_Johns",
+	"Europe/London", "Europe/Berlin", "Europe/Paris", "Europe/Madrid",
+	"Europe/Istanbul", "Europe/Moscow", "Europe/Kyiv", "Europe/Lisbon",
+	"Africa/Cairo", "Africa/Lagos", "Africa/Johannesburg", "Africa/Nairobi",
+	"Asia/Kolkata", "Asia/Kathmandu", "Asia/Tokyo", "Asia/Shanghai",
+	"Asia/Singapore", "Asia/Dubai", "Asia/Tehran", "Asia/Seoul",
+	"Australia/Sydney", "Australia/Adelaide", "Australia/Perth", "Pacific/Auckland",
+	"Pacific/Honolulu", "Pacific/Chatham", "Atlantic/Reykjavik", "UTC"
+};
+
+static const char* FIRST_NAMES[] = {
+	"Edward", "Henry", "John", "Samuel", "William", "Israel", "Anne", "Mary", "Grace", "Ching"
+};
+
+static const char* LAST_NAMES[] = {
+	"Teach", "Morgan", "Auger", "Bellamy", "Kidd", "Hands", "Bonny", "Read", "O'Malley", "Shih"
+};
+
+#define countof(array)    (sizeof(array) / sizeof(array[0]))
+
+static bool   map_element_destroy ( void *p_key, void *p_value );
+static int    map_compare         ( const void *p_key_left, const void *p_key_right );
+static int    name_compare        ( const void *l, const void *r );
+static void   organize_structs    ( const timezone_contact_t* contacts, lc_tree_map_t* map, tz_zone_cache_t* zones );
+static double elapsed             ( const struct timespec* start );
+
+
+int main( int argc, char* argv[] )
+{
+	long count = argc > 1 ? atol( argv[1] ) : 1000000;
+	int repetitions = argc > 2 ? atoi( argv[2] ) : 5;
+	unsigned long seed = 2463534242UL; // deterministic output
+
+	setlocale( LC_ALL, "" );
+
+	tz_zone_cache_t zones;
+	tz_zone_cache_create( &zones, time(NULL) );
+
+	tz_arena_t strings;
+	tz_arena_create( &strings, TZ_ARENA_BLOCK_SIZE );
+
+	timezone_contact_t* contacts = NULL;
+	lc_vector_create( contacts, count + 1 );
+
+	if( !contacts )
+	{
+		fprintf( stderr, "Out of memory.\n" );
+		return -1;
+	}
+
+	// Strings are interleaved in the arena the way the parser leaves them.
+	for( long i = 0; i < count; i++ )
+	{
+		char email[ 64 ], name[ 64 ], phone[ 32 ];
+
+		seed ^= seed << 13;
+		seed ^= seed >> 17;
+		seed ^= seed << 5;
+		seed &= 0xFFFFFFFFUL;
+
+		const char* first = FIRST_NAMES[ (seed >> 8) % countof(FIRST_NAMES) ];
+		const char* last  = LAST_NAMES[ (seed >> 16) % countof(LAST_NAMES) ];
+
+		snprintf( email, sizeof(email), "%s.%s%ld@example.com", first, last, i );
+		snprintf( name, sizeof(name), "%s %s %ld", first, last, i );
+		snprintf( phone, sizeof(phone), "+1 %03lu 555 %04lu", (seed >> 4) % 1000, (unsigned long) i % 10000 );
+
+		timezone_contact_t contact = (timezone_contact_t) {
+			.zone          = tz_zone_cache_intern( &zones, ZONES[ seed % countof(ZONES) ] ),
+			.email         = tz_arena_mbstowcs( &strings, email ),
+			.name          = tz_arena_mbstowcs( &strings, name ),
+			.office_phone  = tz_arena_mbstowcs( &strings, phone ),
+			.mobile_phone  = tz_arena_mbstowcs( &strings, phone ),
+			.working_hours = { -1, -1 }
+		};
+		lc_vector_push( contacts, contact );
+	}
+
+	double structs_first = 0.0, structs_regroup = 0.0;
+	double store_first = 0.0, store_regroup = 0.0;
+
+	for( int repetition = 0; repetition < repetitions; repetition++ )
+	{
+		struct timespec start;
+		lc_tree_map_t map;
+		lc_tree_map_create( &map, map_element_destroy, map_compare, malloc, free );
+
+		// Every zone goes stale, as it does when the minute changes.
+		tz_zone_cache_set_time( &zones, zones.now + 60 );
+		clock_gettime( CLOCK_MONOTONIC, &start );
+		organize_structs( contacts, &map, &zones );
+		double t = elapsed( &start );
+		structs_first = repetition == 0 || t < structs_first ? t : structs_first;
+
+		lc_tree_map_clear( &map );
+		tz_zone_cache_set_time( &zones, zones.now + 60 );
+		clock_gettime( CLOCK_MONOTONIC, &start );
+		organize_structs( contacts, &map, &zones );
+		t = elapsed( &start );
+		structs_regroup = repetition == 0 || t < structs_regroup ? t : structs_regroup;
+
+		tz_contact_store_t store;
+		lc_tree_map_clear( &map );
+		tz_zone_cache_set_time( &zones, zones.now + 60 );
+		clock_gettime( CLOCK_MONOTONIC, &start );
+		if( !tz_contact_store_create( &store, contacts ) || !tz_organize_data( &store, &map, &zones, true, NULL ) )
+		{
+			fprintf( stderr, "Out of memory.\n" );
+			return -1;
+		}
+		t = elapsed( &start );
+		store_first = repetition == 0 || t < store_first ? t : store_first;
+
+		lc_tree_map_clear( &map );
+		tz_zone_cache_set_time( &zones, zones.now + 60 );
+		clock_gettime( CLOCK_MONOTONIC, &start );
+		tz_organize_data( &store, &map, &zones, true, NULL );
+		t = elapsed( &start );
+		store_regroup = repetition == 0 || t < store_regroup ? t : store_regroup;
+
+		tz_contact_store_destroy( &store );
+		lc_tree_map_destroy( &map );
+	}
+
+	printf( "%ld contacts, best of %d:\n", count, repetitions );
+	printf( "  %-8s  %12s  %12s\n", "layout", "first (ms)", "regroup (ms)" );
+	printf( "  %-8s  %12.3f  %12.3f\n", "structs", structs_first, structs_regroup );
+	printf( "  %-8s  %12.3f  %12.3f\n", "store", store_first, store_regroup );
+
+	lc_vector_destroy( contacts );
+	tz_arena_destroy( &strings );
+	tz_zone_cache_destroy( &zones );
+	return 0;
+}
+
+/*
+ * Grouping as it was done on the contact structs: a lookup in the map
+ * for every contact and a qsort() of pointers to them with wcscmp().
+ */
+void organize_structs( const timezone_contact_t* contacts, lc_tree_map_t* map, tz_zone_cache_t* zones )
+{
+	for( size_t i = 0; i < lc_vector_size(contacts); i++ )
+	{
+		const timezone_contact_t* contact = &contacts[ i ];
+		const tz_zone_t* zone = tz_zone_cache_resolve( zones, contact->zone );
+		intptr_t group_key = tz_zone_seconds_of_day( zone );
+
+		lc_tree_map_iterator_t itr = lc_tree_map_find( map, (void*) group_key );
+
+		if( itr != lc_tree_map_end() )
+		{
+			timezone_contact_t const ** list = itr->value;
+			lc_vector_push( list, contact );
+			itr->value = list;
+		}
+		else
+		{
+			timezone_contact_t const ** list = NULL;
+			lc_vector_create( list, 1 );
+			lc_vector_push( list, contact );
+			lc_tree_map_insert( map, (void*) group_key, list );
+		}
+	}
+
+	for( lc_tree_map_iterator_t itr = lc_tree_map_begin( map );
+	     itr != lc_tree_map_end( );
+	     itr = lc_tree_map_next(itr) )
+	{
+		timezone_contact_t** list = itr->value;
+		qsort( list, lc_vector_size(list), sizeof(timezone_contact_t*), name_compare );
+	}
+}
+
+bool map_element_destroy( void *p_key, void *p_value )
+{
+	timezone_contact_t** list = p_value;
+
+	if( list )
+	{
+		while( lc_vector_size(list) > 0 )
+		{
+			lc_vector_pop( list );
+		}
+
+		lc_vector_destroy( list );
+	}
+
+	return true;
+}
+
+int map_compare( const void *p_key_left, const void *p_key_right )
+{
+	intptr_t l = (intptr_t) p_key_left;
+	intptr_t r = (intptr_t) p_key_right;
+	return (l > r) - (l < r);
+}
+
+int name_compare( const void *l, const void *r )
+{
+	const timezone_contact_t** left = (const timezone_contact_t**) l;
+	const timezone_contact_t** right = (const timezone_contact_t**) r;
+	return wcscmp( (*left)->name, (*right)->name );
+}
+
+double elapsed( const struct timespec* start )
+{
+	struct timespec end;
+	clock_gettime( CLOCK_MONOTONIC, &end );
+	return (end.tv_sec - start->tv_sec) * 1000.0 + (end.tv_nsec - start->tv_nsec) / 1e6;
+}
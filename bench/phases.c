@@ -0,0 +1,325 @@
+/*
+ * Copyright (C) 2019-2025, Joe Marrero. http://www.joemarrero.com/
+ * Copyright (C) 2017, End Point Corporation. http://www.endpoint.com/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+/*
+ * Times each phase of a timezoner run over a configuration and prints the
+ * best of a few repetitions as JSON:
+ *
+ *   phases <configuration> [repetitions]
+ *
+ * The phases are the ones main() goes through: reading the configuration,
+ * grouping with tz_organize_data() by time and by UTC offset, each of the
+ * four display functions and the teardown. Frames are written to
+ * /dev/null, so terminal speed doesn't count.
+ */
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <string.h>
+#include <wchar.h>
+#include <locale.h>
+#include <time.h>
+#include <collections/tree-map.h>
+#include "../src/timezoner.h"
+#include "../src/arena.h"
+#include "../src/config.h"
+#include "../src/display.h"
+#include "../src/render.h"
+#include "../src/store.h"
+#include "../src/zone.h"
+
+typedef enum phase {
+	PHASE_READ = 0,
+	PHASE_ORGANIZE_TIME,
+	PHASE_DISPLAY_TIME,
+	PHASE_DISPLAY_TIME_MINIMAL,
+	PHASE_ORGANIZE_UTC,
+	PHASE_DISPLAY_UTC,
+	PHASE_DISPLAY_UTC_MINIMAL,
+	PHASE_TEARDOWN,
+	PHASE_COUNT
+} phase_t;
+
+static const char* PHASE_NAMES[ PHASE_COUNT ] = {
+	"read", "organize_time", "display_time", "display_time_minimal",
+	"organize_utc", "display_utc", "display_utc_minimal", "teardown"
+};
+
+typedef struct run {
+	double milliseconds[ PHASE_COUNT ];
+	size_t bytes[ PHASE_COUNT ];   /* configuration bytes read, or bytes rendered */
+	size_t contacts;
+	size_t zones;
+	size_t groups_by_time;
+	size_t groups_by_utc;
+} run_t;
+
+static bool   run                 ( const char* configuration_name, time_t now, FILE* sink, run_t* result );
+static void   display             ( phase_t phase, lc_tree_map_t* map, tz_zone_cache_t* zones, FILE* sink, run_t* result );
+static double lap                 ( struct timespec* start );
+static void   json_string         ( const char* s );
+
+
+int main( int argc, char* argv[] )
+{
+	if( argc < 2 )
+	{
+		fprintf( stderr, "Usage: %s <configuration> [repetitions]\n", argv[0] );
+		return -1;
+	}
+
+	const char* configuration_name = argv[1];
+	int repetitions = argc > 2 ? atoi( argv[2] ) : 3;
+	time_t now = time(NULL); // every repetition draws the same instant
+	FILE* sink = fopen( "/dev/null", "w" );
+	run_t best;
+
+	setlocale( LC_ALL, "" );
+
+	if( !sink )
+	{
+		fprintf( stderr, "Unable to open /dev/null.\n" );
+		return -1;
+	}
+
+	for( int repetition = 0; repetition < (repetitions > 0 ? repetitions : 1); repetition++ )
+	{
+		run_t result = { .contacts = 0 };
+
+		if( !run( configuration_name, now, sink, &result ) )
+		{
+			fclose( sink );
+			return -1;
+		}
+
+		if( repetition == 0 )
+		{
+			best = result;
+		}
+
+		for( int phase = 0; phase < PHASE_COUNT; phase++ )
+		{
+			if( result.milliseconds[ phase ] < best.milliseconds[ phase ] )
+			{
+				best.milliseconds[ phase ] = result.milliseconds[ phase ];
+			}
+		}
+	}
+
+	fclose( sink );
+
+	double total = 0.0;
+
+	printf( "{\"configuration\": " );
+	json_string( configuration_name );
+	printf( ", \"contacts\": %zu, \"zones\": %zu, \"groups_by_time\": %zu, \"groups_by_utc\": %zu, \"repetitions\": %d,\n",
+	        best.contacts, best.zones, best.groups_by_time, best.groups_by_utc, repetitions );
+	printf( " \"phases\": {" );
+
+	for( int phase = 0; phase < PHASE_COUNT; phase++ )
+	{
+		printf( "%s\n  \"%s\": {\"ms\": %.3f, \"bytes\": %zu}", phase > 0 ? "," : "",
+		        PHASE_NAMES[ phase ], best.milliseconds[ phase ], best.bytes[ phase ] );
+		total += best.milliseconds[ phase ];
+	}
+
+	printf( "\n },\n \"total_ms\": %.3f}\n", total );
+	return 0;
+}
+
+/*
+ * One run from reading the configuration to tearing it all down.
+ */
+bool run( const char* configuration_name, time_t now, FILE* sink, run_t* result )
+{
+	tz_zone_cache_t zones;
+	tz_arena_t strings;
+	tz_load_stats_t load_stats = { 0 };
+	tz_contact_store_t store;
+	lc_tree_map_t map;
+	timezone_contact_t* contacts = NULL;
+	struct timespec start;
+
+	// Long UTF-8 names don't fit the streaming parser's lines.
+	tz_app_t app = (tz_app_t) {
+		.organize_by_time = true,
+		.memory_map       = true,
+		.parser           = TZ_PARSER_FAST,
+		.jobs             = 1,
+		.working_hours    = { 9 * 60, 17 * 60 },
+		.column_widths    = { 30, 25 },
+		.now              = now,
+		.zones            = &zones,
+		.strings          = &strings,
+		.load_stats       = &load_stats
+	};
+
+	clock_gettime( CLOCK_MONOTONIC, &start );
+
+	tz_zone_cache_create( &zones, now );
+	tz_arena_create( &strings, TZ_ARENA_BLOCK_SIZE );
+	tz_organize_map_create( &map );
+	lc_vector_create( contacts, 1 );
+
+	if( !contacts || !tz_configuration_load( &app, &configuration_name, 1, &contacts ) )
+	{
+		fprintf( stderr, "Unable to read '%s'.\n", configuration_name );
+		return false;
+	}
+
+	result->milliseconds[ PHASE_READ ] = lap( &start );
+	result->bytes[ PHASE_READ ] = load_stats.bytes;
+	result->contacts = lc_vector_size( contacts );
+	result->zones = tz_zone_cache_size( &zones );
+
+	if( !tz_contact_store_create( &store, contacts ) || !tz_organize_data( &store, &map, &zones, true, NULL ) )
+	{
+		fprintf( stderr, "Out of memory.\n" );
+		return false;
+	}
+
+	result->milliseconds[ PHASE_ORGANIZE_TIME ] = lap( &start );
+	result->groups_by_time = lc_tree_map_size( &map );
+
+	display( PHASE_DISPLAY_TIME, &map, &zones, sink, result );
+	display( PHASE_DISPLAY_TIME_MINIMAL, &map, &zones, sink, result );
+
+	lap( &start );
+	lc_tree_map_clear( &map );
+
+	if( !tz_organize_data( &store, &map, &zones, false, NULL ) )
+	{
+		fprintf( stderr, "Out of memory.\n" );
+		return false;
+	}
+
+	result->milliseconds[ PHASE_ORGANIZE_UTC ] = lap( &start );
+	result->groups_by_utc = lc_tree_map_size( &map );
+
+	display( PHASE_DISPLAY_UTC, &map, &zones, sink, result );
+	display( PHASE_DISPLAY_UTC_MINIMAL, &map, &zones, sink, result );
+
+	lap( &start );
+	lc_tree_map_destroy( &map );
+	tz_contact_store_destroy( &store );
+	lc_vector_destroy( contacts );
+	tz_arena_destroy( &strings );
+	tz_zone_cache_destroy( &zones );
+	result->milliseconds[ PHASE_TEARDOWN ] = lap( &start );
+
+	return true;
+}
+
+void display( phase_t phase, lc_tree_map_t* map, tz_zone_cache_t* zones, FILE* sink, run_t* result )
+{
+	struct timespec start;
+	tz_render_t render;
+
+	clock_gettime( CLOCK_MONOTONIC, &start );
+
+	if( !tz_render_create( &render, sink, 4 * 1024 * 1024 ) )
+	{
+		return;
+	}
+
+	switch( phase )
+	{
+		case PHASE_DISPLAY_TIME:
+			tz_display_time_grouping( &render, map, zones, 30, 25 );
+			break;
+		case PHASE_DISPLAY_TIME_MINIMAL:
+			tz_display_time_grouping_minimal( &render, map, zones, 30, 25 );
+			break;
+		case PHASE_DISPLAY_UTC:
+			tz_display_utc_grouping( &render, map, zones );
+			break;
+		default:
+			tz_display_utc_grouping_minimal( &render, map, zones );
+			break;
+	}
+
+	tz_render_flush( &render );
+	result->bytes[ phase ] = render.bytes_written;
+	tz_render_destroy( &render );
+
+	result->milliseconds[ phase ] = lap( &start );
+}
+
+/*
+ * Milliseconds since start, which is then reset to now.
+ */
+double lap( struct timespec* start )
+{
+	struct timespec end;
+	clock_gettime( CLOCK_MONOTONIC, &end );
+
+	double milliseconds = (end.tv_sec - start->tv_sec) * 1000.0 + (end.tv_nsec - start->tv_nsec) / 1e6;
+	*start = end;
+	return milliseconds;
+}
+
+void json_string( const char* s )
+{
+	putchar( '"' );
+
+	for( ; *s; s++ )
+	{
+		if( *s == '"' || *s == '\\' )
+		{
+			putchar( '\\' );
+		}
+
+		if( (unsigned char) *s < 0x20 )
+		{
+			printf( "\\u%04x", (unsigned char) *s );
+		}
+		else
+		{
+			putchar( *s );
+		}
+	}
+
+	putchar( '"' );
+}
+
+/*
+ * The configuration reader reports errors through these, which live in
+ * main.c in timezoner itself.
+ */
+void tz_print_error( const tz_app_t* app, const char* format, ... )
+{
+	va_list args;
+	va_start( args, format );
+	vfprintf( stderr, format, args );
+	va_end( args );
+}
+
+bool tz_check_alloc( const tz_app_t* app, void* mem )
+{
+	if( !mem )
+	{
+		fprintf( stderr, "Out of memory.\n" );
+	}
+
+	return mem != NULL;
+}
@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2019-2025, Joe Marrero. http://www.joemarrero.com/
+ * Copyright (C) 2017, End Point Corporation. http://www.endpoint.com/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <stdlib.h>
+#include <wchar.h>
+#include <xtd/string.h>
+#include "arena.h"
+
+#define ARENA_ALIGNMENT        (sizeof(void*))
+#define ARENA_ALIGN(size)      (((size) + ARENA_ALIGNMENT - 1) & ~(ARENA_ALIGNMENT - 1))
+
+
+void tz_arena_create( tz_arena_t* arena, size_t block_size )
+{
+	*arena = (tz_arena_t) {
+		.blocks      = NULL,
+		.block_size  = block_size > 0 ? block_size : TZ_ARENA_BLOCK_SIZE,
+		.allocations = 0,
+		.bytes       = 0
+	};
+}
+
+void tz_arena_destroy( tz_arena_t* arena )
+{
+	tz_arena_block_t* block = arena->blocks;
+
+	while( block )
+	{
+		tz_arena_block_t* next = block->next;
+		free( block );
+		block = next;
+	}
+
+	arena->blocks = NULL;
+}
+
+void* tz_arena_alloc( tz_arena_t* arena, size_t size )
+{
+	tz_arena_block_t* block = arena->blocks;
+	size = ARENA_ALIGN( size );
+
+	if( !block || block->used + size > block->size )
+	{
+		// Oversized requests get a block of their own.
+		size_t block_size = size > arena->block_size ? size : arena->block_size;
+
+		block = malloc( sizeof(tz_arena_block_t) + block_size );
+		if( !block )
+		{
+			return NULL;
+		}
+
+		block->size = block_size;
+		block->used = 0;
+
+		if( arena->blocks && size > arena->block_size )
+		{
+			// Keep filling the current block.
+			block->next = arena->blocks->next;
+			arena->blocks->next = block;
+		}
+		else
+		{
+			block->next = arena->blocks;
+			arena->blocks = block;
+		}
+
+		arena->allocations += 1;
+	}
+
+	void* mem = block->data + block->used;
+	block->used  += size;
+	arena->bytes += size;
+
+	return mem;
+}
+
+/*
+ * Moves every block of another arena into this one, leaving the other
+ * arena empty. Memory from either arena stays valid.
+ */
+void tz_arena_merge( tz_arena_t* arena, tz_arena_t* other )
+{
+	tz_arena_block_t* last = other->blocks;
+
+	if( !last )
+	{
+		return;
+	}
+
+	while( last->next )
+	{
+		last = last->next;
+	}
+
+	if( arena->blocks )
+	{
+		// Keep filling the current block.
+		last->next = arena->blocks->next;
+		arena->blocks->next = other->blocks;
+	}
+	else
+	{
+		arena->blocks = other->blocks;
+	}
+
+	arena->allocations += other->allocations;
+	arena->bytes       += other->bytes;
+
+	other->blocks      = NULL;
+	other->allocations = 0;
+	other->bytes       = 0;
+}
+
+/*
+ * Widens a multibyte string into the arena.
+ */
+wchar_t* tz_arena_mbstowcs( tz_arena_t* arena, const char* s )
+{
+	size_t len = mb_strlen( s );
+	wchar_t* ws = tz_arena_alloc( arena, sizeof(wchar_t) * (len + 1) );
+
+	if( ws )
+	{
+		mbstowcs( ws, s, len );
+		ws[ len ] = L'\0';
+	}
+
+	return ws;
+}
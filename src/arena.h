@@ -0,0 +1,55 @@
+/*
+ * Copyright (C) 2019-2025, Joe Marrero. http://www.joemarrero.com/
+ * Copyright (C) 2017, End Point Corporation. http://www.endpoint.com/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef _TZ_ARENA_H_
+#define _TZ_ARENA_H_
+
+#include <stddef.h>
+
+#define TZ_ARENA_BLOCK_SIZE    (64 * 1024)
+
+typedef struct tz_arena_block {
+	struct tz_arena_block* next;
+	size_t size;
+	size_t used;
+	unsigned char data[];
+} tz_arena_block_t;
+
+/*
+ * A bump allocator for data that lives as long as the contacts. Memory
+ * is handed out from large blocks and everything is released at once
+ * with tz_arena_destroy().
+ */
+typedef struct tz_arena {
+	tz_arena_block_t* blocks;
+	size_t block_size;
+	size_t allocations; /* number of blocks malloc'd */
+	size_t bytes;       /* number of bytes handed out */
+} tz_arena_t;
+
+void     tz_arena_create  ( tz_arena_t* arena, size_t block_size );
+void     tz_arena_destroy ( tz_arena_t* arena );
+void*    tz_arena_alloc   ( tz_arena_t* arena, size_t size );
+void     tz_arena_merge   ( tz_arena_t* arena, tz_arena_t* other );
+wchar_t* tz_arena_mbstowcs( tz_arena_t* arena, const char* s );
+
+#endif /* _TZ_ARENA_H_ */
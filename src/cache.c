@@ -0,0 +1,482 @@
+/*
+ * Copyright (C) 2019-2025, Joe Marrero. http://www.joemarrero.com/
+ * Copyright (C) 2017, End Point Corporation. http://www.endpoint.com/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <wchar.h>
+#include <limits.h>
+#include "timezoner.h"
+#include "cache.h"
+#if defined(_WIN32) || defined(_WIN64)
+# include <windows.h>
+#else
+# include <unistd.h>
+# include <fcntl.h>
+# include <langinfo.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+#endif
+
+#define CACHE_ALIGN(size)    (((size) + 7) & ~(size_t) 7)
+
+#if defined(_WIN32) || defined(_WIN64)
+bool tz_cache_load( const tz_app_t* app, const char* configuration_name, timezone_contact_t** contacts )
+{
+	return false;
+}
+
+bool tz_cache_save( const tz_app_t* app, const char* configuration_name, const timezone_contact_t* contacts, size_t count )
+{
+	return false;
+}
+
+void tz_cache_close( tz_cache_t* cache )
+{
+}
+#else
+typedef struct cache_pool {
+	unsigned char* data;
+	size_t size;
+	size_t capacity;
+} cache_pool_t;
+
+static bool     cache_filename ( const char* configuration_name, char* filename, size_t size );
+static void     cache_codeset  ( char* codeset, size_t size );
+static uint64_t cache_pool_add ( cache_pool_t* pool, const void* data, size_t size );
+static bool     cache_index_map ( const tz_cache_header_t* header, const unsigned char* data, size_t size, tz_contact_index_t* index );
+
+
+/*
+ * Loads contacts from the configuration's compiled cache, if there is
+ * one and it is still fresh. Their strings point into the mapping,
+ * which is kept in app->cache.
+ */
+bool tz_cache_load( const tz_app_t* app, const char* configuration_name, timezone_contact_t** contacts )
+{
+	tz_cache_t* cache = app->cache;
+	char filename[ PATH_MAX ];
+	struct stat source;
+	struct stat st;
+	bool result = false;
+
+	cache->hit = false;
+
+	if( cache->data || !cache_filename( configuration_name, filename, sizeof(filename) ) ||
+	    stat( configuration_name, &source ) != 0 )
+	{
+		return false;
+	}
+
+	int fd = open( filename, O_RDONLY );
+	if( fd < 0 )
+	{
+		return false;
+	}
+
+	if( fstat( fd, &st ) != 0 || st.st_size < (off_t) sizeof(tz_cache_header_t) )
+	{
+		close( fd );
+		return false;
+	}
+
+	size_t size = st.st_size;
+	unsigned char* data = mmap( NULL, size, PROT_READ, MAP_PRIVATE, fd, 0 );
+	close( fd );
+
+	if( data == MAP_FAILED )
+	{
+		return false;
+	}
+
+	const tz_cache_header_t* header = (const tz_cache_header_t*) data;
+	char codeset[ sizeof(header->codeset) ];
+	cache_codeset( codeset, sizeof(codeset) );
+
+	if( memcmp( header->magic, TZ_CACHE_MAGIC, sizeof(TZ_CACHE_MAGIC) ) != 0 ||
+	    header->version != TZ_CACHE_VERSION ||
+	    header->wchar_size != sizeof(wchar_t) ||
+	    header->source_size != (uint64_t) source.st_size ||
+	    header->source_mtime != (int64_t) source.st_mtim.tv_sec ||
+	    header->source_mtime_nsec != (int64_t) source.st_mtim.tv_nsec ||
+	    header->source_inode != (uint64_t) source.st_ino ||
+	    strncmp( header->codeset, codeset, sizeof(codeset) ) != 0 )
+	{
+		// Stale; it gets rebuilt after the configuration is parsed.
+		goto done;
+	}
+
+	if( header->zones_offset > size || header->zone_count > (size - header->zones_offset) / sizeof(uint64_t) ||
+	    header->records_offset > size || header->contact_count > (size - header->records_offset) / sizeof(tz_cache_record_t) ||
+	    header->pool_offset > size || header->pool_size > size - header->pool_offset ||
+	    header->pool_size < sizeof(wchar_t) || header->pool_offset % sizeof(wchar_t) != 0 )
+	{
+		goto done;
+	}
+
+	const unsigned char* pool = data + header->pool_offset;
+	const uint64_t* names     = (const uint64_t*) (data + header->zones_offset);
+	const tz_cache_record_t* records = (const tz_cache_record_t*) (data + header->records_offset);
+
+	// Every string ends before the pool does.
+	if( *(const wchar_t*) (pool + header->pool_size - sizeof(wchar_t)) != L'\0' )
+	{
+		goto done;
+	}
+
+	tz_zone_id_t* remap = malloc( sizeof(tz_zone_id_t) * (header->zone_count + 1) );
+	if( !remap )
+	{
+		goto done;
+	}
+
+	for( uint64_t i = 0; i < header->zone_count; i++ )
+	{
+		remap[ i ] = names[ i ] < header->pool_size ? tz_zone_cache_intern( app->zones, (const char*) pool + names[ i ] ) : TZ_ZONE_ID_INVALID;
+
+		if( remap[ i ] == TZ_ZONE_ID_INVALID )
+		{
+			free( remap );
+			goto done;
+		}
+	}
+
+	size_t contact_count = lc_vector_size( *contacts );
+
+	for( uint64_t i = 0; i < header->contact_count; i++ )
+	{
+		const tz_cache_record_t* record = &records[ i ];
+
+		if( record->zone >= header->zone_count ||
+		    record->email >= header->pool_size || record->email % sizeof(wchar_t) != 0 ||
+		    record->name >= header->pool_size || record->name % sizeof(wchar_t) != 0 ||
+		    record->office_phone >= header->pool_size || record->office_phone % sizeof(wchar_t) != 0 ||
+		    record->mobile_phone >= header->pool_size || record->mobile_phone % sizeof(wchar_t) != 0 )
+		{
+			// Corrupt; drop what was loaded and parse the text instead.
+			while( lc_vector_size(*contacts) > contact_count )
+			{
+				lc_vector_pop( *contacts );
+			}
+			free( remap );
+			goto done;
+		}
+
+		timezone_contact_t contact = (timezone_contact_t) {
+			.zone          = remap[ record->zone ],
+			.email         = (const wchar_t*) (pool + record->email),
+			.name          = (const wchar_t*) (pool + record->name),
+			.office_phone  = (const wchar_t*) (pool + record->office_phone),
+			.mobile_phone  = (const wchar_t*) (pool + record->mobile_phone),
+			.working_hours = { record->working_hours[ 0 ], record->working_hours[ 1 ] },
+			.email_width        = record->email_width,
+			.name_width         = record->name_width,
+			.office_phone_width = record->office_phone_width,
+			.mobile_phone_width = record->mobile_phone_width
+		};
+		lc_vector_push( *contacts, contact );
+	}
+
+	free( remap );
+
+	if( app->load_stats )
+	{
+		app->load_stats->bytes += size;
+		app->load_stats->cached = true;
+	}
+
+	// The postings are by row, so they only help when this cache is all that was loaded.
+	if( contact_count > 0 || !cache_index_map( header, data, size, &cache->index ) )
+	{
+		memset( &cache->index, 0, sizeof(cache->index) );
+	}
+
+	cache->data = data;
+	cache->size = size;
+	cache->hit  = true;
+	result = true;
+
+done:
+	if( !result )
+	{
+		munmap( data, size );
+	}
+
+	return result;
+}
+
+/*
+ * Compiles contacts just parsed from a configuration into its cache. The
+ * cache is written to a temporary file and renamed into place, so
+ * concurrent readers never see a partial one.
+ */
+bool tz_cache_save( const tz_app_t* app, const char* configuration_name, const timezone_contact_t* contacts, size_t count )
+{
+	bool result = false;
+	char filename[ PATH_MAX ];
+	char temporary[ PATH_MAX + 32 ];
+	struct stat source;
+	size_t zone_total = tz_zone_cache_size( app->zones );
+	uint64_t* names = NULL;
+	uint32_t* zones = NULL;          /* app zone ID -> index in the cache */
+	tz_cache_record_t* records = NULL;
+	cache_pool_t pool = { NULL, 0, 0 };
+	uint64_t zone_count = 0;
+	tz_contact_index_t index = { { NULL, NULL }, { NULL, NULL }, 0, false };
+	FILE* file = NULL;
+
+	if( !cache_filename( configuration_name, filename, sizeof(filename) ) ||
+	    stat( configuration_name, &source ) != 0 )
+	{
+		return false;
+	}
+
+	snprintf( temporary, sizeof(temporary), "%s.%ld", filename, (long) getpid() );
+
+	names   = malloc( sizeof(uint64_t) * (zone_total + 1) );
+	zones   = malloc( sizeof(uint32_t) * (zone_total + 1) );
+	records = calloc( count + 1, sizeof(tz_cache_record_t) );
+
+	if( !names || !zones || !records || !tz_contact_index_create( &index, contacts, count ) )
+	{
+		goto done;
+	}
+
+	for( size_t i = 0; i < zone_total; i++ )
+	{
+		zones[ i ] = UINT32_MAX;
+	}
+
+	for( size_t i = 0; i < count; i++ )
+	{
+		const timezone_contact_t* contact = &contacts[ i ];
+		tz_cache_record_t* record = &records[ i ];
+
+		if( zones[ contact->zone ] == UINT32_MAX )
+		{
+			const char* name = app->zones->zones[ contact->zone ].name;
+			names[ zone_count ] = cache_pool_add( &pool, name, strlen(name) + 1 );
+			zones[ contact->zone ] = (uint32_t) zone_count++;
+		}
+
+		record->zone             = zones[ contact->zone ];
+		record->working_hours[0] = contact->working_hours[ 0 ];
+		record->working_hours[1] = contact->working_hours[ 1 ];
+		record->email_width        = contact->email_width;
+		record->name_width         = contact->name_width;
+		record->office_phone_width = contact->office_phone_width;
+		record->mobile_phone_width = contact->mobile_phone_width;
+		record->email            = cache_pool_add( &pool, contact->email, sizeof(wchar_t) * (wcslen(contact->email) + 1) );
+		record->name             = cache_pool_add( &pool, contact->name, sizeof(wchar_t) * (wcslen(contact->name) + 1) );
+		record->office_phone     = cache_pool_add( &pool, contact->office_phone, sizeof(wchar_t) * (wcslen(contact->office_phone) + 1) );
+		record->mobile_phone     = cache_pool_add( &pool, contact->mobile_phone, sizeof(wchar_t) * (wcslen(contact->mobile_phone) + 1) );
+	}
+
+	// The pool always ends with a terminator.
+	cache_pool_add( &pool, L"", sizeof(wchar_t) );
+
+	if( !pool.data )
+	{
+		goto done;
+	}
+
+	tz_cache_header_t header;
+	memset( &header, 0, sizeof(header) );
+	memcpy( header.magic, TZ_CACHE_MAGIC, sizeof(TZ_CACHE_MAGIC) );
+	header.version        = TZ_CACHE_VERSION;
+	header.wchar_size     = sizeof(wchar_t);
+	header.source_size    = source.st_size;
+	header.source_mtime   = source.st_mtim.tv_sec;
+	header.source_mtime_nsec = source.st_mtim.tv_nsec;
+	header.source_inode   = source.st_ino;
+	cache_codeset( header.codeset, sizeof(header.codeset) );
+	header.zone_count     = zone_count;
+	header.contact_count  = count;
+	header.zones_offset   = CACHE_ALIGN( sizeof(header) );
+	header.records_offset = CACHE_ALIGN( header.zones_offset + sizeof(uint64_t) * zone_count );
+	header.pool_offset    = CACHE_ALIGN( header.records_offset + sizeof(tz_cache_record_t) * count );
+	header.pool_size      = pool.size;
+	header.index_offset   = CACHE_ALIGN( header.pool_offset + pool.size );
+	header.name_postings  = index.names.starts[ TZ_QUERY_BUCKETS ];
+	header.email_postings = index.emails.starts[ TZ_QUERY_BUCKETS ];
+
+	file = fopen( temporary, "wb" );
+	if( !file )
+	{
+		goto done;
+	}
+
+	static const unsigned char padding[ 8 ] = { 0 };
+	size_t zones_size   = sizeof(uint64_t) * zone_count;
+	size_t records_size = sizeof(tz_cache_record_t) * count;
+	size_t starts_size  = sizeof(uint32_t) * (TZ_QUERY_BUCKETS + 1);
+
+	result = fwrite( &header, sizeof(header), 1, file ) == 1 &&
+	         fwrite( padding, 1, header.zones_offset - sizeof(header), file ) == header.zones_offset - sizeof(header) &&
+	         fwrite( names, 1, zones_size, file ) == zones_size &&
+	         fwrite( padding, 1, header.records_offset - header.zones_offset - zones_size, file ) == header.records_offset - header.zones_offset - zones_size &&
+	         fwrite( records, 1, records_size, file ) == records_size &&
+	         fwrite( padding, 1, header.pool_offset - header.records_offset - records_size, file ) == header.pool_offset - header.records_offset - records_size &&
+	         fwrite( pool.data, 1, pool.size, file ) == pool.size &&
+	         fwrite( padding, 1, header.index_offset - header.pool_offset - pool.size, file ) == header.index_offset - header.pool_offset - pool.size &&
+	         fwrite( index.names.starts, 1, starts_size, file ) == starts_size &&
+	         fwrite( index.names.rows, sizeof(uint32_t), header.name_postings, file ) == header.name_postings &&
+	         fwrite( index.emails.starts, 1, starts_size, file ) == starts_size &&
+	         fwrite( index.emails.rows, sizeof(uint32_t), header.email_postings, file ) == header.email_postings;
+
+	if( fclose( file ) != 0 )
+	{
+		result = false;
+	}
+
+	if( result )
+	{
+		result = rename( temporary, filename ) == 0;
+	}
+
+	if( !result )
+	{
+		unlink( temporary );
+	}
+
+done:
+	tz_contact_index_destroy( &index );
+	free( pool.data );
+	free( records );
+	free( zones );
+	free( names );
+	return result;
+}
+
+void tz_cache_close( tz_cache_t* cache )
+{
+	if( cache->data )
+	{
+		munmap( cache->data, cache->size );
+		cache->data = NULL;
+		cache->size = 0;
+		memset( &cache->index, 0, sizeof(cache->index) );
+	}
+
+	if( cache->next )
+	{
+		tz_cache_close( cache->next );
+		free( cache->next );
+		cache->next = NULL;
+	}
+}
+
+/*
+ * Points an index at the postings in the mapping, after checking that
+ * they fit in it and that each table of bucket starts is in order.
+ */
+bool cache_index_map( const tz_cache_header_t* header, const unsigned char* data, size_t size, tz_contact_index_t* index )
+{
+	uint64_t starts_size = sizeof(uint32_t) * (TZ_QUERY_BUCKETS + 1);
+
+	if( header->index_offset == 0 || header->index_offset > size || header->index_offset % sizeof(uint32_t) != 0 ||
+	    header->name_postings > UINT32_MAX || header->email_postings > UINT32_MAX ||
+	    2 * starts_size + sizeof(uint32_t) * (header->name_postings + header->email_postings) > size - header->index_offset )
+	{
+		return false;
+	}
+
+	const uint32_t* p = (const uint32_t*) (data + header->index_offset);
+	tz_trigram_index_t names  = { (uint32_t*) p, (uint32_t*) (p + TZ_QUERY_BUCKETS + 1) };
+	p += TZ_QUERY_BUCKETS + 1 + header->name_postings;
+	tz_trigram_index_t emails = { (uint32_t*) p, (uint32_t*) (p + TZ_QUERY_BUCKETS + 1) };
+
+	if( names.starts[ TZ_QUERY_BUCKETS ] != header->name_postings ||
+	    emails.starts[ TZ_QUERY_BUCKETS ] != header->email_postings )
+	{
+		return false;
+	}
+
+	for( uint32_t bucket = 0; bucket < TZ_QUERY_BUCKETS; bucket++ )
+	{
+		if( names.starts[ bucket ] > names.starts[ bucket + 1 ] || emails.starts[ bucket ] > emails.starts[ bucket + 1 ] )
+		{
+			return false;
+		}
+	}
+
+	*index = (tz_contact_index_t) {
+		.names  = names,
+		.emails = emails,
+		.count  = header->contact_count,
+		.mapped = true
+	};
+	return true;
+}
+
+bool cache_filename( const char* configuration_name, char* filename, size_t size )
+{
+	return snprintf( filename, size, "%s%s", configuration_name, TZ_CACHE_SUFFIX ) < (int) size;
+}
+
+void cache_codeset( char* codeset, size_t size )
+{
+	memset( codeset, 0, size );
+	strncpy( codeset, nl_langinfo( CODESET ), size - 1 );
+}
+
+/*
+ * Appends to the pool and returns the offset. Entries are aligned for
+ * wide strings. Sets data to NULL when out of memory.
+ */
+uint64_t cache_pool_add( cache_pool_t* pool, const void* data, size_t size )
+{
+	size_t offset = (pool->size + sizeof(wchar_t) - 1) / sizeof(wchar_t) * sizeof(wchar_t);
+
+	if( pool->capacity == (size_t) -1 )
+	{
+		return 0;
+	}
+
+	if( offset + size > pool->capacity )
+	{
+		size_t capacity = pool->capacity > 0 ? pool->capacity * 2 : 64 * 1024;
+		while( capacity < offset + size )
+		{
+			capacity *= 2;
+		}
+
+		unsigned char* grown = realloc( pool->data, capacity );
+		if( !grown )
+		{
+			free( pool->data );
+			pool->data     = NULL;
+			pool->capacity = (size_t) -1;
+			return 0;
+		}
+
+		pool->data     = grown;
+		pool->capacity = capacity;
+	}
+
+	memset( pool->data + pool->size, 0, offset - pool->size );
+	memcpy( pool->data + offset, data, size );
+	pool->size = offset + size;
+
+	return offset;
+}
+#endif
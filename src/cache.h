@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2019-2025, Joe Marrero. http://www.joemarrero.com/
+ * Copyright (C) 2017, End Point Corporation. http://www.endpoint.com/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef _TZ_CACHE_H_
+#define _TZ_CACHE_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "query.h"
+
+#define TZ_CACHE_SUFFIX    ".bin"
+#define TZ_CACHE_MAGIC     "TZCACHE"
+#define TZ_CACHE_VERSION   (4)
+
+struct tz_app;
+struct timezone_contact;
+
+/*
+ * A compiled configuration: the contacts of a text configuration in a
+ * flat layout that is used straight from a read-only mapping.
+ *
+ *   header | zone name offsets | fixed-size records | string pool | index
+ *
+ * Names are narrow and contact fields are wide strings in the pool.
+ * Records carry the display widths of the fields, which depend on the
+ * locale just like the widening does.
+ * The index holds the trigram postings of the names and emails, so
+ * that --where doesn't have to build them on every run.
+ * The cache is stale when the configuration's size, inode or modification
+ * time (to the nanosecond) differs, or when it was built for another
+ * locale encoding.
+ */
+typedef struct tz_cache_header {
+	char magic[ 8 ];
+	uint32_t version;
+	uint32_t wchar_size;
+	uint64_t source_size;
+	int64_t source_mtime;
+	int64_t source_mtime_nsec;
+	uint64_t source_inode;
+	char codeset[ 32 ];        /* encoding the strings were widened with */
+	uint64_t zone_count;
+	uint64_t contact_count;
+	uint64_t zones_offset;
+	uint64_t records_offset;
+	uint64_t pool_offset;
+	uint64_t pool_size;
+	uint64_t index_offset;     /* 0 when there is no index */
+	uint64_t name_postings;
+	uint64_t email_postings;
+} tz_cache_header_t;
+
+typedef struct tz_cache_record {
+	uint32_t zone;             /* index into the zone name offsets */
+	int16_t working_hours[ 2 ];
+	uint16_t email_width;      /* terminal columns, so they aren't measured again */
+	uint16_t name_width;
+	uint16_t office_phone_width;
+	uint16_t mobile_phone_width;
+	uint64_t email;            /* byte offsets into the pool */
+	uint64_t name;
+	uint64_t office_phone;
+	uint64_t mobile_phone;
+} tz_cache_record_t;
+
+/*
+ * The mapping that loaded contacts point into. It has to outlive them.
+ * Each file of a merged configuration has its own, chained to the first.
+ */
+typedef struct tz_cache {
+	void* data;
+	size_t size;
+	bool hit;                  /* the last load came from the cache */
+	tz_contact_index_t index;  /* points into the mapping; empty without one */
+	struct tz_cache* next;     /* allocated; closed with this one */
+} tz_cache_t;
+
+bool tz_cache_load  ( const struct tz_app* app, const char* configuration_name, struct timezone_contact** contacts );
+bool tz_cache_save  ( const struct tz_app* app, const char* configuration_name, const struct timezone_contact* contacts, size_t count );
+void tz_cache_close ( tz_cache_t* cache );
+
+#endif /* _TZ_CACHE_H_ */
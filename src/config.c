@@ -0,0 +1,1671 @@
+/*
+ * Copyright (C) 2019-2025, Joe Marrero. http://www.joemarrero.com/
+ * Copyright (C) 2017, End Point Corporation. http://www.endpoint.com/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <ctype.h>
+#include <wchar.h>
+#include <wctype.h>
+#include <time.h>
+#include <limits.h>
+#include <regex.h>
+#include <xtd/filesystem.h>
+#include <xtd/string.h>
+#include "timezoner.h"
+#include "config.h"
+#include "cache.h"
+#include "slot.h"
+#include "text.h"
+#if defined(_WIN32) || defined(_WIN64)
+# include <windows.h>
+#else
+# include <unistd.h>
+# include <fcntl.h>
+# include <pwd.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <glob.h>
+# include <pthread.h>
+#endif
+
+static bool tz_configuration_compile       ( const tz_app_t* app, regex_t* regex );
+static bool tz_configuration_read_stream   ( const tz_app_t* app, const char* configuration_name, regex_t* regex, timezone_contact_t** contacts );
+static bool tz_configuration_read_mapped   ( const tz_app_t* app, const char* configuration_name, regex_t* regex, timezone_contact_t** contacts );
+static bool tz_configuration_read_parallel ( const tz_app_t* app, const char* configuration_name, timezone_contact_t** contacts );
+static bool tz_configuration_read_lines    ( const tz_app_t* app, char* data, size_t size, int line_number, regex_t* regex, timezone_contact_t** contacts );
+static bool tz_configuration_read_line     ( const tz_app_t* app, char* line, int line_number, regex_t* regex, timezone_contact_t** contacts );
+static bool tz_configuration_scan_line     ( const char* line, regmatch_t* matches );
+static bool tz_configuration_write_default ( const char* configuration_filename );
+static bool tz_configuration_read_merged   ( const tz_app_t* app, const char** names, size_t count, tz_include_t* includes, timezone_contact_t** contacts );
+static bool config_source_add              ( const tz_app_t* app, const char* path, size_t length );
+
+
+/*
+ * Writes the name of the configuration in the user's home directory.
+ */
+void tz_configuration_home_name( char* filename, size_t size )
+{
+	struct passwd *pw = getpwuid(getuid());
+	const char *homedir = pw->pw_dir;
+
+	snprintf( filename, size, "%s/%s", homedir, CONFIGURATION_FILENAME );
+	filename[ size - 1 ] = '\0';
+}
+
+bool tz_read_configuration_from_home( const tz_app_t* app, timezone_contact_t** contacts )
+{
+	bool result = true;
+	char configuration_filename[ PATH_MAX ];
+	tz_configuration_home_name( configuration_filename, sizeof(configuration_filename) );
+
+	if( file_exists( configuration_filename ) )
+	{
+		const char* names[ 1 ] = { configuration_filename };
+
+		if( !tz_configuration_load( app, names, 1, contacts ) )
+		{
+			tz_print_error( app, "Unable to read configuration at '%s'\n", configuration_filename );
+			result = false;
+			goto done;
+		}
+	}
+	else
+	{
+		if( !tz_configuration_write_default( configuration_filename ) )
+		{
+			tz_print_error( app, "Failed to create '%s'.\n", configuration_filename );
+			result = false;
+			goto done;
+		}
+
+		result = tz_read_configuration_from_home( app, contacts );
+	}
+
+done:
+	return result;
+}
+
+/*
+ * Reads one or more configurations and everything they include. A single
+ * file without include lines is read just like tz_configuration_read().
+ * Otherwise the files are merged: included files take the place of their
+ * include line, and a contact overrides any earlier one with the same
+ * email.
+ */
+bool tz_configuration_load( const tz_app_t* app, const char** names, size_t count, timezone_contact_t** contacts )
+{
+	bool result = false;
+	tz_include_t* includes = NULL;
+	lc_vector_create( includes, 4 );
+
+	if( !tz_check_alloc( app, includes ) )
+	{
+		return false;
+	}
+
+	for( size_t i = 0; i < count; i++ )
+	{
+		if( !config_source_add( app, names[ i ], strlen( names[ i ] ) ) )
+		{
+			goto done;
+		}
+	}
+
+	if( count == 1 )
+	{
+		tz_app_t top = *app;
+		top.includes = &includes;
+
+		result = tz_configuration_read( &top, names[ 0 ], contacts );
+
+		if( !result || lc_vector_size(includes) == 0 )
+		{
+			goto done;
+		}
+	}
+
+	result = tz_configuration_read_merged( app, names, count, includes, contacts );
+
+done:
+	lc_vector_destroy( includes );
+	return result;
+}
+
+/*
+ * Adds a file or directory to app->sources, once, so that whoever loaded
+ * the configuration knows what to watch.
+ */
+bool config_source_add( const tz_app_t* app, const char* path, size_t length )
+{
+	if( !app->sources )
+	{
+		return true;
+	}
+
+	for( size_t i = 0; i < lc_vector_size(*app->sources); i++ )
+	{
+		if( strncmp( (*app->sources)[ i ], path, length ) == 0 && (*app->sources)[ i ][ length ] == '\0' )
+		{
+			return true;
+		}
+	}
+
+	char* source = malloc( length + 1 );
+
+	if( !tz_check_alloc( app, source ) )
+	{
+		return false;
+	}
+
+	memcpy( source, path, length );
+	source[ length ] = '\0';
+	lc_vector_push( *app->sources, source );
+	return true;
+}
+
+bool tz_configuration_read( const tz_app_t* app, const char* configuration_name, timezone_contact_t** contacts )
+{
+	bool result = false;
+	regex_t regex;
+	regex_t* line_regex = NULL;
+	size_t contact_count = lc_vector_size( *contacts );
+	size_t include_count = app->includes ? lc_vector_size( *app->includes ) : 0;
+	struct timespec start;
+
+	clock_gettime( CLOCK_MONOTONIC, &start );
+
+	if( app->cache && tz_cache_load( app, configuration_name, contacts ) )
+	{
+		result = true;
+		goto done;
+	}
+
+	if( app->parser == TZ_PARSER_REGEX && app->jobs <= 1 )
+	{
+		if( !tz_configuration_compile( app, &regex ) )
+		{
+			return false;
+		}
+
+		line_regex = &regex;
+	}
+
+	if( app->jobs > 1 )
+	{
+		// Each thread compiles its own regular expression.
+		result = tz_configuration_read_parallel( app, configuration_name, contacts );
+	}
+	else if( app->memory_map )
+	{
+		result = tz_configuration_read_mapped( app, configuration_name, line_regex, contacts );
+	}
+	else
+	{
+		result = tz_configuration_read_stream( app, configuration_name, line_regex, contacts );
+	}
+
+	if( line_regex )
+	{
+		regfree( line_regex );
+	}
+
+	// The cache only holds contacts, so files that include others are
+	// always parsed.
+	if( result && app->cache && (!app->includes || lc_vector_size(*app->includes) == include_count) )
+	{
+		// A cache that can't be written is only slower next time.
+		tz_cache_save( app, configuration_name, *contacts + contact_count, lc_vector_size(*contacts) - contact_count );
+	}
+
+done:
+	if( app->load_stats )
+	{
+		struct timespec end;
+		clock_gettime( CLOCK_MONOTONIC, &end );
+
+		app->load_stats->contacts += lc_vector_size( *contacts ) - contact_count;
+		app->load_stats->seconds  += (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+	}
+
+	return result;
+}
+
+bool tz_configuration_compile( const tz_app_t* app, regex_t* regex )
+{
+#ifdef __APPLE__
+	const char* CONFIG_LINE_REGEX = "([[:alpha:]]+/?[[:alnum:]_]+)" /* group 1: timezone code */
+	                                "[[:space:]]+"
+                                        "\"(.*)\"" /* group 2: email */
+	                                "[[:space:]]+"
+	                                "\"(.*)\"" /* group 3: name */
+	                                "[[:space:]]+"
+	                                "\"(.*)\"" /* group 4: office number */
+	                                "[[:space:]]+"
+	                                "\"(.*)\"" /* group 5: mobile number */
+	                                "([[:space:]]+([0-9]{1,2}:[0-9]{2}-[0-9]{1,2}:[0-9]{2}))?"; /* group 7: working hours */
+#else // Linux and MinGW
+	const char* CONFIG_LINE_REGEX = "([[:alpha:]]+?/?[[:alnum:]_]+)" /* group 1: timezone code */
+	                                "[[:space:]]+"
+	                                "\"(.*)\"" /* group 2: email */
+	                                "[[:space:]]+"
+	                                "\"(.*)\"" /* group 3: name */
+	                                "[[:space:]]+"
+	                                "\"(.*)\"" /* group 4: office number */
+	                                "[[:space:]]+"
+	                                "\"(.*)\"" /* group 5: mobile number */
+	                                "([[:space:]]+([0-9]{1,2}:[0-9]{2}-[0-9]{1,2}:[0-9]{2}))?"; /* group 7: working hours */
+#endif
+	int regex_comp_result = regcomp( regex, CONFIG_LINE_REGEX, REG_EXTENDED | REG_ICASE);
+
+	if( regex_comp_result )
+	{
+		char error[256];
+		regerror(regex_comp_result, regex, error, sizeof(error));
+		tz_print_error( app, "Unable to compile regular expression.\nProblem: %s\n", error );
+		return false;
+	}
+
+	return true;
+}
+
+bool tz_configuration_read_stream( const tz_app_t* app, const char* configuration_name, regex_t* regex, timezone_contact_t** contacts )
+{
+	bool result = false;
+	FILE* config = fopen( configuration_name, "r" );
+
+	if( config )
+	{
+		char line[ 256 ];
+		int line_number = 1;
+
+		while( !feof(config) )
+		{
+			if( fgets( line, sizeof(line), config ) )
+			{
+				if( strchr(line, '\n') == NULL )
+				{
+					// Check for lines longer than we can support.
+					tz_print_error( app, "Line exceeds maximum possible length of %zu.\n", sizeof(line) );
+
+					result = false;
+					goto cleanup;
+				}
+
+				if( app->load_stats )
+				{
+					app->load_stats->bytes += strlen( line );
+					app->load_stats->lines += 1;
+				}
+
+				string_trim( line, " \t\r\n" );
+
+				if( !tz_configuration_read_line(app, line, line_number, regex, contacts ) )
+				{
+					result = false;
+					goto cleanup;
+				}
+
+				line_number += 1;
+			} // if line
+		} // while !eof
+
+		result = true;
+
+		cleanup: {
+			fclose( config );
+		} // cleanup
+	}// if config
+
+	return result;
+}
+
+#if defined(_WIN32) || defined(_WIN64)
+bool tz_configuration_read_mapped( const tz_app_t* app, const char* configuration_name, regex_t* regex, timezone_contact_t** contacts )
+{
+	tz_print_error( app, "Memory mapped configuration is not supported on this platform.\n" );
+	return false;
+}
+
+bool tz_configuration_read_parallel( const tz_app_t* app, const char* configuration_name, timezone_contact_t** contacts )
+{
+	tz_print_error( app, "Parallel parsing is not supported on this platform.\n" );
+	return false;
+}
+
+bool tz_configuration_read_merged( const tz_app_t* app, const char** names, size_t count, tz_include_t* includes, timezone_contact_t** contacts )
+{
+	tz_print_error( app, "Merging configurations is not supported on this platform.\n" );
+	return false;
+}
+#else
+/*
+ * A newline-aligned part of the configuration parsed on its own thread.
+ * The thread gets its own copy of the app with private zone names,
+ * strings and errors, which are merged in line order afterwards.
+ */
+typedef struct config_chunk {
+	tz_app_t app;
+	char* data;
+	size_t size;
+	int line_number;            /* global number of the chunk's first line */
+	tz_zone_cache_t zones;      /* names only; IDs are remapped when merging */
+	tz_arena_t strings;
+	timezone_contact_t* contacts;
+	tz_include_t* includes;     /* positions are within the chunk */
+	char* errors;
+	size_t errors_length;
+	bool result;
+	pthread_t thread;
+} config_chunk_t;
+
+static bool  config_map         ( const tz_app_t* app, const char* configuration_name, char** data, size_t* size );
+static void* config_chunk_parse ( void* chunk );
+
+typedef struct config_link {
+	size_t position;            /* contacts read before the include line */
+	size_t file;                /* index of the included file */
+} config_link_t;
+
+/*
+ * A file of a merged configuration. Like a chunk, it's parsed on its own
+ * thread with a private copy of the app, then merged in textual order.
+ */
+typedef struct config_file {
+	tz_app_t app;
+	char* name;                 /* real path */
+	tz_zone_cache_t zones;      /* names only; IDs are remapped when merging */
+	tz_arena_t strings;
+	tz_cache_t* cache;          /* NULL unless caching */
+	tz_load_stats_t stats;
+	tz_include_t* includes;
+	config_link_t* links;       /* included files, in the order of the include lines */
+	timezone_contact_t* contacts;
+	char* errors;
+	size_t errors_length;
+	bool shared;                /* read by the caller with the app's own zones and strings */
+	bool result;
+	bool merged;
+} config_file_t;
+
+typedef struct config_email_slot {
+	uint32_t hash;
+	uint32_t row;               /* contact index + 1; 0 is empty */
+} config_email_slot_t;
+
+typedef struct config_queue {
+	config_file_t** files;
+	size_t next;
+	size_t end;
+	pthread_mutex_t lock;
+} config_queue_t;
+
+static config_file_t* config_file_create  ( const tz_app_t* app, char* name );
+static void           config_file_destroy ( const tz_app_t* app, config_file_t* file );
+static bool           config_file_find    ( const tz_app_t* app, config_file_t*** files, const char* path, size_t* index );
+static bool           config_file_expand  ( const tz_app_t* app, config_file_t*** files, size_t parent, const tz_include_t* include );
+static void           config_files_parse  ( const tz_app_t* app, config_file_t** files, size_t first, size_t end );
+static void*          config_file_parse   ( void* queue );
+static bool           config_file_merge   ( const tz_app_t* app, config_file_t** files, size_t index, timezone_contact_t** contacts );
+static bool           config_deduplicate  ( const tz_app_t* app, timezone_contact_t* contacts, size_t* removed );
+
+/*
+ * Maps the whole configuration into memory and parses each line in place.
+ * The mapping is private, so terminating lines doesn't touch the file.
+ * There's no limit on the length of a line.
+ */
+bool tz_configuration_read_mapped( const tz_app_t* app, const char* configuration_name, regex_t* regex, timezone_contact_t** contacts )
+{
+	char* data = NULL;
+	size_t size = 0;
+	bool result = config_map( app, configuration_name, &data, &size );
+
+	if( result )
+	{
+		result = tz_configuration_read_lines( app, data, size, 1, regex, contacts );
+
+		if( app->load_stats )
+		{
+			app->load_stats->bytes += size;
+		}
+
+		if( data )
+		{
+			munmap( data, size );
+		}
+	}
+
+	return result;
+}
+
+/*
+ * Splits the mapped configuration into newline-aligned chunks that are
+ * parsed on app->jobs threads. Line numbers are counted up front so that
+ * errors name the right line, and only the first error in the file is
+ * reported, just like the sequential parser would.
+ */
+bool tz_configuration_read_parallel( const tz_app_t* app, const char* configuration_name, timezone_contact_t** contacts )
+{
+	char* data = NULL;
+	size_t size = 0;
+	bool result = config_map( app, configuration_name, &data, &size );
+
+	if( !result || size == 0 )
+	{
+		return result;
+	}
+
+	size_t jobs = size / TZ_CONFIGURATION_MIN_CHUNK + 1;
+	if( jobs > (size_t) app->jobs )
+	{
+		jobs = app->jobs;
+	}
+
+	config_chunk_t* chunks = calloc( jobs, sizeof(config_chunk_t) );
+	size_t chunk_count = 0;
+	size_t offset = 0;
+	int line_number = 1;
+	bool unterminated = data[ size - 1 ] != '\n';
+
+	if( !tz_check_alloc( app, chunks ) )
+	{
+		munmap( data, size );
+		return false;
+	}
+
+	while( offset < size && chunk_count < jobs )
+	{
+		config_chunk_t* chunk = &chunks[ chunk_count++ ];
+		size_t end = chunk_count == jobs ? size : size / jobs * chunk_count;
+
+		if( end < offset )
+		{
+			end = offset;
+		}
+
+		if( end < size )
+		{
+			char* newline = memchr( data + end, '\n', size - end );
+			end = newline ? (size_t) (newline - data) + 1 : size;
+		}
+
+		chunk->app         = *app;
+		chunk->data        = data + offset;
+		chunk->size        = end - offset;
+		chunk->line_number = line_number;
+
+		for( char* p = chunk->data; (p = memchr( p, '\n', chunk->data + chunk->size - p )) != NULL; p++ )
+		{
+			line_number += 1;
+		}
+
+		tz_zone_cache_create( &chunk->zones, app->now );
+		chunk->zones.load_zoneinfo = false;
+		tz_arena_create( &chunk->strings, app->strings ? app->strings->block_size : 0 );
+		lc_vector_create( chunk->contacts, chunk->size / 64 + 1 );
+		lc_vector_create( chunk->includes, 1 );
+
+		chunk->app.zones      = &chunk->zones;
+		chunk->app.includes   = app->includes ? &chunk->includes : NULL;
+		chunk->app.strings    = &chunk->strings;
+		chunk->app.load_stats = NULL;
+		chunk->app.errors     = open_memstream( &chunk->errors, &chunk->errors_length );
+		chunk->app.jobs       = 1;
+
+		offset = end;
+	}
+
+	for( size_t i = 0; i < chunk_count; i++ )
+	{
+		if( pthread_create( &chunks[ i ].thread, NULL, config_chunk_parse, &chunks[ i ] ) != 0 )
+		{
+			// Parse it on this thread instead.
+			config_chunk_parse( &chunks[ i ] );
+			chunks[ i ].thread = pthread_self( );
+		}
+	}
+
+	for( size_t i = 0; i < chunk_count; i++ )
+	{
+		if( !pthread_equal( chunks[ i ].thread, pthread_self( ) ) )
+		{
+			pthread_join( chunks[ i ].thread, NULL );
+		}
+	}
+
+	// Merge in line order, stopping at the first chunk that failed.
+	for( size_t i = 0; i < chunk_count; i++ )
+	{
+		config_chunk_t* chunk = &chunks[ i ];
+
+		if( chunk->app.errors )
+		{
+			fclose( chunk->app.errors );
+			chunk->app.errors = NULL;
+		}
+
+		if( result && !chunk->result )
+		{
+			fwrite( chunk->errors, 1, chunk->errors_length, app->errors ? app->errors : stderr );
+			result = false;
+		}
+
+		if( result )
+		{
+			size_t zone_count = tz_zone_cache_size( &chunk->zones );
+			tz_zone_id_t* remap = malloc( sizeof(tz_zone_id_t) * (zone_count + 1) );
+
+			for( size_t id = 0; remap && id < zone_count; id++ )
+			{
+				remap[ id ] = tz_zone_cache_intern( app->zones, chunk->zones.zones[ id ].name );
+
+				if( remap[ id ] == TZ_ZONE_ID_INVALID )
+				{
+					free( remap );
+					remap = NULL;
+				}
+			}
+
+			if( !tz_check_alloc( app, remap ) )
+			{
+				result = false;
+			}
+
+			for( size_t c = 0; result && app->includes && c < lc_vector_size(chunk->includes); c++ )
+			{
+				tz_include_t include = chunk->includes[ c ];
+				include.position += lc_vector_size( *contacts );
+				lc_vector_push( *app->includes, include );
+			}
+
+			for( size_t c = 0; result && c < lc_vector_size(chunk->contacts); c++ )
+			{
+				timezone_contact_t contact = chunk->contacts[ c ];
+				contact.zone = remap[ contact.zone ];
+				lc_vector_push( *contacts, contact );
+			}
+
+			free( remap );
+		}
+
+		// Strings belong to the app from now on, merged or not.
+		tz_arena_merge( app->strings, &chunk->strings );
+		lc_vector_destroy( chunk->contacts );
+		if( chunk->includes ) lc_vector_destroy( chunk->includes );
+		tz_zone_cache_destroy( &chunk->zones );
+		free( chunk->errors );
+	}
+
+	if( app->load_stats )
+	{
+		app->load_stats->bytes += size;
+		app->load_stats->lines += line_number - 1 + unterminated;
+	}
+
+	free( chunks );
+	munmap( data, size );
+	return result;
+}
+
+bool config_map( const tz_app_t* app, const char* configuration_name, char** data, size_t* size )
+{
+	bool result = false;
+	int fd = open( configuration_name, O_RDONLY );
+
+	*data = NULL;
+	*size = 0;
+
+	if( fd >= 0 )
+	{
+		struct stat st;
+
+		if( fstat( fd, &st ) == 0 )
+		{
+			*size = st.st_size;
+			result = true;
+		}
+
+		if( result && *size > 0 )
+		{
+			*data = mmap( NULL, *size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0 );
+
+			if( *data == MAP_FAILED )
+			{
+				tz_print_error( app, "Unable to map '%s' into memory.\n", configuration_name );
+				*data = NULL;
+				result = false;
+			}
+		}
+
+		close( fd ); // The mapping remains valid.
+	}
+
+	return result;
+}
+
+void* config_chunk_parse( void* p )
+{
+	config_chunk_t* chunk = p;
+	regex_t regex;
+	regex_t* line_regex = NULL;
+
+	chunk->result = chunk->contacts != NULL && chunk->includes != NULL;
+
+	if( chunk->result && chunk->app.parser == TZ_PARSER_REGEX )
+	{
+		// regexec() may serialize callers sharing a compiled expression.
+		chunk->result = tz_configuration_compile( &chunk->app, &regex );
+		line_regex = chunk->result ? &regex : NULL;
+	}
+
+	if( chunk->result )
+	{
+		chunk->result = tz_configuration_read_lines( &chunk->app, chunk->data, chunk->size, chunk->line_number, line_regex, &chunk->contacts );
+	}
+
+	if( line_regex )
+	{
+		regfree( line_regex );
+	}
+
+	return NULL;
+}
+
+/*
+ * Reads configurations along with everything they include. Each wave of
+ * newly found files is parsed concurrently, then the files are spliced
+ * into the files that include them in textual order. A file is read only
+ * once, however often it's included, so include cycles are harmless.
+ */
+bool tz_configuration_read_merged( const tz_app_t* app, const char** names, size_t count, tz_include_t* includes, timezone_contact_t** contacts )
+{
+	bool result = false;
+	config_file_t** files = NULL;
+	size_t top_count = 0;
+	size_t first = 0;
+	size_t removed = 0;
+	struct timespec start;
+
+	clock_gettime( CLOCK_MONOTONIC, &start );
+	lc_vector_create( files, count + 1 );
+
+	if( !tz_check_alloc( app, files ) )
+	{
+		return false;
+	}
+
+	if( lc_vector_size(includes) > 0 )
+	{
+		// The caller already read the only file; it just needs its includes.
+		timezone_contact_t* empty = NULL;
+		size_t index;
+
+		lc_vector_create( empty, lc_vector_size(*contacts) + 1 );
+
+		if( !tz_check_alloc( app, empty ) || !config_file_find( app, &files, names[ 0 ], &index ) )
+		{
+			if( empty ) lc_vector_destroy( empty );
+			goto done;
+		}
+
+		config_file_t* file = files[ index ];
+		lc_vector_destroy( file->contacts );
+		file->contacts = *contacts;
+		file->shared   = true;
+		file->result   = true;
+		*contacts = empty;
+
+		for( size_t i = 0; i < lc_vector_size(includes); i++ )
+		{
+			lc_vector_push( file->includes, includes[ i ] );
+		}
+	}
+	else
+	{
+		for( size_t i = 0; i < count; i++ )
+		{
+			size_t index;
+
+			if( !config_file_find( app, &files, names[ i ], &index ) )
+			{
+				goto done;
+			}
+		}
+	}
+
+	top_count = lc_vector_size( files );
+
+	while( first < lc_vector_size(files) )
+	{
+		size_t end = lc_vector_size( files );
+		config_files_parse( app, files, first, end );
+
+		// Files are numbered in the order they're first included.
+		for( size_t i = first; i < end; i++ )
+		{
+			config_file_t* file = files[ i ];
+
+			if( !file->result )
+			{
+				if( file->errors_length > 0 )
+				{
+					fwrite( file->errors, 1, file->errors_length, app->errors ? app->errors : stderr );
+				}
+				tz_print_error( app, "Unable to read configuration at '%s'\n", file->name );
+				goto done;
+			}
+
+			for( size_t c = 0; c < lc_vector_size(file->includes); c++ )
+			{
+				if( !config_file_expand( app, &files, i, &file->includes[ c ] ) )
+				{
+					goto done;
+				}
+			}
+		}
+
+		first = end;
+	}
+
+	result = true;
+
+	for( size_t i = 0; result && i < top_count; i++ )
+	{
+		result = config_file_merge( app, files, i, contacts );
+	}
+
+	if( result )
+	{
+		result = config_deduplicate( app, *contacts, &removed );
+	}
+
+	if( result && app->load_stats )
+	{
+		struct timespec end;
+		bool cached = true;
+
+		for( size_t i = 0; i < lc_vector_size(files); i++ )
+		{
+			const config_file_t* file = files[ i ];
+
+			// The caller counted the file it read.
+			if( !file->shared )
+			{
+				app->load_stats->bytes    += file->stats.bytes;
+				app->load_stats->lines    += file->stats.lines;
+				app->load_stats->contacts += file->stats.contacts;
+			}
+
+			cached = cached && !file->shared && file->stats.cached;
+		}
+
+		clock_gettime( CLOCK_MONOTONIC, &end );
+
+		app->load_stats->contacts -= removed;
+		app->load_stats->cached    = cached;
+		app->load_stats->seconds  += (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+	}
+
+done:
+	for( size_t i = 0; i < lc_vector_size(files); i++ )
+	{
+		config_file_destroy( app, files[ i ] );
+	}
+
+	lc_vector_destroy( files );
+	return result;
+}
+
+config_file_t* config_file_create( const tz_app_t* app, char* name )
+{
+	config_file_t* file = calloc( 1, sizeof(config_file_t) );
+
+	if( !file )
+	{
+		free( name );
+		return NULL;
+	}
+
+	file->app  = *app;
+	file->name = name;
+
+	tz_zone_cache_create( &file->zones, app->now );
+	file->zones.load_zoneinfo = false;
+	tz_arena_create( &file->strings, app->strings ? app->strings->block_size : 0 );
+	lc_vector_create( file->includes, 1 );
+	lc_vector_create( file->links, 1 );
+	lc_vector_create( file->contacts, 16 );
+	file->cache = app->cache ? calloc( 1, sizeof(tz_cache_t) ) : NULL;
+
+	file->app.zones      = &file->zones;
+	file->app.strings    = &file->strings;
+	file->app.cache      = file->cache;
+	file->app.includes   = &file->includes;
+	file->app.load_stats = &file->stats;
+	file->app.errors     = NULL;
+
+	if( !file->zones.zones || !file->includes || !file->links || !file->contacts || (app->cache && !file->cache) )
+	{
+		config_file_destroy( app, file );
+		return NULL;
+	}
+
+	return file;
+}
+
+void config_file_destroy( const tz_app_t* app, config_file_t* file )
+{
+	if( file->app.errors )
+	{
+		fclose( file->app.errors );
+	}
+
+	// Strings belong to the app from now on, merged or not.
+	tz_arena_merge( app->strings, &file->strings );
+
+	if( file->cache && file->cache->data )
+	{
+		// Contacts loaded from the file's cache point into its mapping.
+		file->cache->next = app->cache->next;
+		app->cache->next  = file->cache;
+	}
+	else
+	{
+		free( file->cache );
+	}
+
+	if( file->contacts ) lc_vector_destroy( file->contacts );
+	if( file->includes ) lc_vector_destroy( file->includes );
+	if( file->links ) lc_vector_destroy( file->links );
+	tz_zone_cache_destroy( &file->zones );
+	free( file->errors );
+	free( file->name );
+	free( file );
+}
+
+/*
+ * Finds a file by its real path, adding it if it's new.
+ */
+bool config_file_find( const tz_app_t* app, config_file_t*** files, const char* path, size_t* index )
+{
+	char* name = realpath( path, NULL );
+
+	if( !name )
+	{
+		tz_print_error( app, "Unable to find '%s'.\n", path );
+		return false;
+	}
+
+	for( *index = 0; *index < lc_vector_size(*files); *index += 1 )
+	{
+		if( strcmp( (*files)[ *index ]->name, name ) == 0 )
+		{
+			free( name );
+			return true;
+		}
+	}
+
+	if( !config_source_add( app, name, strlen( name ) ) )
+	{
+		free( name );
+		return false;
+	}
+
+	config_file_t* file = config_file_create( app, name );
+
+	if( !tz_check_alloc( app, file ) )
+	{
+		return false;
+	}
+
+	lc_vector_push( *files, file );
+	return true;
+}
+
+/*
+ * Resolves an include line against the directory of the including file.
+ * A directory includes every file in it and a glob every file it matches,
+ * both in sorted order. Compiled caches are never included.
+ */
+bool config_file_expand( const tz_app_t* app, config_file_t*** files, size_t parent, const tz_include_t* include )
+{
+	const char* name = (*files)[ parent ]->name;
+	const char* slash = strrchr( name, '/' );
+	bool wildcard = strpbrk( include->pattern, "*?[" ) != NULL;
+	bool result = true;
+	char pattern[ PATH_MAX ];
+	struct stat st;
+	glob_t matches;
+	int length;
+
+	if( include->pattern[ 0 ] == '/' || !slash )
+	{
+		length = snprintf( pattern, sizeof(pattern), "%s", include->pattern );
+	}
+	else
+	{
+		length = snprintf( pattern, sizeof(pattern), "%.*s/%s", (int) (slash - name), name, include->pattern );
+	}
+
+	if( length >= 0 && (size_t) length + 2 < sizeof(pattern) && stat( pattern, &st ) == 0 && S_ISDIR( st.st_mode ) )
+	{
+		strcat( pattern, "/*" );
+		wildcard = true;
+	}
+	else if( length < 0 || (size_t) length >= sizeof(pattern) )
+	{
+		tz_print_error( app, "Path to include is too long (see '%s').\n", name );
+		return false;
+	}
+
+	// Files added to a directory or matching a glob later on are seen
+	// through the directory, so long as it's not a glob itself.
+	const char* directory_end = strrchr( pattern, '/' );
+
+	if( wildcard && directory_end && strcspn( pattern, "*?[" ) > (size_t) (directory_end - pattern) &&
+	    !config_source_add( app, pattern, directory_end == pattern ? 1 : directory_end - pattern ) )
+	{
+		return false;
+	}
+
+	int found = glob( pattern, 0, NULL, &matches );
+
+	if( found == GLOB_NOMATCH )
+	{
+		// A glob may match nothing, but a file has to exist.
+		if( !wildcard )
+		{
+			tz_print_error( app, "Unable to find '%s' included from '%s'.\n", include->pattern, name );
+			config_source_add( app, pattern, strlen( pattern ) );
+			result = false;
+		}
+	}
+	else if( found != 0 )
+	{
+		tz_print_error( app, "Unable to expand '%s' included from '%s'.\n", include->pattern, name );
+		result = false;
+	}
+
+	for( size_t i = 0; found == 0 && result && i < matches.gl_pathc; i++ )
+	{
+		const char* path = matches.gl_pathv[ i ];
+		size_t index;
+
+		if( tz_configuration_is_cache( path ) || stat( path, &st ) != 0 || !S_ISREG( st.st_mode ) )
+		{
+			continue;
+		}
+
+		result = config_file_find( app, files, path, &index );
+
+		if( result )
+		{
+			config_link_t link = (config_link_t) {
+				.position = include->position,
+				.file     = index
+			};
+			lc_vector_push( (*files)[ parent ]->links, link );
+		}
+	}
+
+	globfree( &matches );
+	return result;
+}
+
+/*
+ * True for a compiled cache, or one still being written, next to a
+ * configuration.
+ */
+bool tz_configuration_is_cache( const char* path )
+{
+	const char* base = strrchr( path, '/' );
+	const size_t length = strlen( TZ_CACHE_SUFFIX );
+
+	for( const char* p = base ? base : path; (p = strstr( p, TZ_CACHE_SUFFIX )) != NULL; p += length )
+	{
+		if( p[ length ] == '\0' || p[ length ] == '.' )
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/*
+ * Parses files[first] to files[end - 1] on as many threads as there are
+ * processors (or jobs, if more were asked for). A lone file may still be
+ * split across app->jobs threads.
+ */
+void config_files_parse( const tz_app_t* app, config_file_t** files, size_t first, size_t end )
+{
+	config_queue_t queue = { .files = files, .next = first, .end = end };
+	pthread_t threads[ TZ_CONFIGURATION_MAX_JOBS ];
+	size_t thread_count = 0;
+	long online = sysconf( _SC_NPROCESSORS_ONLN );
+	size_t workers = online > 0 ? (size_t) online : 1;
+
+	if( app->jobs > 0 && (size_t) app->jobs > workers )
+	{
+		workers = app->jobs;
+	}
+
+	if( workers > end - first )
+	{
+		workers = end - first;
+	}
+
+	if( workers > TZ_CONFIGURATION_MAX_JOBS )
+	{
+		workers = TZ_CONFIGURATION_MAX_JOBS;
+	}
+
+	for( size_t i = first; i < end; i++ )
+	{
+		if( !files[ i ]->shared )
+		{
+			files[ i ]->app.errors = open_memstream( &files[ i ]->errors, &files[ i ]->errors_length );
+			files[ i ]->app.jobs   = end - first == 1 ? app->jobs : 1;
+		}
+	}
+
+	pthread_mutex_init( &queue.lock, NULL );
+
+	// This thread is one of the workers.
+	while( thread_count + 1 < workers && pthread_create( &threads[ thread_count ], NULL, config_file_parse, &queue ) == 0 )
+	{
+		thread_count += 1;
+	}
+
+	config_file_parse( &queue );
+
+	for( size_t i = 0; i < thread_count; i++ )
+	{
+		pthread_join( threads[ i ], NULL );
+	}
+
+	pthread_mutex_destroy( &queue.lock );
+
+	for( size_t i = first; i < end; i++ )
+	{
+		if( files[ i ]->app.errors )
+		{
+			fclose( files[ i ]->app.errors );
+			files[ i ]->app.errors = NULL;
+		}
+	}
+}
+
+void* config_file_parse( void* p )
+{
+	config_queue_t* queue = p;
+
+	for( ;; )
+	{
+		pthread_mutex_lock( &queue->lock );
+		size_t i = queue->next < queue->end ? queue->next++ : queue->end;
+		pthread_mutex_unlock( &queue->lock );
+
+		if( i >= queue->end )
+		{
+			break;
+		}
+
+		config_file_t* file = queue->files[ i ];
+
+		if( !file->shared )
+		{
+			file->result = tz_configuration_read( &file->app, file->name, &file->contacts );
+		}
+	}
+
+	return NULL;
+}
+
+/*
+ * Appends a file's contacts, with each included file in place of its
+ * include line. Zone IDs are remapped into the app's zones.
+ */
+bool config_file_merge( const tz_app_t* app, config_file_t** files, size_t index, timezone_contact_t** contacts )
+{
+	config_file_t* file = files[ index ];
+	size_t zone_count = file->shared ? 0 : tz_zone_cache_size( &file->zones );
+	size_t link_count = lc_vector_size( file->links );
+	size_t count = lc_vector_size( file->contacts );
+	size_t position = 0;
+	tz_zone_id_t* remap = NULL;
+	bool result = true;
+
+	if( file->merged )
+	{
+		return true;
+	}
+
+	file->merged = true;
+
+	if( !file->shared )
+	{
+		remap = malloc( sizeof(tz_zone_id_t) * (zone_count + 1) );
+
+		for( size_t id = 0; remap && id < zone_count; id++ )
+		{
+			remap[ id ] = tz_zone_cache_intern( app->zones, file->zones.zones[ id ].name );
+
+			if( remap[ id ] == TZ_ZONE_ID_INVALID )
+			{
+				free( remap );
+				remap = NULL;
+			}
+		}
+
+		if( !tz_check_alloc( app, remap ) )
+		{
+			return false;
+		}
+	}
+
+	for( size_t link = 0; result && link <= link_count; link++ )
+	{
+		size_t end = link < link_count ? file->links[ link ].position : count;
+
+		for( ; position < end; position++ )
+		{
+			timezone_contact_t contact = file->contacts[ position ];
+			contact.zone = remap ? remap[ contact.zone ] : contact.zone;
+			lc_vector_push( *contacts, contact );
+		}
+
+		if( link < link_count )
+		{
+			result = config_file_merge( app, files, file->links[ link ].file, contacts );
+		}
+	}
+
+	free( remap );
+	return result;
+}
+
+/*
+ * Drops every contact whose email appears again later, so the last file
+ * to mention someone wins. Emails are compared without case through an
+ * open addressing hash set; contacts without an email are all kept.
+ */
+bool config_deduplicate( const tz_app_t* app, timezone_contact_t* contacts, size_t* removed )
+{
+	size_t count = lc_vector_size( contacts );
+	size_t capacity = 16;
+	size_t kept = 0;
+
+	while( capacity < count * 2 )
+	{
+		capacity *= 2;
+	}
+
+	config_email_slot_t* slots = calloc( capacity, sizeof(config_email_slot_t) );
+	uint32_t* hashes = malloc( sizeof(uint32_t) * (count + 1) );
+	bool* dropped = calloc( count + 1, sizeof(bool) );
+
+	if( !tz_check_alloc( app, slots ) || !tz_check_alloc( app, hashes ) || !tz_check_alloc( app, dropped ) )
+	{
+		free( slots );
+		free( hashes );
+		free( dropped );
+		return false;
+	}
+
+	// Hashing everything first lets the probes below overlap their cache
+	// misses rather than wait on each hash.
+	for( size_t i = 0; i < count; i++ )
+	{
+		uint32_t hash = 2166136261u; /* FNV-1a */
+
+		for( const wchar_t* c = contacts[ i ].email; *c; c++ )
+		{
+			// Emails are nearly always ASCII.
+			wint_t lower = *c < 0x80 ? (wint_t) (*c >= L'A' && *c <= L'Z' ? *c + 32 : *c) : towlower( (wint_t) *c );
+			hash = (hash ^ (uint32_t) lower) * 16777619u;
+		}
+
+		hashes[ i ] = hash;
+	}
+
+	for( size_t i = count; i-- > 0; )
+	{
+		const wchar_t* email = contacts[ i ].email;
+		uint32_t hash = hashes[ i ];
+
+		if( *email == L'\0' )
+		{
+			continue;
+		}
+
+		size_t slot = hash & (capacity - 1);
+
+		while( slots[ slot ].row && (slots[ slot ].hash != hash || wcscasecmp( contacts[ slots[ slot ].row - 1 ].email, email ) != 0) )
+		{
+			slot = (slot + 1) & (capacity - 1);
+		}
+
+		if( slots[ slot ].row )
+		{
+			dropped[ i ] = true;
+		}
+		else
+		{
+			slots[ slot ] = (config_email_slot_t) { .hash = hash, .row = i + 1 };
+		}
+	}
+
+	for( size_t i = 0; i < count; i++ )
+	{
+		if( !dropped[ i ] )
+		{
+			contacts[ kept++ ] = contacts[ i ];
+		}
+	}
+
+	*removed = count - kept;
+
+	for( size_t i = kept; i < count; i++ )
+	{
+		lc_vector_pop( contacts );
+	}
+
+	free( slots );
+	free( hashes );
+	free( dropped );
+	return true;
+}
+#endif
+
+/*
+ * Parses lines in place; each one is terminated where its newline was.
+ */
+bool tz_configuration_read_lines( const tz_app_t* app, char* data, size_t size, int line_number, regex_t* regex, timezone_contact_t** contacts )
+{
+	bool result = true;
+	char* line = data;
+	char* end = data + size;
+	char* last_line = NULL;
+
+	while( result && line < end )
+	{
+		char* newline = memchr( line, '\n', end - line );
+		char* next_line;
+
+		if( newline )
+		{
+			*newline = '\0';
+			next_line = newline + 1;
+		}
+		else
+		{
+			// The last line isn't terminated and there may be no room
+			// left in the mapping to terminate it, so copy it out.
+			size_t length = end - line;
+			last_line = malloc( length + 1 );
+
+			if( !tz_check_alloc(app, last_line) )
+			{
+				result = false;
+				break;
+			}
+
+			memcpy( last_line, line, length );
+			last_line[ length ] = '\0';
+			line = last_line;
+			next_line = end;
+		}
+
+		if( app->load_stats )
+		{
+			app->load_stats->lines += 1;
+		}
+
+		string_trim( line, " \t\r\n" );
+
+		result = tz_configuration_read_line( app, line, line_number, regex, contacts );
+
+		line_number += 1;
+		line = next_line;
+	}
+
+	free( last_line );
+	return result;
+}
+
+bool tz_configuration_read_line( const tz_app_t* app, char* line, int line_number, regex_t* regex, timezone_contact_t** contacts )
+{
+	if( *line == '#' )
+	{
+		// skipping comments
+		goto line_read_success;
+	}
+	else if( *line == '\0' )
+	{
+		// skipping empty lines
+		goto line_read_success;
+	}
+	else if( strncmp( line, "include", 7 ) == 0 && (line[ 7 ] == '\0' || isspace( (unsigned char) line[ 7 ] )) )
+	{
+		// include PATH, or include "PATH"; loaded after this file is parsed
+		char* pattern = line + 7;
+		size_t length;
+
+		while( isspace( (unsigned char) *pattern ) )
+		{
+			pattern++;
+		}
+
+		length = strlen( pattern );
+		if( length >= 2 && pattern[ 0 ] == '"' && pattern[ length - 1 ] == '"' )
+		{
+			pattern += 1;
+			length  -= 2;
+		}
+
+		if( !app->includes )
+		{
+			tz_print_error( app, "Includes are not supported here (see line %d).\n", line_number );
+			goto line_read_failed;
+		}
+
+		if( length == 0 )
+		{
+			tz_print_error( app, "Missing path to include (see line %d).\n", line_number );
+			goto line_read_failed;
+		}
+
+		char* copy = tz_arena_alloc( app->strings, length + 1 );
+		if( !copy )
+		{
+			tz_print_error( app, "Out of memory.\n" );
+			goto line_read_failed;
+		}
+		memcpy( copy, pattern, length );
+		copy[ length ] = '\0';
+
+		tz_include_t include = (tz_include_t) {
+			.position = lc_vector_size( *contacts ),
+			.pattern  = copy
+		};
+		lc_vector_push( *app->includes, include );
+	}
+	else
+	{
+		const int max_groups = 8;
+		regmatch_t matches[ max_groups ];
+		int regex_result;
+
+		if( regex )
+		{
+			regex_result = regexec( regex, line, max_groups, matches, 0 );
+		}
+		else
+		{
+			regex_result = tz_configuration_scan_line( line, matches ) ? 0 : REG_NOMATCH;
+		}
+
+		if( !regex_result )
+		{
+			line[ matches[ 1 ].rm_eo ] = '\0';
+			tz_zone_id_t zone = tz_zone_cache_intern( app->zones, line + matches[ 1 ].rm_so );
+			if( zone == TZ_ZONE_ID_INVALID )
+			{
+				tz_print_error( app, "Out of memory.\n" );
+				goto line_read_failed;
+			}
+
+			line[ matches[ 2 ].rm_eo ] = '\0';
+			line[ matches[ 3 ].rm_eo ] = '\0';
+			line[ matches[ 4 ].rm_eo ] = '\0';
+			line[ matches[ 5 ].rm_eo ] = '\0';
+
+			timezone_contact_t contact = (timezone_contact_t) {
+				.zone          = zone,
+				.working_hours = { -1, -1 } /* the default */
+			};
+
+			// Contact strings live as long as the arena; their widths are measured on the way in.
+			contact.email        = tz_text_widen( app->strings, line + matches[ 2 ].rm_so, matches[ 2 ].rm_eo - matches[ 2 ].rm_so, &contact.email_width );
+			contact.name         = tz_text_widen( app->strings, line + matches[ 3 ].rm_so, matches[ 3 ].rm_eo - matches[ 3 ].rm_so, &contact.name_width );
+			contact.office_phone = tz_text_widen( app->strings, line + matches[ 4 ].rm_so, matches[ 4 ].rm_eo - matches[ 4 ].rm_so, &contact.office_phone_width );
+			contact.mobile_phone = tz_text_widen( app->strings, line + matches[ 5 ].rm_so, matches[ 5 ].rm_eo - matches[ 5 ].rm_so, &contact.mobile_phone_width );
+
+			if( !contact.email || !contact.name || !contact.office_phone || !contact.mobile_phone )
+			{
+				tz_print_error( app, "Out of memory.\n" );
+				goto line_read_failed;
+			}
+
+			if( matches[ 7 ].rm_so >= 0 )
+			{
+				line[ matches[ 7 ].rm_eo ] = '\0';
+
+				if( !tz_slot_parse_hours( line + matches[ 7 ].rm_so, contact.working_hours ) )
+				{
+					tz_print_error( app, "Invalid working hours '%s' (see line %d).\n", line + matches[ 7 ].rm_so, line_number );
+					goto line_read_failed;
+				}
+			}
+			lc_vector_push( *contacts, contact );
+		}
+		else if (regex_result == REG_NOMATCH)
+		{
+			// line did not match.
+			if( regex )
+			{
+				tz_print_error( app, "Unable to match line with regular expression (see line %d).\n", line_number );
+			}
+			else
+			{
+				tz_print_error( app, "Unable to match line with expected format (see line %d).\n", line_number );
+			}
+			goto line_read_failed;
+		}
+		else
+		{
+			tz_print_error( app, "Unable to execute regular expression.\n" );
+			goto line_read_failed;
+		}
+	}
+
+line_read_success:
+	return true;
+
+line_read_failed:
+	return false;
+}
+
+/*
+ * A scanner for a configuration line that fills in the same groups as
+ * CONFIG_LINE_REGEX, without the regex engine:
+ *
+ *   Timezone  "Email"  "Name"  "OfficePhone"  "MobilePhone"  [09:00-17:00]
+ *
+ * The quoted fields split the same way the greedy "(.*)" groups do, so
+ * quotes inside a field are fine. Unlike the regex, the timezone must
+ * start the line and may be any IANA name (America/Argentina/Salta,
+ * Etc/GMT+5), where the regex only matched two part names and so took
+ * a suffix or prefix of longer ones. Working hours are optional.
+ */
+bool tz_configuration_scan_line( const char* line, regmatch_t* matches )
+{
+	const char* p = line;
+
+	// group 1: timezone code
+	if( !isalpha( (unsigned char) *p ) )
+	{
+		return false;
+	}
+
+	while( isalnum( (unsigned char) *p ) || *p == '_' || *p == '/' || *p == '-' || *p == '+' )
+	{
+		p++;
+	}
+
+	matches[ 0 ].rm_so = 0;
+	matches[ 1 ].rm_so = 0;
+	matches[ 1 ].rm_eo = p - line;
+
+	// groups 2 to 5: email, name, office number, mobile number
+	const char* field_start = p;
+
+	while( isspace( (unsigned char) *p ) )
+	{
+		p++;
+	}
+
+	if( p == field_start || *p != '"' )
+	{
+		return false;
+	}
+
+	// Like the greedy "(.*)" groups, each field takes as much of the line
+	// as it can while leaving the fields after it a closing quote. So the
+	// fields are closed from the right: the last one at the last quote,
+	// and every other one at the last quote that is followed by white
+	// space and an opening quote before the next field's closing quote.
+	const char* starts[ 6 ];
+	const char* ends[ 6 ];
+
+	starts[ 2 ] = p + 1;
+	ends[ 5 ]   = strrchr( starts[ 2 ], '"' );
+
+	if( !ends[ 5 ] )
+	{
+		return false;
+	}
+
+	for( int group = 4; group >= 2; group-- )
+	{
+		ends[ group ] = NULL;
+
+		for( const char* quote = ends[ group + 1 ] - 1; quote >= starts[ 2 ] && !ends[ group ]; quote-- )
+		{
+			const char* next = quote + 1;
+
+			if( *quote != '"' || !isspace( (unsigned char) *next ) )
+			{
+				continue;
+			}
+
+			while( isspace( (unsigned char) *next ) )
+			{
+				next++;
+			}
+
+			if( *next == '"' && next < ends[ group + 1 ] )
+			{
+				ends[ group ]       = quote;
+				starts[ group + 1 ] = next + 1;
+			}
+		}
+
+		if( !ends[ group ] )
+		{
+			return false;
+		}
+	}
+
+	for( int group = 2; group <= 5; group++ )
+	{
+		matches[ group ].rm_so = starts[ group ] - line;
+		matches[ group ].rm_eo = ends[ group ] - line;
+	}
+	p = ends[ 5 ] + 1;
+
+	matches[ 6 ].rm_so = -1;
+	matches[ 6 ].rm_eo = -1;
+	matches[ 7 ].rm_so = -1;
+	matches[ 7 ].rm_eo = -1;
+
+	// groups 6 and 7: working hours (HH:MM-HH:MM)
+	const char* hours = p;
+
+	while( isspace( (unsigned char) *hours ) )
+	{
+		hours++;
+	}
+
+	if( hours != p && isdigit( (unsigned char) *hours ) )
+	{
+		const char* end = hours;
+		int digits = 0;
+
+		for( const char* pattern = "d:d-d:d"; *pattern && end; pattern++ )
+		{
+			if( *pattern == 'd' )
+			{
+				// one or two hour digits, then exactly two minute digits
+				int minimum = pattern[ 1 ] == ':' ? 1 : 2;
+				for( digits = 0; isdigit( (unsigned char) *end ) && digits < 2; digits++ )
+				{
+					end++;
+				}
+				end = digits >= minimum ? end : NULL;
+			}
+			else
+			{
+				end = *end == *pattern ? end + 1 : NULL;
+			}
+		}
+
+		if( end )
+		{
+			matches[ 6 ].rm_so = p - line;
+			matches[ 6 ].rm_eo = end - line;
+			matches[ 7 ].rm_so = hours - line;
+			matches[ 7 ].rm_eo = end - line;
+			p = end;
+		}
+	}
+
+	matches[ 0 ].rm_eo = p - line;
+
+	return true;
+}
+
+bool tz_configuration_write_default( const char* configuration_filename )
+{
+	bool result = false;
+	FILE* config = fopen( configuration_filename, "w" );
+
+	if( config )
+	{
+		fprintf( config, "# -------------------------------\n" );
+		fprintf( config, "# This is the configuration for the timezoner program. You can\n" );
+		fprintf( config, "# add new contacts here. A list of IANA timezones is available\n" );
+		fprintf( config, "# from here: https://en.wikipedia.org/wiki/List_of_tz_database_time_zones\n" );
+		fprintf( config, "#\n" );
+		fprintf( config, "# The format is:\n" );
+		fprintf( config, "#\n" );
+		fprintf( config, "# Timezone \t\tEmail \tName \tOfficePhone \tMobilePhone \t[WorkingHours]\n" );
+		fprintf( config, "America/New_York \t\"john.doe@example.com\" \"John Doe\" \"+1 305 555 1234\" \"+1 954 555 5678\"\n" );
+
+		fclose( config );
+		result = true;
+	}
+
+	return result;
+}
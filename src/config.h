@@ -0,0 +1,38 @@
+/*
+ * Copyright (C) 2019-2025, Joe Marrero. http://www.joemarrero.com/
+ * Copyright (C) 2017, End Point Corporation. http://www.endpoint.com/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef _TZ_CONFIG_H_
+#define _TZ_CONFIG_H_
+
+#include <stdbool.h>
+#include "timezoner.h"
+
+#define TZ_CONFIGURATION_MAX_JOBS      (256)
+#define TZ_CONFIGURATION_MIN_CHUNK     (64 * 1024)  /* smallest chunk worth a thread */
+
+void tz_configuration_home_name      ( char* filename, size_t size );
+bool tz_read_configuration_from_home ( const tz_app_t* app, timezone_contact_t** contacts );
+bool tz_configuration_load           ( const tz_app_t* app, const char** names, size_t count, timezone_contact_t** contacts );
+bool tz_configuration_read           ( const tz_app_t* app, const char* configuration_name, timezone_contact_t** contacts );
+bool tz_configuration_is_cache       ( const char* path );
+
+#endif /* _TZ_CONFIG_H_ */
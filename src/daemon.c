@@ -0,0 +1,854 @@
+/*
+ * Copyright (C) 2019-2025, Joe Marrero. http://www.joemarrero.com/
+ * Copyright (C) 2017, End Point Corporation. http://www.endpoint.com/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#if defined(__linux__)
+/* struct ucred, for SO_PEERCRED */
+# define _GNU_SOURCE
+#endif
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <limits.h>
+#include <time.h>
+#include <collections/tree-map.h>
+#include "timezoner.h"
+#include "daemon.h"
+#include "display.h"
+#include "format.h"
+#include "grid.h"
+#include "reload.h"
+#include "render.h"
+#include "store.h"
+#include "timeline.h"
+#if defined(_WIN32) || defined(_WIN64)
+# include <windows.h>
+#else
+# include <unistd.h>
+# include <signal.h>
+# include <pthread.h>
+# include <sys/socket.h>
+# include <sys/stat.h>
+# include <sys/time.h>
+# include <sys/un.h>
+#endif
+
+#define DAEMON_ANSWERED    '0'  /* the rendered output follows */
+#define DAEMON_FAILED      '1'  /* an error message follows */
+
+#if !defined(_WIN32) && !defined(_WIN64)
+typedef struct daemon {
+	tz_app_t app;                 /* defaults of every query */
+	tz_reloader_t reloader;
+	int listener;
+	bool stop;
+	pthread_mutex_t fallback_lock;
+} daemon_t;
+
+/*
+ * Grouping changes the zones and the store, so each worker has its
+ * own, rebuilt whenever the snapshot changes.
+ */
+typedef struct daemon_worker {
+	daemon_t* daemon;
+	pthread_t thread;
+	bool started;
+	tz_zone_cache_t zones;
+	tz_contact_store_t store;
+	lc_tree_map_t map;
+	unsigned int generation;      /* of the snapshot the zones and store were built from; 0 for none */
+} daemon_worker_t;
+
+static bool                      daemon_address          ( const tz_app_t* app, const char* socket_name, struct sockaddr_un* address );
+static bool                      daemon_directory        ( const tz_app_t* app, const char* socket_name, bool create );
+static bool                      daemon_peer             ( int fd );
+static int                       daemon_listen           ( const tz_app_t* app, const char* socket_name );
+static void*                     daemon_serve            ( void* argument );
+static void                      daemon_answer           ( daemon_worker_t* worker, int client );
+static bool                      daemon_prepare          ( daemon_worker_t* worker, const tz_snapshot_t* snapshot );
+static void                      daemon_worker_destroy   ( daemon_worker_t* worker );
+static bool                      daemon_parse            ( tz_app_t* app, tz_query_t* query, time_t* instants, int argc, char* argv[] );
+static bool                      daemon_read             ( int fd, char* buffer, size_t size, size_t* length );
+static bool                      daemon_write            ( int fd, const char* bytes, size_t size );
+
+
+/*
+ * The socket used when none is given: in XDG_RUNTIME_DIR if it is set,
+ * otherwise in a directory of the user's own under /tmp.
+ */
+void tz_daemon_socket_name( char* name, size_t size )
+{
+	const char* runtime = getenv( "XDG_RUNTIME_DIR" );
+
+	if( runtime && *runtime )
+	{
+		snprintf( name, size, "%s/timezoner.sock", runtime );
+	}
+	else
+	{
+		snprintf( name, size, "/tmp/timezoner-%u/timezoner.sock", (unsigned int) geteuid() );
+	}
+	name[ size - 1 ] = '\0';
+}
+
+/*
+ * Keeps the contacts and zones loaded and answers queries on a Unix
+ * socket until SIGINT or SIGTERM. Edits to the configuration are picked
+ * up as they are saved; SIGHUP rereads it regardless.
+ *
+ * A client writes its options as NUL terminated strings and shuts down
+ * its side of the connection. The answer is DAEMON_ANSWERED followed by
+ * the rendered output, or DAEMON_FAILED followed by the error.
+ */
+bool tz_daemon( const tz_app_t* app, const char* socket_name, const char** names, size_t count, int use_cache )
+{
+	bool result = false;
+	bool reloader_created = false;
+	daemon_worker_t workers[ TZ_DAEMON_WORKERS ];
+	daemon_t daemon;
+	sigset_t signals;
+
+	memset( workers, 0, sizeof(workers) );
+	memset( &daemon, 0, sizeof(daemon) );
+	daemon.app      = *app;
+	daemon.listener = -1;
+	pthread_mutex_init( &daemon.fallback_lock, NULL );
+
+	// Signals are only taken by this thread; the others never see them.
+	sigemptyset( &signals );
+	sigaddset( &signals, SIGINT );
+	sigaddset( &signals, SIGTERM );
+	sigaddset( &signals, SIGHUP );
+	pthread_sigmask( SIG_BLOCK, &signals, NULL );
+	signal( SIGPIPE, SIG_IGN );
+
+	reloader_created = tz_reloader_create( &daemon.reloader, app, names, count, use_cache, true );
+	if( !reloader_created )
+	{
+		goto done;
+	}
+
+	daemon.listener = daemon_listen( app, socket_name );
+	if( daemon.listener < 0 )
+	{
+		goto done;
+	}
+
+	for( size_t i = 0; i < TZ_DAEMON_WORKERS; i++ )
+	{
+		workers[ i ].daemon = &daemon;
+
+		if( !tz_organize_map_create( &workers[ i ].map ) )
+		{
+			tz_print_error( app, "Out of memory.\n" );
+			goto done;
+		}
+
+		workers[ i ].started = pthread_create( &workers[ i ].thread, NULL, daemon_serve, &workers[ i ] ) == 0;
+		if( !workers[ i ].started )
+		{
+			tz_print_error( app, "Unable to start a worker.\n" );
+			goto done;
+		}
+	}
+
+	tz_snapshot_t* snapshot = tz_snapshot_acquire( &daemon.reloader );
+	fprintf( stderr, "Serving %zu contacts on '%s' with %d workers.\n",
+	         lc_vector_size(snapshot->contacts), socket_name, TZ_DAEMON_WORKERS );
+	tz_snapshot_release( snapshot );
+
+	for( ;; )
+	{
+		int number = 0;
+
+		if( sigwait( &signals, &number ) != 0 || number != SIGHUP )
+		{
+			break;
+		}
+
+		tz_reloader_reload( &daemon.reloader, true );
+	}
+
+	result = true;
+
+done:
+	__atomic_store_n( &daemon.stop, true, __ATOMIC_RELAXED );
+
+	if( daemon.listener >= 0 )
+	{
+		// Wakes up the workers waiting in accept().
+		shutdown( daemon.listener, SHUT_RDWR );
+	}
+
+	for( size_t i = 0; i < TZ_DAEMON_WORKERS; i++ )
+	{
+		if( workers[ i ].started )
+		{
+			pthread_join( workers[ i ].thread, NULL );
+		}
+		daemon_worker_destroy( &workers[ i ] );
+	}
+
+	if( daemon.listener >= 0 )
+	{
+		close( daemon.listener );
+		unlink( socket_name );
+	}
+
+	if( reloader_created )
+	{
+		tz_reloader_destroy( &daemon.reloader );
+	}
+
+	pthread_mutex_destroy( &daemon.fallback_lock );
+	return result;
+}
+
+/*
+ * Sends the options to the daemon and writes its answer to stdout, or
+ * its error to stderr. Returns the exit status.
+ */
+int tz_daemon_query( const tz_app_t* app, const char* socket_name, int argc, char* argv[] )
+{
+	int result = -2;
+	int server = -1;
+	size_t length = 0;
+	struct sockaddr_un address;
+
+	for( int arg = 0; arg < argc; arg++ )
+	{
+		length += strlen( argv[ arg ] ) + 1;
+	}
+
+	if( length > TZ_DAEMON_REQUEST_MAX || argc > TZ_DAEMON_ARGUMENTS_MAX )
+	{
+		tz_print_error( app, "Too many options for the daemon.\n" );
+		goto done;
+	}
+
+	if( !daemon_address( app, socket_name, &address ) || !daemon_directory( app, socket_name, false ) )
+	{
+		goto done;
+	}
+
+	server = socket( AF_UNIX, SOCK_STREAM, 0 );
+	if( server < 0 || connect( server, (struct sockaddr*) &address, sizeof(address) ) != 0 )
+	{
+		tz_print_error( app, "No daemon is listening on '%s'\n", socket_name );
+		goto done;
+	}
+
+	if( !daemon_peer( server ) )
+	{
+		tz_print_error( app, "The daemon on '%s' runs as another user\n", socket_name );
+		goto done;
+	}
+
+	for( int arg = 0; arg < argc; arg++ )
+	{
+		if( !daemon_write( server, argv[ arg ], strlen( argv[ arg ] ) + 1 ) )
+		{
+			tz_print_error( app, "Unable to send the query to '%s'\n", socket_name );
+			goto done;
+		}
+	}
+	shutdown( server, SHUT_WR );
+
+	char buffer[ 64 * 1024 ];
+	FILE* stream = NULL;
+
+	for( ;; )
+	{
+		ssize_t count = read( server, buffer, sizeof(buffer) );
+
+		if( count < 0 && errno == EINTR )
+		{
+			continue;
+		}
+		if( count <= 0 )
+		{
+			break;
+		}
+
+		char* bytes = buffer;
+
+		if( !stream )
+		{
+			// The first byte says whether this is the output or an error.
+			stream = *bytes == DAEMON_ANSWERED ? stdout : stderr;
+			result = *bytes == DAEMON_ANSWERED ? 0 : -2;
+			bytes += 1;
+			count -= 1;
+		}
+
+		fwrite( bytes, 1, count, stream );
+	}
+
+	if( !stream )
+	{
+		tz_print_error( app, "The daemon on '%s' closed the connection.\n", socket_name );
+	}
+	fflush( stdout );
+
+done:
+	if( server >= 0 )
+	{
+		close( server );
+	}
+	return result;
+}
+
+bool daemon_address( const tz_app_t* app, const char* socket_name, struct sockaddr_un* address )
+{
+	memset( address, 0, sizeof(*address) );
+	address->sun_family = AF_UNIX;
+
+	if( strlen( socket_name ) >= sizeof(address->sun_path) )
+	{
+		tz_print_error( app, "Socket name '%s' is too long\n", socket_name );
+		return false;
+	}
+
+	strcpy( address->sun_path, socket_name );
+	return true;
+}
+
+/*
+ * The socket's directory has to belong to this user and be closed to
+ * everyone else, so that nobody can put another socket in its place.
+ * The daemon makes it when it is missing.
+ */
+bool daemon_directory( const tz_app_t* app, const char* socket_name, bool create )
+{
+	char directory[ PATH_MAX ] = ".";
+	const char* slash = strrchr( socket_name, '/' );
+	struct stat status;
+
+	if( slash )
+	{
+		size_t length = slash == socket_name ? 1 : (size_t) (slash - socket_name);
+
+		memcpy( directory, socket_name, length );
+		directory[ length ] = '\0';
+	}
+
+	if( create && mkdir( directory, 0700 ) != 0 && errno != EEXIST )
+	{
+		tz_print_error( app, "Unable to create '%s'\n", directory );
+		return false;
+	}
+
+	if( lstat( directory, &status ) != 0 || !S_ISDIR(status.st_mode) ||
+	    status.st_uid != geteuid() || (status.st_mode & 077) != 0 )
+	{
+		tz_print_error( app, "'%s' has to be a directory that only you can use\n", directory );
+		return false;
+	}
+
+	return true;
+}
+
+/*
+ * Whether the other end of the connection runs as this user.
+ */
+bool daemon_peer( int fd )
+{
+#if defined(__linux__)
+	struct ucred credentials;
+	socklen_t length = sizeof(credentials);
+
+	return getsockopt( fd, SOL_SOCKET, SO_PEERCRED, &credentials, &length ) == 0 &&
+	       credentials.uid == geteuid();
+#else
+	uid_t uid;
+	gid_t gid;
+
+	return getpeereid( fd, &uid, &gid ) == 0 && uid == geteuid();
+#endif
+}
+
+int daemon_listen( const tz_app_t* app, const char* socket_name )
+{
+	struct sockaddr_un address;
+	struct stat status;
+
+	if( !daemon_address( app, socket_name, &address ) || !daemon_directory( app, socket_name, true ) )
+	{
+		return -1;
+	}
+
+	if( lstat( socket_name, &status ) == 0 )
+	{
+		int probe = socket( AF_UNIX, SOCK_STREAM, 0 );
+		bool answered = probe >= 0 && connect( probe, (struct sockaddr*) &address, sizeof(address) ) == 0;
+
+		if( probe >= 0 )
+		{
+			close( probe );
+		}
+
+		if( !S_ISSOCK(status.st_mode) || answered )
+		{
+			tz_print_error( app, "'%s' is in use\n", socket_name );
+			return -1;
+		}
+
+		// Nobody answers; it was left behind by a daemon that died.
+		unlink( socket_name );
+	}
+
+	int listener = socket( AF_UNIX, SOCK_STREAM, 0 );
+	if( listener < 0 )
+	{
+		tz_print_error( app, "Unable to create a socket.\n" );
+		return -1;
+	}
+
+	// Only this user may connect.
+	mode_t mask = umask( 0077 );
+	bool bound = bind( listener, (struct sockaddr*) &address, sizeof(address) ) == 0;
+	umask( mask );
+
+	if( !bound || listen( listener, 64 ) != 0 )
+	{
+		tz_print_error( app, "Unable to listen on '%s'\n", socket_name );
+		close( listener );
+		return -1;
+	}
+
+	return listener;
+}
+
+void* daemon_serve( void* argument )
+{
+	daemon_worker_t* worker = argument;
+	daemon_t* daemon = worker->daemon;
+
+	while( !__atomic_load_n( &daemon->stop, __ATOMIC_RELAXED ) )
+	{
+		int client = accept( daemon->listener, NULL, NULL );
+
+		if( client < 0 )
+		{
+			if( errno == EINTR || errno == ECONNABORTED )
+			{
+				continue;
+			}
+			break;
+		}
+
+		// The directory keeps other users out; this makes sure of it.
+		if( !daemon_peer( client ) )
+		{
+			close( client );
+			continue;
+		}
+
+		// A client that stalls only holds up its worker for so long.
+		struct timeval timeout = { 2, 0 };
+		setsockopt( client, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout) );
+		setsockopt( client, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout) );
+
+		daemon_answer( worker, client );
+	}
+
+	return NULL;
+}
+
+void daemon_answer( daemon_worker_t* worker, int client )
+{
+	daemon_t* daemon = worker->daemon;
+	bool answered = false;
+	char request[ TZ_DAEMON_REQUEST_MAX ];
+	char* argv[ TZ_DAEMON_ARGUMENTS_MAX ];
+	int argc = 0;
+	size_t length = 0;
+	char* error_text = NULL;
+	size_t error_length = 0;
+	tz_query_t query = { 0 };
+	timezone_contact_t* matching = NULL;
+	tz_contact_store_t filtered;
+	bool filtered_created = false;
+	tz_render_t render;
+	bool render_created = false;
+	time_t instants[ TZ_GRID_MAX_INSTANTS ];
+
+	FILE* stream = fdopen( client, "w" );
+	if( !stream )
+	{
+		close( client );
+		return;
+	}
+
+	tz_app_t app = daemon->app;
+	app.now    = time( NULL );
+	app.query  = NULL;
+	app.errors = open_memstream( &error_text, &error_length );
+
+	if( !app.errors )
+	{
+		fclose( stream );
+		return;
+	}
+
+	if( !daemon_read( client, request, sizeof(request), &length ) || (length > 0 && request[ length - 1 ] != '\0') )
+	{
+		tz_print_error( &app, "Unable to read the query.\n" );
+		goto done;
+	}
+
+	for( size_t i = 0; i < length; i += strlen( request + i ) + 1 )
+	{
+		if( argc == TZ_DAEMON_ARGUMENTS_MAX )
+		{
+			tz_print_error( &app, "Too many options.\n" );
+			goto done;
+		}
+		argv[ argc++ ] = request + i;
+	}
+
+	tz_snapshot_t* snapshot = tz_snapshot_acquire( &daemon->reloader );
+
+	// libc computes those zones by switching TZ, which every local time depends on.
+	if( snapshot->fallback )
+	{
+		pthread_mutex_lock( &daemon->fallback_lock );
+	}
+
+	if( !daemon_parse( &app, &query, instants, argc, argv ) )
+	{
+		goto release;
+	}
+
+	if( !daemon_prepare( worker, snapshot ) )
+	{
+		tz_print_error( &app, "Out of memory.\n" );
+		goto release;
+	}
+
+	app.zones = &worker->zones;
+	tz_zone_cache_set_time( &worker->zones, app.now );
+
+	tz_contact_store_t* store = &worker->store;
+
+	if( app.query )
+	{
+		lc_vector_create( matching, lc_vector_size(snapshot->contacts) + 1 );
+
+		if( !tz_check_alloc( &app, matching ) )
+		{
+			goto release;
+		}
+
+		if( !tz_query_select( &query, tz_snapshot_index( snapshot ), &app, snapshot->contacts, false, &matching ) )
+		{
+			tz_print_error( &app, "Out of memory.\n" );
+			goto release;
+		}
+
+		filtered_created = tz_contact_store_create( &filtered, matching );
+		if( !tz_check_alloc( &app, filtered_created ? &filtered : NULL ) )
+		{
+			goto release;
+		}
+		store = &filtered;
+	}
+
+	render_created = tz_render_create( &render, stream, 4 * 1024 * 1024 );
+	if( !tz_check_alloc( &app, render_created ? &render : NULL ) )
+	{
+		goto release;
+	}
+
+	if( !tz_organize_data( store, &worker->map, &worker->zones, app.organize_by_time, app.query ) )
+	{
+		tz_print_error( &app, "Out of memory.\n" );
+		lc_tree_map_clear( &worker->map );
+		goto release;
+	}
+
+	fputc( DAEMON_ANSWERED, stream );
+	answered = true;
+
+	if( app.instant_count > 1 )
+	{
+		tz_grid( &render, &app, &worker->map );
+	}
+	else
+	{
+		tz_display( &render, &app, &worker->map );
+	}
+	tz_render_flush( &render );
+
+	// The groups point into the snapshot, which may be gone by the next query.
+	lc_tree_map_clear( &worker->map );
+
+release:
+	if( snapshot->fallback )
+	{
+		pthread_mutex_unlock( &daemon->fallback_lock );
+	}
+	tz_snapshot_release( snapshot );
+
+done:
+	if( render_created )
+	{
+		tz_render_destroy( &render );
+	}
+
+	if( filtered_created )
+	{
+		tz_contact_store_destroy( &filtered );
+	}
+
+	if( matching )
+	{
+		lc_vector_destroy( matching );
+	}
+	tz_query_destroy( &query );
+
+	fclose( app.errors );
+
+	if( !answered )
+	{
+		fputc( DAEMON_FAILED, stream );
+		fwrite( error_text, 1, error_length, stream );
+	}
+
+	free( error_text );
+	fclose( stream );
+}
+
+bool daemon_prepare( daemon_worker_t* worker, const tz_snapshot_t* snapshot )
+{
+	if( worker->generation == snapshot->generation )
+	{
+		return true;
+	}
+
+	if( worker->generation != 0 )
+	{
+		tz_contact_store_destroy( &worker->store );
+		tz_zone_cache_destroy( &worker->zones );
+		worker->generation = 0;
+	}
+
+	if( !tz_snapshot_zones( snapshot, &worker->zones, time( NULL ) ) )
+	{
+		return false;
+	}
+
+	if( !tz_contact_store_create( &worker->store, snapshot->contacts ) )
+	{
+		tz_zone_cache_destroy( &worker->zones );
+		return false;
+	}
+
+	worker->generation = snapshot->generation;
+	return true;
+}
+
+void daemon_worker_destroy( daemon_worker_t* worker )
+{
+	if( worker->generation != 0 )
+	{
+		tz_contact_store_destroy( &worker->store );
+		tz_zone_cache_destroy( &worker->zones );
+	}
+
+	if( worker->daemon )
+	{
+		lc_tree_map_destroy( &worker->map );
+	}
+}
+
+/*
+ * Reads the options of a query: the times, grouping, filter and format.
+ */
+bool daemon_parse( tz_app_t* app, tz_query_t* query, time_t* instants, int argc, char* argv[] )
+{
+	time_t now = app->now;
+	size_t instant_count = 0;
+
+	for( int arg = 0; arg < argc; arg++ )
+	{
+		bool has_parameter = (arg + 1) < argc;
+
+		if( strcmp( "-T", argv[arg] ) == 0 || strcmp( "--group-time", argv[arg] ) == 0 )
+		{
+			app->organize_by_time = true;
+
+			for( int i = 0; i < 2 && (arg + 1) < argc && *argv[ arg + 1 ] != '-'; i++ )
+			{
+				app->column_widths[ i ] = atoi( argv[ arg + 1 ] );
+				arg += 1;
+			}
+		}
+		else if( strcmp( "-U", argv[arg] ) == 0 || strcmp( "--group-utc-offset", argv[arg] ) == 0 )
+		{
+			app->organize_by_time = false;
+		}
+		else if( strcmp( "-m", argv[arg] ) == 0 || strcmp( "--minimal", argv[arg] ) == 0 )
+		{
+			app->minimal = true;
+		}
+		else if( (strcmp( "-t", argv[arg] ) == 0 || strcmp( "--time", argv[arg] ) == 0) && has_parameter )
+		{
+			if( !tz_timeline_parse_times( argv[ arg + 1 ], now, instants, TZ_GRID_MAX_INSTANTS, &instant_count ) )
+			{
+				if( instant_count == TZ_GRID_MAX_INSTANTS )
+				{
+					tz_print_error( app, "At most %d times can be shown\n", TZ_GRID_MAX_INSTANTS );
+				}
+				else
+				{
+					tz_print_error( app, "Failed to match time for '%s'\n", argv[arg + 1] );
+				}
+				return false;
+			}
+			app->now = instants[ 0 ];
+			arg += 1;
+		}
+		else if( strcmp( "--format", argv[arg] ) == 0 && has_parameter )
+		{
+			if( !tz_format_parse( argv[ arg + 1 ], &app->format ) )
+			{
+				tz_print_error( app, "Unrecognized format '%s'\n", argv[arg + 1] );
+				return false;
+			}
+			arg += 1;
+		}
+		else if( strcmp( "--where", argv[arg] ) == 0 && has_parameter )
+		{
+			if( !app->query && !tz_query_create( query ) )
+			{
+				tz_print_error( app, "Out of memory.\n" );
+				return false;
+			}
+			app->query = query;
+
+			if( !tz_query_parse( query, argv[ arg + 1 ] ) )
+			{
+				tz_print_error( app, "Invalid filter '%s'\n", argv[arg + 1] );
+				return false;
+			}
+			arg += 1;
+		}
+		else if( strcmp( "-t", argv[arg] ) == 0 || strcmp( "--time", argv[arg] ) == 0 ||
+		         strcmp( "--format", argv[arg] ) == 0 || strcmp( "--where", argv[arg] ) == 0 )
+		{
+			tz_print_error( app, "Missing parameter for option '%s'\n", argv[arg] );
+			return false;
+		}
+		else
+		{
+			tz_print_error( app, "Unsupported option '%s' for the daemon\n", argv[arg] );
+			return false;
+		}
+	}
+
+	if( instant_count > 1 )
+	{
+		app->instants      = instants;
+		app->instant_count = instant_count;
+
+		if( app->format != TZ_FORMAT_TEXT )
+		{
+			tz_print_error( app, "Several times are only drawn as text\n" );
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/*
+ * Reads until the other side shuts down its end; false if there is more
+ * than fits.
+ */
+bool daemon_read( int fd, char* buffer, size_t size, size_t* length )
+{
+	*length = 0;
+
+	for( ;; )
+	{
+		ssize_t count = read( fd, buffer + *length, size - *length );
+
+		if( count < 0 && errno == EINTR )
+		{
+			continue;
+		}
+		if( count <= 0 )
+		{
+			return count == 0;
+		}
+
+		*length += count;
+		if( *length == size )
+		{
+			return false;
+		}
+	}
+}
+
+bool daemon_write( int fd, const char* bytes, size_t size )
+{
+	while( size > 0 )
+	{
+		ssize_t count = write( fd, bytes, size );
+
+		if( count < 0 && errno == EINTR )
+		{
+			continue;
+		}
+		if( count <= 0 )
+		{
+			return false;
+		}
+
+		bytes += count;
+		size  -= count;
+	}
+
+	return true;
+}
+
+#else
+void tz_daemon_socket_name( char* name, size_t size )
+{
+	name[ 0 ] = '\0';
+}
+
+bool tz_daemon( const tz_app_t* app, const char* socket_name, const char** names, size_t count, int use_cache )
+{
+	tz_print_error( app, "The daemon needs Unix domain sockets.\n" );
+	return false;
+}
+
+int tz_daemon_query( const tz_app_t* app, const char* socket_name, int argc, char* argv[] )
+{
+	tz_print_error( app, "The daemon needs Unix domain sockets.\n" );
+	return -2;
+}
+#endif
@@ -0,0 +1,38 @@
+/*
+ * Copyright (C) 2019-2025, Joe Marrero. http://www.joemarrero.com/
+ * Copyright (C) 2017, End Point Corporation. http://www.endpoint.com/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef _TZ_DAEMON_H_
+#define _TZ_DAEMON_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "timezoner.h"
+
+#define TZ_DAEMON_WORKERS          (4)
+#define TZ_DAEMON_REQUEST_MAX      (16 * 1024)  /* bytes of options a client may send */
+#define TZ_DAEMON_ARGUMENTS_MAX    (64)
+
+void tz_daemon_socket_name ( char* name, size_t size );
+bool tz_daemon             ( const tz_app_t* app, const char* socket_name, const char** names, size_t count, int use_cache );
+int  tz_daemon_query       ( const tz_app_t* app, const char* socket_name, int argc, char* argv[] );
+
+#endif /* _TZ_DAEMON_H_ */
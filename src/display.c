@@ -0,0 +1,712 @@
+/*
+ * Copyright (C) 2019-2025, Joe Marrero. http://www.joemarrero.com/
+ * Copyright (C) 2017, End Point Corporation. http://www.endpoint.com/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <wchar.h>
+#include <time.h>
+#include <xtd/console.h>
+#include <collections/tree-map.h>
+#include "timezoner.h"
+#include "display.h"
+#include "format.h"
+
+/*
+ * A read-only cursor over one group of the organized map.
+ */
+typedef struct display_column {
+	intptr_t key;                    /* the group's UTC offset */
+	timezone_contact_t* const* list;
+	size_t count;
+} display_column_t;
+
+static display_column_t*         display_columns        ( lc_tree_map_t* map, size_t* column_count, size_t* row_count );
+static const timezone_contact_t* display_column_contact ( const display_column_t* column, size_t row );
+
+/*
+ * Draws the organized contacts in the layout selected on the command line.
+ */
+void tz_display( tz_render_t* render, const tz_app_t* app, lc_tree_map_t* map )
+{
+	if( app->format != TZ_FORMAT_TEXT )
+	{
+		tz_format_groups( render, app, map );
+	}
+	else if( app->organize_by_time )
+	{
+		if (app->minimal)
+		{
+			tz_display_time_grouping_minimal( render, map, app->zones, app->column_widths[0], app->column_widths[1] );
+		}
+		else
+		{
+			tz_display_time_grouping( render, map, app->zones, app->column_widths[0], app->column_widths[1] );
+		}
+	}
+	else
+	{
+		if (app->minimal)
+		{
+			tz_display_utc_grouping_minimal( render, map, app->zones );
+		}
+		else
+		{
+			tz_display_utc_grouping( render, map, app->zones );
+		}
+	}
+}
+
+void tz_display_time_grouping( tz_render_t* render, lc_tree_map_t* map, tz_zone_cache_t* zones, int name_width, int email_width )
+{
+	if( name_width < 10 )
+	{
+		name_width = 10;
+	}
+
+	if( email_width < 10 )
+	{
+		email_width = 10;
+	}
+
+	if( lc_tree_map_size( map ) == 0 )
+	{
+		return;
+	}
+
+	bool first = true;
+
+	for( lc_tree_map_iterator_t itr = lc_tree_map_begin( map );
+	     itr != lc_tree_map_end( );
+	     itr = lc_tree_map_next(itr) )
+	{
+		timezone_contact_t** list = itr->value;
+
+		if( first )
+		{
+			tz_render_text( render, L"\u250c\u2500\u2500\u2524 " );
+		}
+		else
+		{
+			tz_render_text( render, L"\u251c\u2500\u2500\u2524 " );
+		}
+		tz_render_color( render, CONSOLE_COLOR8_BRIGHT_YELLOW );
+
+
+		const tz_zone_t* zone = tz_zone_cache_resolve( zones, list[0]->zone );
+		tz_render_clock( render, zone, list[0]->zone, "%r" /* %T for 24-hour time */, 0 );
+		tz_render_reset( render );
+
+		tz_render_text( render, L" \u251c" );
+		tz_render_repeat( render, L'\u2500', 35 + name_width + email_width );
+		if( first )
+		{
+			tz_render_text( render, L"\u2510\n" );
+			first = false;
+		}
+		else
+		{
+			tz_render_text( render, L"\u2524\n" );
+		}
+
+		for( int i = 0; i < lc_vector_size(list); i++ )
+		{
+			timezone_contact_t* contact = list[ i ];
+
+			tz_render_text( render, L"\u2502 " );
+			tz_render_color( render, CONSOLE_COLOR8_BRIGHT_CYAN );
+			if( contact->name_width > name_width)
+			{
+				// truncated
+				tz_render_truncated( render, contact->name, name_width - 3 );
+				tz_render_text( render, L"...  " );
+			}
+			else
+			{
+				// fixed width
+				tz_render_field( render, contact->name, contact->name_width, name_width );
+				tz_render_text( render, L"  " );
+			}
+			tz_render_reset( render );
+
+			tz_render_color( render, CONSOLE_COLOR8_GREY_15 );
+			if( contact->email_width > email_width)
+			{
+				// truncated
+				tz_render_char( render, (wchar_t) 0x2709 );
+				tz_render_text( render, L" " );
+				tz_render_truncated( render, contact->email, email_width - 3 );
+				tz_render_text( render, L"...  " );
+			}
+			else
+			{
+				// fixed width
+				tz_render_char( render, (wchar_t) 0x2709 );
+				tz_render_text( render, L" " );
+				tz_render_field( render, contact->email, contact->email_width, email_width );
+				tz_render_text( render, L"  " );
+			}
+			tz_render_reset( render );
+
+			tz_render_color( render, CONSOLE_COLOR8_GREY_15 );
+			if( contact->office_phone_width > 19)
+			{
+				// truncated
+				tz_render_char( render, (wchar_t) 0x260e );
+				tz_render_text( render, L"  " );
+				tz_render_truncated( render, contact->office_phone, 16 );
+				tz_render_text( render, L"... " );
+			}
+			else
+			{
+				// fixed width
+				tz_render_char( render, (wchar_t) 0x260e );
+				tz_render_text( render, L"  " );
+				tz_render_field( render, contact->office_phone, contact->office_phone_width, 19 );
+				tz_render_text( render, L" " );
+			}
+			tz_render_reset( render );
+
+			tz_render_color( render, CONSOLE_COLOR8_GREY_15 );
+			if( contact->mobile_phone_width > 19)
+			{
+				// truncated
+				tz_render_char( render, (wchar_t) 0x1f4f1 );
+				tz_render_truncated( render, contact->mobile_phone, 16 );
+				tz_render_text( render, L"... " );
+			}
+			else
+			{
+				// fixed width
+				tz_render_char( render, (wchar_t) 0x1f4f1 );
+				tz_render_field( render, contact->mobile_phone, contact->mobile_phone_width, 19 );
+				tz_render_text( render, L" " );
+			}
+			tz_render_reset( render );
+
+			tz_render_text( render, L"\u2502\n" );
+		} // for
+	} // for
+
+
+	tz_render_text( render, L"\u2514" );
+	tz_render_repeat( render, L'\u2500', 52 + name_width + email_width );
+	tz_render_text( render, L"\u2518\n" );
+}
+
+
+void tz_display_time_grouping_minimal( tz_render_t* render, lc_tree_map_t* map, tz_zone_cache_t* zones, int name_width, int email_width )
+{
+	if( name_width < 10 )
+	{
+		name_width = 10;
+	}
+
+	if( email_width < 10 )
+	{
+		email_width = 10;
+	}
+
+	if( lc_tree_map_size( map ) == 0 )
+	{
+		return;
+	}
+
+	for( lc_tree_map_iterator_t itr = lc_tree_map_begin( map );
+	     itr != lc_tree_map_end( );
+	     itr = lc_tree_map_next(itr) )
+	{
+		timezone_contact_t** list = itr->value;
+
+
+		const tz_zone_t* zone = tz_zone_cache_resolve( zones, list[0]->zone );
+		tz_render_clock( render, zone, list[0]->zone, "%r" /* %T for 24-hour time */, 0 );
+		tz_render_text( render, L"\n" );
+		for( int i = 0; i < lc_vector_size(list); i++ ) // for each contact...
+		{
+			timezone_contact_t* contact = list[ i ];
+
+			if( contact->name_width > name_width)
+			{
+				// truncated
+				tz_render_truncated( render, contact->name, name_width - 3 );
+				tz_render_text( render, L"...  " );
+			}
+			else
+			{
+				// fixed width
+				tz_render_field( render, contact->name, contact->name_width, name_width );
+				tz_render_text( render, L"  " );
+			}
+
+			if( contact->email_width > email_width)
+			{
+				// truncated
+				tz_render_text( render, L" " );
+				tz_render_truncated( render, contact->email, email_width - 3 );
+				tz_render_text( render, L"...  " );
+			}
+			else
+			{
+				// fixed width
+				tz_render_text( render, L" " );
+				tz_render_field( render, contact->email, contact->email_width, email_width );
+				tz_render_text( render, L"  " );
+			}
+
+			if( contact->office_phone_width > 19)
+			{
+				// truncated
+				tz_render_text( render, L" " );
+				tz_render_truncated( render, contact->office_phone, 16 );
+				tz_render_text( render, L"... " );
+			}
+			else
+			{
+				// fixed width
+				tz_render_text( render, L"  " );
+				tz_render_field( render, contact->office_phone, contact->office_phone_width, 19 );
+				tz_render_text( render, L" " );
+			}
+
+			if( contact->mobile_phone_width > 19)
+			{
+				// truncated
+				tz_render_truncated( render, contact->mobile_phone, 16 );
+				tz_render_text( render, L"... " );
+			}
+			else
+			{
+				// fixed width
+				tz_render_field( render, contact->mobile_phone, contact->mobile_phone_width, 19 );
+				tz_render_text( render, L" " );
+			}
+
+			tz_render_text( render, L"\n" );
+		} // for
+
+		tz_render_text( render, L"\n" );
+	} // for
+}
+
+
+void tz_display_utc_grouping( tz_render_t* render, lc_tree_map_t* map, tz_zone_cache_t* zones )
+{
+	size_t column_count = 0;
+	size_t row_count = 0;
+	display_column_t* columns = display_columns( map, &column_count, &row_count );
+
+	if( !columns )
+	{
+		if( column_count > 0 )
+		{
+			render->error = true;
+		}
+		return;
+	}
+
+	// start of headers
+	{
+		tz_render_text( render, L"\u250c" );
+		for( size_t column = 0; column < column_count; column++ )
+		{
+			tz_render_repeat( render, L'\u2500', 25 );
+			tz_render_text( render, column + 1 == column_count ? L"\u2510" : L"\u252c" );
+		} // for
+		tz_render_text( render, L"\n" );
+		tz_render_text( render, L"\u2502" );
+		for( size_t column = 0; column < column_count; column++ )
+		{
+			char utc_offset_str[ 16 ];
+			snprintf( utc_offset_str, sizeof(utc_offset_str), "%+05.1f", columns[ column ].key / 3600.0 );
+
+			tz_render_color( render, CONSOLE_COLOR8_BRIGHT_MAGENTA );
+			tz_render_text( render, L"        UTC" );
+			tz_render_string( render, utc_offset_str, 0 );
+			tz_render_text( render, L"         " );
+			tz_render_reset( render );
+			tz_render_text( render, L"\u2502" );
+		} // for
+		tz_render_text( render, L"\n" );
+		tz_render_text( render, L"\u251c" );
+		for( size_t column = 0; column < column_count; column++ )
+		{
+			tz_render_repeat( render, L'\u2500', 25 );
+			tz_render_text( render, column + 1 == column_count ? L"\u2524" : L"\u253c" );
+		} // for
+		tz_render_text( render, L"\n" );
+	} // end of headers
+
+
+	for( size_t row = 0; row < row_count; row++ )
+	{
+		tz_render_text( render, L"\u2502" );
+		for( size_t column = 0; column < column_count; column++ )
+		{
+			const timezone_contact_t* contact = display_column_contact( &columns[ column ], row );
+			if( contact )
+			{
+				tz_render_color( render, CONSOLE_COLOR8_BRIGHT_CYAN );
+				if( contact->name_width > 23)
+				{
+					// truncated
+					tz_render_text( render, L" " );
+					tz_render_truncated( render, contact->name, 20 );
+					tz_render_text( render, L"... " );
+				}
+				else
+				{
+					// fixed width
+					tz_render_text( render, L" " );
+					tz_render_field( render, contact->name, contact->name_width, 23 );
+					tz_render_text( render, L" " );
+				}
+				tz_render_reset( render );
+			}
+			else
+			{
+				tz_render_repeat( render, L' ', 25 );
+			}
+			tz_render_text( render, L"\u2502" );
+		} // for
+		tz_render_text( render, L"\n" );
+		tz_render_text( render, L"\u2502" );
+		for( size_t column = 0; column < column_count; column++ )
+		{
+			const timezone_contact_t* contact = display_column_contact( &columns[ column ], row );
+			if( contact )
+			{
+				const tz_zone_t* zone = tz_zone_cache_resolve( zones, contact->zone );
+
+				tz_render_color( render, CONSOLE_COLOR8_BRIGHT_YELLOW );
+				tz_render_text( render, L"  \u23f0 " );
+				tz_render_clock( render, zone, contact->zone, "%I:%M:%S %p", 19 );
+				tz_render_text( render, L" " );
+				tz_render_reset( render );
+			}
+			else
+			{
+				tz_render_repeat( render, L' ', 25 );
+			}
+			tz_render_text( render, L"\u2502" );
+		} // for
+		tz_render_text( render, L"\n" );
+		tz_render_text( render, L"\u2502" );
+		for( size_t column = 0; column < column_count; column++ )
+		{
+			const timezone_contact_t* contact = display_column_contact( &columns[ column ], row );
+			if( contact )
+			{
+				tz_render_color( render, CONSOLE_COLOR8_GREY_15 );
+				tz_render_text( render, L"  " );
+				tz_render_char( render, (wchar_t) 0x2709 );
+				tz_render_text( render, L" " );
+				if( contact->email_width > 20)
+				{
+					// truncated
+					tz_render_truncated( render, contact->email, 17 );
+					tz_render_text( render, L"... " );
+				}
+				else
+				{
+					// fixed width
+					tz_render_field( render, contact->email, contact->email_width, 20 );
+					tz_render_text( render, L" " );
+				}
+				tz_render_reset( render );
+			}
+			else
+			{
+				tz_render_repeat( render, L' ', 25 );
+			}
+			tz_render_text( render, L"\u2502" );
+		} // for
+		tz_render_text( render, L"\n" );
+		tz_render_text( render, L"\u2502" );
+		for( size_t column = 0; column < column_count; column++ )
+		{
+			const timezone_contact_t* contact = display_column_contact( &columns[ column ], row );
+			if( contact )
+			{
+				tz_render_color( render, CONSOLE_COLOR8_GREY_15 );
+				tz_render_text( render, L"  \u260E  " );
+				if( contact->office_phone_width > 17)
+				{
+					// truncated
+					tz_render_truncated( render, contact->office_phone, 17 );
+					tz_render_text( render, L"... " );
+				}
+				else
+				{
+					// fixed width
+					tz_render_field( render, contact->office_phone, contact->office_phone_width, 19 );
+					tz_render_text( render, L" " );
+				}
+				tz_render_reset( render );
+			}
+			else
+			{
+				tz_render_repeat( render, L' ', 25 );
+			}
+			tz_render_text( render, L"\u2502" );
+		} // for
+		tz_render_text( render, L"\n" );
+		tz_render_text( render, L"\u2502" );
+		for( size_t column = 0; column < column_count; column++ )
+		{
+			const timezone_contact_t* contact = display_column_contact( &columns[ column ], row );
+			if( contact )
+			{
+				tz_render_color( render, CONSOLE_COLOR8_GREY_15 );
+				tz_render_text( render, L"   " );
+				tz_render_char( render, (wchar_t) 0x1f4f1 );
+				if( contact->mobile_phone_width > 17)
+				{
+					// truncated
+					tz_render_truncated( render, contact->mobile_phone, 17 );
+				}
+				else
+				{
+					// fixed width
+					tz_render_field( render, contact->mobile_phone, contact->mobile_phone_width, 19 );
+				}
+				tz_render_text( render, L" " );
+				tz_render_reset( render );
+			}
+			else
+			{
+				tz_render_repeat( render, L' ', 25 );
+			}
+			tz_render_text( render, L"\u2502" );
+		} // for
+		tz_render_text( render, L"\n" );
+	} // for
+
+
+	// start of footer
+	{
+		tz_render_text( render, L"\u2514" );
+		for( size_t column = 0; column < column_count; column++ )
+		{
+			tz_render_repeat( render, L'\u2500', 25 );
+			tz_render_text( render, column + 1 == column_count ? L"\u2518" : L"\u2534" );
+		} // for
+		tz_render_text( render, L"\n" );
+	} // end of footer
+
+	free( columns );
+}
+
+
+void tz_display_utc_grouping_minimal( tz_render_t* render, lc_tree_map_t* map, tz_zone_cache_t* zones )
+{
+	size_t column_count = 0;
+	size_t row_count = 0;
+	display_column_t* columns = display_columns( map, &column_count, &row_count );
+
+	if( !columns )
+	{
+		if( column_count > 0 )
+		{
+			render->error = true;
+		}
+		return;
+	}
+
+	// start of headers
+	{
+		for( size_t column = 0; column < column_count; column++ )
+		{
+			char utc_offset_str[ 16 ];
+			snprintf( utc_offset_str, sizeof(utc_offset_str), "%+05.1f", columns[ column ].key / 3600.0 );
+
+			tz_render_text( render, L"UTC" );
+			tz_render_string( render, utc_offset_str, 5 );
+			tz_render_text( render, L"                " );
+		} // for
+		tz_render_text( render, L"\n\n" );
+	} // end of headers
+
+
+	for( size_t row = 0; row < row_count; row++ )
+	{
+		for( size_t column = 0; column < column_count; column++ )
+		{
+			const timezone_contact_t* contact = display_column_contact( &columns[ column ], row );
+			if( !contact )
+			{
+				tz_render_repeat( render, L' ', 24 );
+			}
+			else if( contact->name_width > 20)
+			{
+				// truncated
+				tz_render_truncated( render, contact->name, 20 );
+				tz_render_text( render, L"... " );
+			}
+			else
+			{
+				// fixed width
+				tz_render_field( render, contact->name, contact->name_width, 24 );
+			}
+		} // for
+		tz_render_text( render, L"\n" );
+		for( size_t column = 0; column < column_count; column++ )
+		{
+			const timezone_contact_t* contact = display_column_contact( &columns[ column ], row );
+			if( contact )
+			{
+				const tz_zone_t* zone = tz_zone_cache_resolve( zones, contact->zone );
+
+				tz_render_text( render, L"  " );
+				tz_render_clock( render, zone, contact->zone, "%I:%M:%S %p", 22 );
+			}
+			else
+			{
+				tz_render_repeat( render, L' ', 24 );
+			}
+		} // for
+		tz_render_text( render, L"\n" );
+		for( size_t column = 0; column < column_count; column++ )
+		{
+			const timezone_contact_t* contact = display_column_contact( &columns[ column ], row );
+			if( !contact )
+			{
+				tz_render_repeat( render, L' ', 24 );
+			}
+			else if( contact->email_width > 19)
+			{
+				// truncated
+				tz_render_text( render, L"  " );
+				tz_render_truncated( render, contact->email, 19 );
+				tz_render_text( render, L"..." );
+			}
+			else
+			{
+				// fixed width
+				tz_render_text( render, L"  " );
+				tz_render_field( render, contact->email, contact->email_width, 22 );
+			}
+		} // for
+		tz_render_text( render, L"\n" );
+		for( size_t column = 0; column < column_count; column++ )
+		{
+			const timezone_contact_t* contact = display_column_contact( &columns[ column ], row );
+			if( !contact )
+			{
+				tz_render_repeat( render, L' ', 24 );
+			}
+			else if( contact->office_phone_width > 19)
+			{
+				// truncated
+				tz_render_text( render, L"  " );
+				tz_render_truncated( render, contact->office_phone, 19 );
+				tz_render_text( render, L"..." );
+			}
+			else
+			{
+				// fixed width
+				tz_render_text( render, L"  " );
+				tz_render_field( render, contact->office_phone, contact->office_phone_width, 22 );
+			}
+		} // for
+		tz_render_text( render, L"\n" );
+		for( size_t column = 0; column < column_count; column++ )
+		{
+			const timezone_contact_t* contact = display_column_contact( &columns[ column ], row );
+			if( !contact )
+			{
+				tz_render_repeat( render, L' ', 24 );
+			}
+			else if( contact->mobile_phone_width > 19)
+			{
+				// truncated
+				tz_render_text( render, L"  " );
+				tz_render_truncated( render, contact->mobile_phone, 19 );
+			}
+			else
+			{
+				// fixed width
+				tz_render_text( render, L"  " );
+				tz_render_field( render, contact->mobile_phone, contact->mobile_phone_width, 22 );
+			}
+		} // for
+		tz_render_text( render, L"\n\n" );
+	} // for
+
+	free( columns );
+}
+
+/*
+ * Walks the map once into a flat array of columns, one per group, so
+ * rows can be drawn by index without touching the map again. The groups
+ * are only read; the same map can be drawn any number of times. Returns
+ * NULL if the map is empty or on allocation failure.
+ */
+display_column_t* display_columns( lc_tree_map_t* map, size_t* column_count, size_t* row_count )
+{
+	*column_count = lc_tree_map_size( map );
+	*row_count    = 0;
+
+	if( *column_count == 0 )
+	{
+		return NULL;
+	}
+
+	display_column_t* columns = malloc( sizeof(display_column_t) * *column_count );
+	if( !columns )
+	{
+		return NULL;
+	}
+
+	size_t column = 0;
+	for( lc_tree_map_iterator_t itr = lc_tree_map_begin( map );
+	     itr != lc_tree_map_end( );
+	     itr = lc_tree_map_next(itr) )
+	{
+		timezone_contact_t** list = itr->value;
+		size_t count = list ? lc_vector_size(list) : 0;
+
+		columns[ column++ ] = (display_column_t) {
+			.key   = (intptr_t) itr->key,
+			.list  = list,
+			.count = count
+		};
+
+		if( count > *row_count )
+		{
+			*row_count = count;
+		}
+	}
+
+	return columns;
+}
+
+/*
+ * The contact in a column's row, or NULL past the end of its group.
+ * Rows are taken from the back of each group.
+ */
+const timezone_contact_t* display_column_contact( const display_column_t* column, size_t row )
+{
+	return row < column->count ? column->list[ column->count - 1 - row ] : NULL;
+}
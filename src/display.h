@@ -0,0 +1,37 @@
+/*
+ * Copyright (C) 2019-2025, Joe Marrero. http://www.joemarrero.com/
+ * Copyright (C) 2017, End Point Corporation. http://www.endpoint.com/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef _TZ_DISPLAY_H_
+#define _TZ_DISPLAY_H_
+
+#include <collections/tree-map.h>
+#include "timezoner.h"
+#include "render.h"
+#include "zone.h"
+
+void tz_display                       ( tz_render_t* render, const tz_app_t* app, lc_tree_map_t* map );
+void tz_display_time_grouping         ( tz_render_t* render, lc_tree_map_t* map, tz_zone_cache_t* zones, int name_width, int email_width );
+void tz_display_time_grouping_minimal ( tz_render_t* render, lc_tree_map_t* map, tz_zone_cache_t* zones, int name_width, int email_width );
+void tz_display_utc_grouping          ( tz_render_t* render, lc_tree_map_t* map, tz_zone_cache_t* zones );
+void tz_display_utc_grouping_minimal  ( tz_render_t* render, lc_tree_map_t* map, tz_zone_cache_t* zones );
+
+#endif /* _TZ_DISPLAY_H_ */
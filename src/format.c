@@ -0,0 +1,348 @@
+/*
+ * Copyright (C) 2019-2025, Joe Marrero. http://www.joemarrero.com/
+ * Copyright (C) 2017, End Point Corporation. http://www.endpoint.com/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <wchar.h>
+#include <time.h>
+#include "format.h"
+#include "zoneinfo.h"
+
+static bool format_needs_escapes ( tz_format_t format, const wchar_t* s );
+static int  format_group         ( const tz_app_t* app, intptr_t key, bool first, char* text, size_t size );
+
+
+bool tz_format_parse( const char* s, tz_format_t* format )
+{
+	static const struct {
+		const char* name;
+		tz_format_t format;
+	} formats[] = {
+		{ "text",   TZ_FORMAT_TEXT },
+		{ "csv",    TZ_FORMAT_CSV },
+		{ "tsv",    TZ_FORMAT_TSV },
+		{ "json",   TZ_FORMAT_JSON },
+		{ "ndjson", TZ_FORMAT_NDJSON },
+	};
+
+	for( size_t i = 0; i < sizeof(formats) / sizeof(formats[0]); i++ )
+	{
+		if( strcmp( formats[ i ].name, s ) == 0 )
+		{
+			*format = formats[ i ].format;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/*
+ * Writes a string as one field: quoted (only when it has to be) for CSV
+ * as in RFC 4180, with backslash escapes for TSV, and as a string
+ * literal for JSON.
+ */
+void tz_format_string( tz_render_t* render, tz_format_t format, const wchar_t* s )
+{
+	if( !format_needs_escapes( format, s ) )
+	{
+		if( format == TZ_FORMAT_JSON || format == TZ_FORMAT_NDJSON )
+		{
+			tz_render_char( render, L'"' );
+			tz_render_text( render, s );
+			tz_render_char( render, L'"' );
+		}
+		else
+		{
+			tz_render_text( render, s );
+		}
+	}
+	else if( format == TZ_FORMAT_CSV )
+	{
+		tz_render_char( render, L'"' );
+		for( ; *s; s++ )
+		{
+			if( *s == L'"' )
+			{
+				tz_render_char( render, L'"' );
+			}
+			tz_render_char( render, *s );
+		}
+		tz_render_char( render, L'"' );
+	}
+	else if( format == TZ_FORMAT_TSV )
+	{
+		for( ; *s; s++ )
+		{
+			switch( *s )
+			{
+				case L'\t': tz_render_bytes( render, "\\t", 2 ); break;
+				case L'\n': tz_render_bytes( render, "\\n", 2 ); break;
+				case L'\r': tz_render_bytes( render, "\\r", 2 ); break;
+				case L'\\': tz_render_bytes( render, "\\\\", 2 ); break;
+				default: tz_render_char( render, *s ); break;
+			}
+		}
+	}
+	else if( format == TZ_FORMAT_JSON || format == TZ_FORMAT_NDJSON )
+	{
+		tz_render_char( render, L'"' );
+		for( ; *s; s++ )
+		{
+			if( *s == L'"' || *s == L'\\' )
+			{
+				tz_render_char( render, L'\\' );
+				tz_render_char( render, *s );
+			}
+			else if( *s < 0x20 )
+			{
+				char escape[ 12 ];
+				snprintf( escape, sizeof(escape), "\\u%04x", (unsigned) *s );
+				tz_render_bytes( render, escape, 6 );
+			}
+			else
+			{
+				tz_render_char( render, *s );
+			}
+		}
+		tz_render_char( render, L'"' );
+	}
+	else
+	{
+		tz_render_text( render, s );
+	}
+}
+
+void tz_format_narrow_string( tz_render_t* render, tz_format_t format, const char* s )
+{
+	wchar_t wide[ 256 ];
+	size_t length = mbstowcs( wide, s, sizeof(wide) / sizeof(wide[0]) - 1 );
+
+	if( length == (size_t) -1 )
+	{
+		length = 0;
+	}
+	wide[ length ] = L'\0';
+
+	tz_format_string( render, format, wide );
+}
+
+/*
+ * Writes the organized contacts for scripts: no colors, widths or
+ * truncation, in one pass over the groups. JSON is a single document;
+ * the others have one contact per line, with its group's key in the
+ * first column.
+ */
+bool tz_format_groups( tz_render_t* render, const tz_app_t* app, lc_tree_map_t* map )
+{
+	tz_format_t format = app->format;
+	size_t zone_count = tz_zone_cache_size( app->zones );
+	size_t* zone_offsets = malloc( sizeof(size_t) * (zone_count + 1) );
+	tz_render_t zone_text;
+	bool zone_text_created = tz_render_create( &zone_text, NULL, 0 );
+	bool result = false;
+
+	if( !tz_check_alloc( app, zone_offsets ) || !tz_check_alloc( app, zone_text_created ? &zone_text : NULL ) )
+	{
+		goto done;
+	}
+
+	// Zone names are escaped once, not for every contact.
+	for( size_t id = 0; id < zone_count; id++ )
+	{
+		zone_offsets[ id ] = zone_text.length;
+		tz_format_narrow_string( &zone_text, format, app->zones->zones[ id ].name );
+	}
+	zone_offsets[ zone_count ] = zone_text.length;
+
+	if( format == TZ_FORMAT_JSON )
+	{
+		char instant[ 64 ];
+		struct tm tm;
+
+		tz_zoneinfo_gmtime( (int64_t) app->now, &tm );
+		snprintf( instant, sizeof(instant), "{\"instant\":\"%04d-%02d-%02dT%02d:%02d:%02dZ\",\"groups\":[",
+		          tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday, tm.tm_hour, tm.tm_min, tm.tm_sec );
+		tz_render_bytes( render, instant, strlen(instant) );
+	}
+	else if( format == TZ_FORMAT_CSV || format == TZ_FORMAT_TSV )
+	{
+		const wchar_t* columns[] = { L"zone", L"email", L"name", L"office_phone", L"mobile_phone" };
+
+		tz_render_text( render, app->organize_by_time ? L"local_time" : L"utc_offset" );
+		for( size_t i = 0; i < sizeof(columns) / sizeof(columns[0]); i++ )
+		{
+			tz_render_char( render, tz_format_separator( format ) );
+			tz_render_text( render, columns[ i ] );
+		}
+		tz_render_char( render, L'\n' );
+	}
+
+	bool first_group = true;
+
+	for( lc_tree_map_iterator_t itr = lc_tree_map_begin( map );
+	     itr != lc_tree_map_end( );
+	     itr = lc_tree_map_next(itr) )
+	{
+		const timezone_contact_t** list = itr->value;
+		size_t count = lc_vector_size( list );
+		char group[ 64 ];
+
+		if( count == 0 )
+		{
+			continue;
+		}
+
+		// Every line of the other formats starts with its group's key.
+		int group_length = format_group( app, (intptr_t) itr->key, first_group, group, sizeof(group) );
+		if( format == TZ_FORMAT_JSON )
+		{
+			tz_render_bytes( render, group, group_length );
+		}
+
+		for( size_t i = 0; i < count; i++ )
+		{
+			const timezone_contact_t* contact = list[ i ];
+			const char* zone = zone_text.buffer + zone_offsets[ contact->zone ];
+			size_t zone_length = zone_offsets[ contact->zone + 1 ] - zone_offsets[ contact->zone ];
+
+			if( format == TZ_FORMAT_JSON || format == TZ_FORMAT_NDJSON )
+			{
+				if( format == TZ_FORMAT_JSON )
+				{
+					tz_render_bytes( render, i == 0 ? "{\"zone\":" : ",{\"zone\":", i == 0 ? 8 : 9 );
+				}
+				else
+				{
+					tz_render_bytes( render, group, group_length );
+					tz_render_bytes( render, "\"zone\":", 7 );
+				}
+				tz_render_bytes( render, zone, zone_length );
+				tz_render_bytes( render, ",\"email\":", 9 );
+				tz_format_string( render, format, contact->email );
+				tz_render_bytes( render, ",\"name\":", 8 );
+				tz_format_string( render, format, contact->name );
+				tz_render_bytes( render, ",\"office_phone\":", 16 );
+				tz_format_string( render, format, contact->office_phone );
+				tz_render_bytes( render, ",\"mobile_phone\":", 16 );
+				tz_format_string( render, format, contact->mobile_phone );
+				tz_render_bytes( render, format == TZ_FORMAT_JSON ? "}" : "}\n", format == TZ_FORMAT_JSON ? 1 : 2 );
+			}
+			else
+			{
+				wchar_t separator = tz_format_separator( format );
+
+				tz_render_bytes( render, group, group_length );
+				tz_render_bytes( render, zone, zone_length );
+				tz_render_char( render, separator );
+				tz_format_string( render, format, contact->email );
+				tz_render_char( render, separator );
+				tz_format_string( render, format, contact->name );
+				tz_render_char( render, separator );
+				tz_format_string( render, format, contact->office_phone );
+				tz_render_char( render, separator );
+				tz_format_string( render, format, contact->mobile_phone );
+				tz_render_char( render, L'\n' );
+			}
+		}
+
+		if( format == TZ_FORMAT_JSON )
+		{
+			tz_render_bytes( render, "]}", 2 );
+		}
+
+		first_group = false;
+	}
+
+	if( format == TZ_FORMAT_JSON )
+	{
+		tz_render_bytes( render, "]}\n", 3 );
+	}
+
+	result = !render->error;
+
+done:
+	if( zone_text_created )
+	{
+		tz_render_destroy( &zone_text );
+	}
+	free( zone_offsets );
+	return result;
+}
+
+/*
+ * Formats a group's key: the local time (as HH:MM:SS) or the UTC offset
+ * (in seconds). For JSON it opens the group, for NDJSON each object.
+ */
+int format_group( const tz_app_t* app, intptr_t key, bool first, char* text, size_t size )
+{
+	const char* name = app->organize_by_time ? "local_time" : "utc_offset";
+	char value[ 32 ];
+
+	if( app->organize_by_time )
+	{
+		snprintf( value, sizeof(value), "%02ld:%02ld:%02ld", (long) key / 3600, (long) key / 60 % 60, (long) key % 60 );
+	}
+	else
+	{
+		snprintf( value, sizeof(value), "%ld", (long) key );
+	}
+
+	switch( app->format )
+	{
+		case TZ_FORMAT_JSON:
+			return snprintf( text, size, app->organize_by_time ? "%s{\"%s\":\"%s\",\"contacts\":[" : "%s{\"%s\":%s,\"contacts\":[",
+			          first ? "" : ",", name, value );
+		case TZ_FORMAT_NDJSON:
+			return snprintf( text, size, app->organize_by_time ? "{\"%s\":\"%s\"," : "{\"%s\":%s,", name, value );
+		default:
+			return snprintf( text, size, "%s%c", value, app->format == TZ_FORMAT_TSV ? '\t' : ',' );
+	}
+}
+
+/*
+ * Whether a string can be written as is (inside quotes, for JSON).
+ */
+bool format_needs_escapes( tz_format_t format, const wchar_t* s )
+{
+	for( ; *s; s++ )
+	{
+		switch( format )
+		{
+			case TZ_FORMAT_CSV:
+				if( *s == L',' || *s == L'"' || *s == L'\n' || *s == L'\r' ) return true;
+				break;
+			case TZ_FORMAT_TSV:
+				if( *s == L'\t' || *s == L'\n' || *s == L'\r' || *s == L'\\' ) return true;
+				break;
+			case TZ_FORMAT_JSON:
+			case TZ_FORMAT_NDJSON:
+				if( *s == L'"' || *s == L'\\' || *s < 0x20 ) return true;
+				break;
+			default:
+				return false;
+		}
+	}
+
+	return false;
+}
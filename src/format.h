@@ -0,0 +1,39 @@
+/*
+ * Copyright (C) 2019-2025, Joe Marrero. http://www.joemarrero.com/
+ * Copyright (C) 2017, End Point Corporation. http://www.endpoint.com/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef _TZ_FORMAT_H_
+#define _TZ_FORMAT_H_
+
+#include <stdbool.h>
+#include <wchar.h>
+#include <collections/tree-map.h>
+#include "timezoner.h"
+#include "render.h"
+
+#define tz_format_separator(format)   ((format) == TZ_FORMAT_TSV ? L'\t' : L',')
+
+bool tz_format_parse          ( const char* s, tz_format_t* format );
+void tz_format_string         ( tz_render_t* render, tz_format_t format, const wchar_t* s );
+void tz_format_narrow_string  ( tz_render_t* render, tz_format_t format, const char* s );
+bool tz_format_groups         ( tz_render_t* render, const tz_app_t* app, lc_tree_map_t* map );
+
+#endif /* _TZ_FORMAT_H_ */
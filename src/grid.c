@@ -0,0 +1,284 @@
+/*
+ * Copyright (C) 2019-2025, Joe Marrero. http://www.joemarrero.com/
+ * Copyright (C) 2017, End Point Corporation. http://www.endpoint.com/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <wchar.h>
+#include <time.h>
+#include <xtd/console.h>
+#include <collections/tree-map.h>
+#include "timezoner.h"
+#include "grid.h"
+
+/*
+ * A zone at one instant, preformatted so that drawing a contact's row
+ * is just copying bytes.
+ */
+typedef struct grid_cell {
+	char text[ TZ_GRID_CELL_WIDTH ]; /* local time and the day relative to ours; not terminated */
+	short minute;                    /* minutes past local midnight, or -1 on weekends */
+} grid_cell_t;
+
+static bool grid_cells   ( const tz_app_t* app, const struct tm* ours, grid_cell_t* cells, long* utc_offsets );
+static void grid_header  ( tz_render_t* render, const tz_app_t* app, const struct tm* ours, int name_width );
+static void grid_contact ( tz_render_t* render, const tz_app_t* app, const timezone_contact_t* contact, const grid_cell_t* cells, int name_width );
+
+
+/*
+ * Draws the organized contacts with one column per -t instant, grouped
+ * as at the first one. Every zone is computed at all of the instants in
+ * one pass over its transitions before anything is drawn.
+ */
+bool tz_grid( tz_render_t* render, const tz_app_t* app, lc_tree_map_t* map )
+{
+	bool result = false;
+	size_t instant_count = app->instant_count;
+	size_t zone_count = tz_zone_cache_size( app->zones );
+	grid_cell_t* cells = malloc( sizeof(grid_cell_t) * (zone_count * instant_count + 1) );
+	long* utc_offsets = malloc( sizeof(long) * (zone_count + 1) ); /* at the first instant */
+	struct tm* ours = malloc( sizeof(struct tm) * instant_count );
+	int name_width = app->column_widths[ 0 ] < 10 ? 10 : app->column_widths[ 0 ];
+	size_t contact_count = 0;
+
+	struct timespec grid_start, grid_end;
+	clock_gettime( CLOCK_MONOTONIC, &grid_start );
+
+	if( !tz_check_alloc( app, cells ) || !tz_check_alloc( app, utc_offsets ) || !tz_check_alloc( app, ours ) )
+	{
+		goto done;
+	}
+
+	// The columns are headed by the instants in our own zone, like -t is given.
+	for( size_t i = 0; i < instant_count; i++ )
+	{
+		localtime_r( &app->instants[ i ], &ours[ i ] );
+	}
+
+	if( !grid_cells( app, ours, cells, utc_offsets ) )
+	{
+		goto done;
+	}
+
+	grid_header( render, app, ours, name_width );
+
+	for( lc_tree_map_iterator_t itr = lc_tree_map_begin( map );
+	     itr != lc_tree_map_end( );
+	     itr = lc_tree_map_next(itr) )
+	{
+		timezone_contact_t** list = itr->value;
+		size_t count = lc_vector_size( list );
+
+		if( count == 0 )
+		{
+			continue;
+		}
+
+		if( !app->minimal && app->organize_by_time )
+		{
+			// Zones a day apart share a group, so it's labeled with the
+			// local time like tz_display() does.
+			const tz_zone_t* zone = tz_zone_cache_resolve( app->zones, list[ 0 ]->zone );
+
+			tz_render_color( render, CONSOLE_COLOR8_BRIGHT_YELLOW );
+			tz_render_clock( render, zone, list[ 0 ]->zone, "%r", 0 );
+			tz_render_reset( render );
+			tz_render_text( render, L"\n" );
+		}
+		else if( !app->minimal )
+		{
+			char utc_offset_str[ 16 ];
+			snprintf( utc_offset_str, sizeof(utc_offset_str), "UTC%+05.1f", utc_offsets[ list[ 0 ]->zone ] / 3600.0 );
+
+			tz_render_color( render, CONSOLE_COLOR8_BRIGHT_MAGENTA );
+			tz_render_string( render, utc_offset_str, 0 );
+			tz_render_reset( render );
+			tz_render_text( render, L"\n" );
+		}
+
+		for( size_t i = 0; i < count; i++ )
+		{
+			grid_contact( render, app, list[ i ], &cells[ list[ i ]->zone * instant_count ], name_width );
+		}
+		tz_render_text( render, L"\n" );
+
+		contact_count += count;
+	}
+
+	clock_gettime( CLOCK_MONOTONIC, &grid_end );
+
+	if( app->stats )
+	{
+		fprintf( stderr, "Drew %zu contacts at %zu instants (%zu zones) in %.3f ms.\n",
+		         contact_count, instant_count, zone_count,
+		         (grid_end.tv_sec - grid_start.tv_sec) * 1000.0 + (grid_end.tv_nsec - grid_start.tv_nsec) / 1e6 );
+	}
+
+	result = true;
+
+done:
+	free( ours );
+	free( utc_offsets );
+	free( cells );
+	return result;
+}
+
+/*
+ * Fills in every zone's row of cells. A local time on another day than
+ * ours is marked +1 or -1.
+ */
+bool grid_cells( const tz_app_t* app, const struct tm* ours, grid_cell_t* cells, long* utc_offsets )
+{
+	size_t instant_count = app->instant_count;
+	size_t zone_count = tz_zone_cache_size( app->zones );
+	tz_zone_t* zones = malloc( sizeof(tz_zone_t) * instant_count );
+
+	if( !tz_check_alloc( app, zones ) )
+	{
+		return false;
+	}
+
+	for( tz_zone_id_t id = 0; id < zone_count; id++ )
+	{
+		grid_cell_t* row = &cells[ id * instant_count ];
+
+		tz_zone_cache_lookup_many( app->zones, id, app->instants, instant_count, zones );
+		utc_offsets[ id ] = zones[ 0 ].utc_offset;
+
+		for( size_t i = 0; i < instant_count; i++ )
+		{
+			const struct tm* tm = &zones[ i ].local_time;
+			const char* day = "  ";
+			char text[ 16 ];
+
+			if( tm->tm_year != ours[ i ].tm_year || tm->tm_yday != ours[ i ].tm_yday )
+			{
+				bool later = tm->tm_year != ours[ i ].tm_year ? tm->tm_year > ours[ i ].tm_year : tm->tm_yday > ours[ i ].tm_yday;
+				day = later ? "+1" : "-1";
+			}
+
+			snprintf( text, sizeof(text), "%02d:%02d%s      ", tm->tm_hour, tm->tm_min, day );
+			memcpy( row[ i ].text, text, TZ_GRID_CELL_WIDTH );
+
+			bool weekend = tm->tm_wday == 0 || tm->tm_wday == 6;
+			row[ i ].minute = weekend ? -1 : (short) (tm->tm_hour * 60 + tm->tm_min);
+		}
+	}
+
+	free( zones );
+	return true;
+}
+
+void grid_header( tz_render_t* render, const tz_app_t* app, const struct tm* ours, int name_width )
+{
+	size_t instant_count = app->instant_count;
+
+	// Dates are only shown where the day changes.
+	tz_render_repeat( render, L' ', name_width + 2 );
+	for( size_t i = 0; i < instant_count; i++ )
+	{
+		char date_str[ 32 ];
+
+		if( i > 0 && ours[ i ].tm_yday == ours[ i - 1 ].tm_yday && ours[ i ].tm_year == ours[ i - 1 ].tm_year )
+		{
+			tz_render_repeat( render, L' ', TZ_GRID_CELL_WIDTH );
+			continue;
+		}
+
+		if( strftime( date_str, sizeof(date_str), "%b %d", &ours[ i ] ) == 0 )
+		{
+			date_str[ 0 ] = '\0';
+		}
+		tz_render_string( render, date_str, TZ_GRID_CELL_WIDTH );
+	}
+	tz_render_text( render, L"\n" );
+
+	tz_render_repeat( render, L' ', name_width + 2 );
+	if( !app->minimal )
+	{
+		tz_render_color( render, CONSOLE_COLOR8_BRIGHT_YELLOW );
+	}
+	for( size_t i = 0; i < instant_count; i++ )
+	{
+		char time_str[ 16 ];
+		snprintf( time_str, sizeof(time_str), "%02d:%02d", ours[ i ].tm_hour, ours[ i ].tm_min );
+		tz_render_string( render, time_str, TZ_GRID_CELL_WIDTH );
+	}
+	tz_render_reset( render );
+	tz_render_text( render, L"\n" );
+
+	if( !app->minimal )
+	{
+		tz_render_repeat( render, L'\u2500', name_width + 2 + (int) instant_count * TZ_GRID_CELL_WIDTH );
+		tz_render_text( render, L"\n" );
+	}
+}
+
+/*
+ * Draws a contact's name and their local time at every instant. Times
+ * within the contact's working hours are highlighted.
+ */
+void grid_contact( tz_render_t* render, const tz_app_t* app, const timezone_contact_t* contact, const grid_cell_t* cells, int name_width )
+{
+	short start = contact->working_hours[ 0 ] >= 0 ? contact->working_hours[ 0 ] : app->working_hours[ 0 ];
+	short end   = contact->working_hours[ 1 ] >= 0 ? contact->working_hours[ 1 ] : app->working_hours[ 1 ];
+
+	if( !app->minimal )
+	{
+		tz_render_color( render, CONSOLE_COLOR8_BRIGHT_CYAN );
+	}
+	if( contact->name_width > name_width )
+	{
+		// truncated
+		tz_render_truncated( render, contact->name, name_width - 3 );
+		tz_render_text( render, L"...  " );
+	}
+	else
+	{
+		// fixed width
+		tz_render_field( render, contact->name, contact->name_width, name_width );
+		tz_render_text( render, L"  " );
+	}
+	tz_render_reset( render );
+
+	for( size_t i = 0; i < app->instant_count; i++ )
+	{
+		short minute = cells[ i ].minute;
+
+		// Hours that end before they start span midnight.
+		bool working = minute >= 0 && (start <= end ? minute >= start && minute < end : minute >= start || minute < end);
+
+		if( working && !app->minimal )
+		{
+			tz_render_color( render, CONSOLE_COLOR8_BRIGHT_GREEN );
+		}
+		else
+		{
+			tz_render_reset( render );
+		}
+		tz_render_bytes( render, cells[ i ].text, TZ_GRID_CELL_WIDTH );
+	}
+	tz_render_reset( render );
+	tz_render_text( render, L"\n" );
+}
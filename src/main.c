@@ -23,21 +23,33 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdarg.h>
 #include <string.h>
+#include <ctype.h>
 #include <wchar.h>
 #include <locale.h>
 #define __USE_XOPEN
 #include <time.h>
 #include <limits.h>
-#include <regex.h>
 #include <xtd/console.h>
 #include <xtd/filesystem.h>
 #include <xtd/string.h>
 #include <xtd/time.h>
-#define VECTOR_GROW_AMOUNT(array)      (1)
-#include <collections/vector.h>
 #include <collections/tree-map.h>
+#include "timezoner.h"
+#include "config.h"
+#include "daemon.h"
+#include "display.h"
+#include "format.h"
+#include "grid.h"
+#include "profile.h"
+#include "reload.h"
+#include "render.h"
+#include "slot.h"
+#include "store.h"
+#include "timeline.h"
+#include "watch.h"
 #if defined(_WIN32) || defined(_WIN64)
 # include <windows.h>
 #else
@@ -46,39 +58,8 @@
 #endif
 
 #define VERSION                 "1.2.2"
-#define CONFIGURATION_FILENAME  ".timezoner"
-
-typedef struct timezone_contact {
-	double utc_offset;
-	const char* timezone; /* IANA Timezone Code; https://en.wikipedia.org/wiki/List_of_tz_database_time_zones */
-	const wchar_t* email;
-	const wchar_t* name;
-	const wchar_t* office_phone;
-	const wchar_t* mobile_phone;
-} timezone_contact_t;
-
-typedef struct tz_app { /* App state */
-	bool minimal;
-	bool organize_by_time;
-	int column_widths[ 2 ];
-	time_t now;
-} tz_app_t;
 
 static void tz_about ( int argc, char* argv[] );
-static void tz_print_error ( const tz_app_t* app,  const char* format, ... );
-static void tz_organize_data ( const timezone_contact_t* contacts, lc_tree_map_t* map, time_t now, bool organize_by_time );
-static bool tz_read_configuration_from_home ( const tz_app_t* app, timezone_contact_t** contacts );
-static bool tz_configuration_read ( const tz_app_t* app, const char* configuration_name, timezone_contact_t** contacts );
-static bool tz_configuration_read_line ( const tz_app_t* app, char* line, int line_number, regex_t* regex, timezone_contact_t** contacts );
-static bool tz_configuration_write_default ( const char* configuration_filename );
-static void tz_display_time_grouping ( lc_tree_map_t* map, time_t now, int name_width, int email_width );
-static void tz_display_time_grouping_minimal ( lc_tree_map_t* map, time_t now, int name_width, int email_width );
-static void tz_display_utc_grouping ( lc_tree_map_t* map, time_t now );
-static void tz_display_utc_grouping_minimal ( lc_tree_map_t* map, time_t now );
-static bool timezone_map_element_destroy ( void *p_key, void *p_value );
-static int  timezone_map_compare ( const void *p_key_left, const void *p_key_right );
-static int  contact_name_compare ( const void *l, const void *r );
-static bool tz_check_alloc( const tz_app_t* app, void* mem );
 
 
 int main( int argc, char* argv[] )
@@ -86,10 +67,41 @@ int main( int argc, char* argv[] )
 	tz_app_t app = (tz_app_t) {
 		.minimal = false,
 		.organize_by_time = true, // this is the default
+		.stats = false,
+		.memory_map = false,
+		.parser = TZ_PARSER_FAST,
+		.format = TZ_FORMAT_TEXT,
+		.jobs = 1,
+		.watch_interval = 0,
+		.slot_days = 0,
+		.slot_minutes = 30,
+		.timeline_start = 0,
+		.timeline_end = 0,
+		.timeline_step = 0,
+		.working_hours = { 9 * 60, 17 * 60 },
 		.column_widths = { 30, 25 },
-		.now = time(NULL)
+		.now = time(NULL),
+		.instants = NULL,
+		.instant_count = 0,
+		.zones = NULL,
+		.strings = NULL,
+		.cache = NULL,
+		.query = NULL,
+		.load_stats = NULL,
+		.errors = NULL
 	};
-	const char* configuration_name = NULL;
+	const char* configuration_names[ argc ]; /* every -f, merged in order */
+	size_t configuration_count = 0;
+	int use_cache = -1; /* -1 to only cache the home configuration */
+	const char* timeline[ 3 ] = { NULL, NULL, NULL }; /* start, end and step */
+	time_t now = app.now;
+	time_t instants[ TZ_GRID_MAX_INSTANTS ]; /* every -t */
+	size_t instant_count = 0;
+	tz_query_t query = { 0 };
+	tz_profile_t profile_data;
+	tz_profile_t* profile = NULL; /* --profile */
+	char socket_name[ PATH_MAX ] = ""; /* --daemon */
+	bool daemon = false;
 
 	setlocale( LC_ALL, "" );
 
@@ -134,7 +146,7 @@ int main( int argc, char* argv[] )
 			{
 				if( (arg + 1) < argc )
 				{
-					configuration_name = argv[ arg + 1];
+					configuration_names[ configuration_count++ ] = argv[ arg + 1];
 				}
 				else
 				{
@@ -149,38 +161,107 @@ int main( int argc, char* argv[] )
 				{
 					string_trim( argv[ arg + 1 ], " \t\n" );
 
-					const char* formats[] = {
-						"%I:%M:%S %p", /* 01:35:10 PM */
-						"%I:%M %p",    /* 01:35 PM */
-						"%H:%M:%S",    /* 13:35:10  */
-						"%H:%M"        /* 13:35 */
-					};
-					size_t formats_len = sizeof(formats) / sizeof(formats[0]);
-					struct tm tm;
-					bool time_parsed = false;
-
-					/* Initialize with today's date and clear hours, minutes, seconds. */
-					localtime_r( &app.now, &tm );
-					tm.tm_sec  = 0;
-					tm.tm_min  = 0;
-					tm.tm_hour = 0;
-
-					for( int i = 0; !time_parsed && i < formats_len; i++ )
+					if( !tz_timeline_parse_times( argv[ arg + 1 ], now, instants, TZ_GRID_MAX_INSTANTS, &instant_count ) )
 					{
-						char* result = strptime( argv[ arg + 1], formats[ i ], &tm );
-						if( result && *result == '\0' )
+						if( instant_count == TZ_GRID_MAX_INSTANTS )
 						{
-							time_parsed = true;
+							tz_print_error( &app, "At most %d times can be shown\n", TZ_GRID_MAX_INSTANTS );
 						}
+						else
+						{
+							tz_print_error( &app, "Failed to match time for '%s'\n", argv[arg + 1] );
+						}
+						return -2;
+					}
+					app.now = instants[ 0 ];
+				}
+				else
+				{
+					tz_print_error( &app, "Missing parameter for option '%s'\n", argv[arg] );
+					return -2;
+				}
+				 arg += 1;
+			}
+			else if( strcmp( "-w", argv[arg] ) == 0 || strcmp( "--watch", argv[arg] ) == 0 )
+			{
+				app.watch_interval = 1;
+
+				if( (arg + 1) < argc && *argv[ arg + 1 ] != '-' )
+				{
+					app.watch_interval = atoi( argv[ arg + 1 ] );
+					arg += 1;
+
+					if( app.watch_interval <= 0 )
+					{
+						tz_print_error( &app, "Invalid watch interval '%s'\n", argv[arg] );
+						return -2;
 					}
+				}
+			}
+			else if( strcmp( "--find-slot", argv[arg] ) == 0 )
+			{
+				app.slot_days = 7;
+
+				if( (arg + 1) < argc && *argv[ arg + 1 ] != '-' )
+				{
+					app.slot_days = atoi( argv[ arg + 1 ] );
+					arg += 1;
 
-					if( time_parsed )
+					if( app.slot_days <= 0 || app.slot_days > 366 )
+					{
+						tz_print_error( &app, "Invalid number of days '%s'\n", argv[arg] );
+						return -2;
+					}
+				}
+			}
+			else if( strcmp( "--timeline", argv[arg] ) == 0 )
+			{
+				if( (arg + 3) < argc )
+				{
+					// Instants are parsed once -t has been seen.
+					timeline[ 0 ] = argv[ arg + 1 ];
+					timeline[ 1 ] = argv[ arg + 2 ];
+					timeline[ 2 ] = argv[ arg + 3 ];
+				}
+				else
+				{
+					tz_print_error( &app, "Missing parameters for option '%s'\n", argv[arg] );
+					return -2;
+				}
+				arg += 3;
+			}
+			else if( strcmp( "--format", argv[arg] ) == 0 )
+			{
+				if( (arg + 1) < argc )
+				{
+					if( !tz_format_parse( argv[ arg + 1 ], &app.format ) )
+					{
+						tz_print_error( &app, "Unrecognized format '%s'\n", argv[arg + 1] );
+						return -2;
+					}
+				}
+				else
+				{
+					tz_print_error( &app, "Missing parameter for option '%s'\n", argv[arg] );
+					return -2;
+				}
+				arg += 1;
+			}
+			else if( strcmp( "--where", argv[arg] ) == 0 )
+			{
+				if( (arg + 1) < argc )
+				{
+					if( !app.query && !tz_query_create( &query ) )
 					{
-						app.now = mktime( &tm );
+						tz_print_error( &app, "Out of memory.\n" );
+						return -2;
 					}
-					else
+					app.query = &query;
+
+					if( !tz_query_parse( &query, argv[ arg + 1 ] ) )
 					{
-						tz_print_error( &app, "Failed to match time for '%s'\n", argv[arg + 1] );
+						tz_print_error( &app, "Invalid filter '%s'\n", argv[arg + 1] );
+						tz_query_destroy( &query );
 						return -2;
 					}
 				}
@@ -189,7 +270,118 @@ int main( int argc, char* argv[] )
 					tz_print_error( &app, "Missing parameter for option '%s'\n", argv[arg] );
 					return -2;
 				}
-				 arg += 1;
+				arg += 1;
+			}
+			else if( strcmp( "--duration", argv[arg] ) == 0 )
+			{
+				if( (arg + 1) < argc )
+				{
+					app.slot_minutes = atoi( argv[ arg + 1 ] );
+
+					if( app.slot_minutes <= 0 || app.slot_minutes > 24 * 60 )
+					{
+						tz_print_error( &app, "Invalid duration '%s'\n", argv[arg + 1] );
+						return -2;
+					}
+				}
+				else
+				{
+					tz_print_error( &app, "Missing parameter for option '%s'\n", argv[arg] );
+					return -2;
+				}
+				arg += 1;
+			}
+			else if( strcmp( "--hours", argv[arg] ) == 0 )
+			{
+				if( (arg + 1) < argc )
+				{
+					if( !tz_slot_parse_hours( argv[ arg + 1 ], app.working_hours ) )
+					{
+						tz_print_error( &app, "Invalid working hours '%s'\n", argv[arg + 1] );
+						return -2;
+					}
+				}
+				else
+				{
+					tz_print_error( &app, "Missing parameter for option '%s'\n", argv[arg] );
+					return -2;
+				}
+				arg += 1;
+			}
+			else if( strcmp( "--stats", argv[arg] ) == 0 )
+			{
+				app.stats = true;
+			}
+			else if( strcmp( "--profile", argv[arg] ) == 0 )
+			{
+				profile = &profile_data;
+			}
+			else if( strcmp( "--mmap", argv[arg] ) == 0 )
+			{
+				app.memory_map = true;
+			}
+			else if( strcmp( "--cache", argv[arg] ) == 0 )
+			{
+				use_cache = 1;
+			}
+			else if( strcmp( "--no-cache", argv[arg] ) == 0 )
+			{
+				use_cache = 0;
+			}
+			else if( strcmp( "-j", argv[arg] ) == 0 || strcmp( "--jobs", argv[arg] ) == 0 )
+			{
+				if( (arg + 1) < argc )
+				{
+					app.jobs = atoi( argv[ arg + 1 ] );
+
+					if( app.jobs <= 0 || app.jobs > TZ_CONFIGURATION_MAX_JOBS )
+					{
+						tz_print_error( &app, "Invalid number of jobs '%s'\n", argv[arg + 1] );
+						return -2;
+					}
+				}
+				else
+				{
+					tz_print_error( &app, "Missing parameter for option '%s'\n", argv[arg] );
+					return -2;
+				}
+				arg += 1;
+			}
+			else if( strncmp( "--parser=", argv[arg], 9 ) == 0 )
+			{
+				const char* parser = argv[arg] + 9;
+
+				if( strcmp( "fast", parser ) == 0 )
+				{
+					app.parser = TZ_PARSER_FAST;
+				}
+				else if( strcmp( "regex", parser ) == 0 )
+				{
+					app.parser = TZ_PARSER_REGEX;
+				}
+				else
+				{
+					tz_print_error( &app, "Unrecognized parser '%s'\n", parser );
+					return -2;
+				}
+			}
+			else if( strcmp( "--daemon", argv[arg] ) == 0 || strcmp( "--client", argv[arg] ) == 0 )
+			{
+				bool client = strcmp( "--client", argv[arg] ) == 0;
+
+				tz_daemon_socket_name( socket_name, sizeof(socket_name) );
+				if( (arg + 1) < argc && *argv[ arg + 1 ] != '-' )
+				{
+					snprintf( socket_name, sizeof(socket_name), "%s", argv[ arg + 1 ] );
+					arg += 1;
+				}
+
+				if( client )
+				{
+					// The rest of the options are the daemon's to read.
+					return tz_daemon_query( &app, socket_name, argc - arg - 1, argv + arg + 1 );
+				}
+				daemon = true;
 			}
 			else if( strcmp( "-h", argv[arg] ) == 0 || strcmp( "--help", argv[arg] ) == 0 )
 			{
@@ -204,20 +396,109 @@ int main( int argc, char* argv[] )
 		} // for
 	} // if
 
+	if( timeline[ 0 ] )
+	{
+		if( !tz_timeline_parse_instant( timeline[ 0 ], app.now, &app.timeline_start ) ||
+		    !tz_timeline_parse_instant( timeline[ 1 ], app.now, &app.timeline_end ) ||
+		    app.timeline_end < app.timeline_start )
+		{
+			tz_print_error( &app, "Invalid timeline from '%s' to '%s'\n", timeline[ 0 ], timeline[ 1 ] );
+			return -2;
+		}
+
+		if( !tz_timeline_parse_step( timeline[ 2 ], &app.timeline_step ) )
+		{
+			tz_print_error( &app, "Invalid timeline step '%s'\n", timeline[ 2 ] );
+			return -2;
+		}
+	}
+
+	if( timeline[ 0 ] && app.format == TZ_FORMAT_JSON )
+	{
+		tz_print_error( &app, "A timeline is written as csv, tsv or ndjson\n" );
+		return -2;
+	}
+
+	if( app.watch_interval > 0 && app.format != TZ_FORMAT_TEXT )
+	{
+		tz_print_error( &app, "Watch mode only draws text\n" );
+		return -2;
+	}
+
+	if( instant_count > 1 )
+	{
+		// One column per time, side by side.
+		app.instants      = instants;
+		app.instant_count = instant_count;
+
+		if( app.format != TZ_FORMAT_TEXT || app.watch_interval > 0 || timeline[ 0 ] )
+		{
+			tz_print_error( &app, "Several times are only drawn as text, once\n" );
+			return -2;
+		}
+	}
+
+	if( daemon )
+	{
+		return tz_daemon( &app, socket_name, configuration_names, configuration_count, use_cache ) ? 0 : -2;
+	}
+
+	if( profile )
+	{
+		tz_profile_start( profile );
+	}
+	tz_profile_phase( profile, TZ_PROFILE_READ );
+
+	tz_zone_cache_t zones;
+	tz_zone_cache_create( &zones, app.now );
+	app.zones = &zones;
+
+	tz_arena_t strings;
+	tz_arena_create( &strings, TZ_ARENA_BLOCK_SIZE );
+	app.strings = &strings;
+
+	tz_load_stats_t load_stats = { 0 };
+	app.load_stats = &load_stats;
+
+	tz_cache_t cache = { 0 };
+	if( use_cache > 0 || (use_cache < 0 && configuration_count == 0) )
+	{
+		app.cache = &cache;
+	}
+
+	lc_tree_map_t map;
+	tz_organize_map_create( &map );
+
 	timezone_contact_t* contacts = NULL;
 	lc_vector_create( contacts, 1 );
 
+	tz_contact_store_t store;
+	bool store_created = false;
+
+	tz_render_t render;
+	bool render_created = false;
+
 	if( !tz_check_alloc(&app, contacts) )
 	{
 		goto done;
 	}
 
-	lc_tree_map_t map;
-	lc_tree_map_create( &map, timezone_map_element_destroy, timezone_map_compare, malloc, free );
+	if( app.watch_interval > 0 )
+	{
+		// The configuration is read again whenever it changes.
+		tz_reloader_t reloader;
+		if( tz_reloader_create( &reloader, &app, configuration_names, configuration_count, use_cache, false ) )
+		{
+			tz_profile_phase( profile, TZ_PROFILE_DISPLAY );
+			tz_watch( &app, &reloader, &map );
+			tz_reloader_destroy( &reloader );
+		}
+		goto done;
+	}
 
-	if( configuration_name )
+	if( configuration_count > 0 )
 	{
-		if( !tz_configuration_read( &app, configuration_name, &contacts ) )
+		if( !tz_configuration_load( &app, configuration_names, configuration_count, &contacts ) )
 		{
 			goto done;
 		}
@@ -227,47 +508,152 @@ int main( int argc, char* argv[] )
 		goto done;
 	}
 
-	tz_organize_data( contacts, &map, app.now, app.organize_by_time );
-
-	if( app.organize_by_time )
+	if( app.query )
 	{
-		if (app.minimal)
+		// Only the contacts that match are ever grouped or drawn.
+		timezone_contact_t* matching = NULL;
+		lc_vector_create( matching, lc_vector_size(contacts) + 1 );
+
+		if( !tz_check_alloc( &app, matching ) )
 		{
-			tz_display_time_grouping_minimal( &map, app.now, app.column_widths[0], app.column_widths[1] );
+			goto done;
 		}
-		else
+
+		// The trigram index comes with the compiled cache; building one
+		// costs more than a single scan, so without it every row is compared.
+		const tz_contact_index_t* index = cache.index.count > 0 ? &cache.index : NULL;
+		bool selected = tz_query_select( &query, index, &app, contacts, app.slot_days > 0, &matching );
+
+		// contact strings are owned by the arena or the cache, not the vector
+		lc_vector_destroy( contacts );
+		contacts = matching;
+
+		if( !selected )
 		{
-			tz_display_time_grouping( &map, app.now, app.column_widths[0], app.column_widths[1] );
+			tz_print_error( &app, "Out of memory.\n" );
+			goto done;
 		}
 	}
+
+	tz_profile_phase( profile, TZ_PROFILE_DISPLAY );
+
+	// The frame is written in one go; very large directories are
+	// flushed in chunks to bound memory.
+	render_created = tz_render_create( &render, stdout, 4 * 1024 * 1024 );
+	if( !tz_check_alloc( &app, render_created ? &render : NULL ) )
+	{
+		goto done;
+	}
+
+	if( app.slot_days > 0 )
+	{
+		tz_find_slots( &render, &app, contacts );
+		tz_render_flush( &render );
+		goto done;
+	}
+
+	if( app.timeline_step > 0 )
+	{
+		tz_timeline( &render, &app, contacts );
+		goto done;
+	}
+
+	tz_profile_phase( profile, TZ_PROFILE_ORGANIZE );
+
+	struct timespec organize_start, organize_end;
+	clock_gettime( CLOCK_MONOTONIC, &organize_start );
+
+	store_created = tz_contact_store_create( &store, contacts );
+	if( !tz_check_alloc( &app, store_created ? &store : NULL ) )
+	{
+		goto done;
+	}
+
+	if( !tz_organize_data( &store, &map, &zones, app.organize_by_time, app.query ) )
+	{
+		tz_print_error( &app, "Out of memory.\n" );
+		goto done;
+	}
+
+	clock_gettime( CLOCK_MONOTONIC, &organize_end );
+	size_t group_count = lc_tree_map_size( &map );
+
+	tz_profile_phase( profile, TZ_PROFILE_DISPLAY );
+
+	struct timespec render_start, render_end;
+	clock_gettime( CLOCK_MONOTONIC, &render_start );
+
+	if( app.instant_count > 1 )
+	{
+		tz_grid( &render, &app, &map );
+	}
 	else
 	{
-		if (app.minimal)
+		tz_display( &render, &app, &map );
+	}
+
+	tz_render_flush( &render );
+	clock_gettime( CLOCK_MONOTONIC, &render_end );
+	size_t bytes_rendered = render.bytes_written;
+
+	if( app.stats )
+	{
+		size_t allocations = strings.allocations + tz_zone_cache_size( &zones );
+
+		if( load_stats.cached )
 		{
-			tz_display_utc_grouping_minimal( &map, app.now );
+			fprintf( stderr, "Loaded %zu contacts from the cache (%zu bytes) in %.3f ms.\n",
+			         load_stats.contacts, load_stats.bytes, load_stats.seconds * 1000.0 );
 		}
 		else
 		{
-			tz_display_utc_grouping( &map, app.now );
+			fprintf( stderr, "Loaded %zu contacts from %zu lines (%zu bytes) in %.3f ms (%.1f MB/s).\n",
+			         load_stats.contacts, load_stats.lines, load_stats.bytes, load_stats.seconds * 1000.0,
+			         load_stats.seconds > 0.0 ? load_stats.bytes / load_stats.seconds / (1024.0 * 1024.0) : 0.0 );
+		}
+		fprintf( stderr, "String allocations: %zu (%.3f per contact).\n",
+		         allocations, load_stats.contacts > 0 ? (double) allocations / load_stats.contacts : 0.0 );
+		if( app.query )
+		{
+			fprintf( stderr, "Selected %zu of %zu contacts (%zu compared) in %.3f ms.\n",
+			         query.matches, load_stats.contacts, query.candidates, query.seconds * 1000.0 );
 		}
+		fprintf( stderr, "Organized %zu contacts into %zu groups in %.3f ms.\n",
+		         lc_vector_size(contacts), group_count,
+		         (organize_end.tv_sec - organize_start.tv_sec) * 1000.0 + (organize_end.tv_nsec - organize_start.tv_nsec) / 1e6 );
+		fprintf( stderr, "Rendered %zu bytes in %.3f ms.\n", bytes_rendered,
+		         (render_end.tv_sec - render_start.tv_sec) * 1000.0 + (render_end.tv_nsec - render_start.tv_nsec) / 1e6 );
+		fprintf( stderr, "Zone resolutions: %zu (%zu cache hits, %zu misses) across %zu zones.\n",
+		         zones.hits + zones.misses, zones.hits, zones.misses, tz_zone_cache_size( &zones ) );
 	}
 
 done:
+	tz_profile_phase( profile, TZ_PROFILE_TEARDOWN );
+
+	if( render_created )
+	{
+		tz_render_destroy( &render );
+	}
+
 	lc_tree_map_destroy( &map );
 
-	// free memory allocated for every contact
-	while( lc_vector_size(contacts) > 0 )
+	if( store_created )
 	{
-		timezone_contact_t* contact = &lc_vector_last(contacts);
-		free( (void*) contact->timezone );
-		free( (void*) contact->email );
-		free( (void*) contact->name );
-		free( (void*) contact->office_phone );
-		free( (void*) contact->mobile_phone );
-		lc_vector_pop(contacts);
+		tz_contact_store_destroy( &store );
 	}
 
+	// contact strings are all released with the arena, or the cache
 	lc_vector_destroy( contacts );
+	tz_arena_destroy( &strings );
+	tz_cache_close( &cache );
+	tz_query_destroy( &query );
+	tz_zone_cache_destroy( &zones );
+
+	if( profile )
+	{
+		tz_profile_stop( profile );
+		tz_profile_print( profile, stderr );
+	}
 	return 0;
 }
 
@@ -304,1051 +690,54 @@ void tz_about( int argc, char* argv[] )
 
 
 	printf( "Command Line Options:\n" );
-	printf( "    %-2s, %-20s  %-50s\n", "-f", "--file", "Use a specific configuration file." );
-	printf( "    %-2s, %-20s  %-50s\n", "-t", "--time", "Use a specific time." );
+	printf( "    %-2s, %-20s  %-50s\n", "-f", "--file", "Use a specific configuration file. Repeat it to merge several; later files win for the same email." );
+	printf( "    %-2s, %-20s  %-50s\n", "-t", "--time", "Use a specific time, e.g. 1:35 PM, +3h or \"tomorrow 9am\". Repeat it, or give a" );
+	printf( "    %-2s  %-20s  %-50s\n", "", "", "range such as 09:00..17:00/30m (hourly by default), to see every time side by side." );
 	printf( "    %-2s, %-20s  %-50s\n", "-T", "--group-time", "Group contacts by time. Two optional arguments for the column widths is possible." );
 	printf( "    %-2s, %-20s  %-50s\n", "-U", "--group-utc-offset", "Group contacts by UTC offset." );
 	printf( "    %-2s, %-20s  %-50s\n", "-m", "--minimal", "Use minimal formatting." );
+	printf( "    %-2s, %-20s  %-50s\n", "-w", "--watch", "Keep redrawing the clocks. An optional argument is the interval in seconds (default is 1)." );
+	printf( "    %-2s  %-20s  %-50s\n", "", "--find-slot", "Find the best meeting slots. An optional argument is the number of days to search (default is 7)." );
+	printf( "    %-2s  %-20s  %-50s\n", "", "--duration", "Length of the meeting in minutes (default is 30)." );
+	printf( "    %-2s  %-20s  %-50s\n", "", "--hours", "Default working hours, Monday to Friday, as HH:MM-HH:MM (default is 09:00-17:00)." );
+	printf( "    %-2s  %-20s  %-50s\n", "", "--timeline", "Export every contact at each instant from START to END (inclusive) by STEP, e.g. 2025-03-01 2025-04-01 1h." );
+	printf( "    %-2s  %-20s  %-50s\n", "", "--format", "Write text (default), json, ndjson, csv or tsv for scripts. A timeline is csv by default." );
+	printf( "    %-2s  %-20s  %-50s\n", "", "--where", "Only show the contacts matching every kind of term, e.g. \"zone=Europe/* hour=9..17 name~kidd\"." );
+	printf( "    %-2s  %-20s  %-50s\n", "", "", "Terms are zone=GLOB, offset=HOURS[..HOURS], hour=H[:MM]..H[:MM], name~TEXT, email~TEXT or TEXT." );
+	printf( "    %-2s  %-20s  %-50s\n", "", "--daemon", "Keep the contacts loaded and answer --client queries on a Unix socket, rereading the configuration when it changes." );
+	printf( "    %-2s  %-20s  %-50s\n", "", "--client", "Ask the daemon, passing it the -t, -T, -U, -m, --where and --format options that follow." );
+	printf( "    %-2s  %-20s  %-50s\n", "", "", "Both take an optional socket in a directory only you can use (default is $XDG_RUNTIME_DIR/timezoner.sock)." );
+	printf( "    %-2s  %-20s  %-50s\n", "", "--stats", "Print zone resolution statistics to stderr." );
+	printf( "    %-2s  %-20s  %-50s\n", "", "--profile", "Print the time, allocations, zone computations and output of each phase to stderr." );
+	printf( "    %-2s  %-20s  %-50s\n", "", "--mmap", "Memory map the configuration and parse it in place." );
+	printf( "    %-2s  %-20s  %-50s\n", "", "--cache", "Keep a compiled copy of the configuration next to it (default for the home configuration)." );
+	printf( "    %-2s  %-20s  %-50s\n", "", "--no-cache", "Always parse the configuration." );
+	printf( "    %-2s, %-20s  %-50s\n", "-j", "--jobs", "Parse the configuration with this many threads (implies --mmap)." );
+	printf( "    %-2s  %-20s  %-50s\n", "", "--parser=regex|fast", "Select the configuration parser (default is fast)." );
 	printf( "\n" );
 }
 
 void tz_print_error(const tz_app_t* app,  const char* format, ... )
 {
+	FILE* stream = app->errors ? app->errors : stderr;
 	va_list args;
 	va_start(args, format);
 
 	if (app->minimal)
 	{
-		fprintf( stderr, "ERROR: " );
+		fprintf( stream, "ERROR: " );
 	}
 	else
 	{
-		console_fg_color_8( stderr, CONSOLE_COLOR8_RED );
-		fprintf( stderr, "ERROR: " );
-		console_reset( stderr );
+		console_fg_color_8( stream, CONSOLE_COLOR8_RED );
+		fprintf( stream, "ERROR: " );
+		console_reset( stream );
 	}
 
-	vfprintf( stderr, format, args );
+	vfprintf( stream, format, args );
 	va_end(args);
 }
 
-void tz_organize_data( const timezone_contact_t* contacts, lc_tree_map_t* map, time_t now, bool organize_by_time )
-{
-	// Group all contacts by timezone...
-	for( int i = 0; i < lc_vector_size(contacts); i++ )
-	{
-		const timezone_contact_t* contact = &contacts[ i ];
-
-		struct tm* tz_time = time_local( now, contact->timezone );
-		char group_key[ 32 ];
-
-		if( organize_by_time )
-		{
-			strftime(group_key, sizeof(group_key), "%T" /* %T for 24-hour time */, tz_time );
-		}
-		else
-		{
-			snprintf(group_key, sizeof(group_key), "%+05.1f", contact->utc_offset );
-		}
-
-		lc_tree_map_iterator_t itr = lc_tree_map_find( map, group_key );
-
-		if( itr != lc_tree_map_end() )
-		{
-			timezone_contact_t const ** list = itr->value;
-			lc_vector_push( list, contact );
-
-			/* list is relocatable in memory as vector grows. */
-			itr->value = list;
-		}
-		else
-		{
-			timezone_contact_t const ** list = NULL;
-			lc_vector_create(list, 1);
-			lc_vector_push(list, contact);
-			lc_tree_map_insert( map, string_dup(group_key), list );
-		}
-	}
-
-	// sort each list by contact's name.
-	for( lc_tree_map_iterator_t itr = lc_tree_map_begin( map );
-	     itr != lc_tree_map_end( );
-	     itr = lc_tree_map_next(itr) )
-	{
-		timezone_contact_t** list = itr->value;
-		size_t count = lc_vector_size(list);
-		qsort( list, count, sizeof(timezone_contact_t*), contact_name_compare );
-	}
-}
-
-void tz_display_time_grouping ( lc_tree_map_t* map, time_t now, int name_width, int email_width )
-{
-	if( name_width < 10 )
-	{
-		name_width = 10;
-	}
-
-	if( email_width < 10 )
-	{
-		email_width = 10;
-	}
-
-	if( lc_tree_map_size( map ) == 0 )
-	{
-		return;
-	}
-
-	bool first = true;
-
-	for( lc_tree_map_iterator_t itr = lc_tree_map_begin( map );
-	     itr != lc_tree_map_end( );
-	     itr = lc_tree_map_next(itr) )
-	{
-		timezone_contact_t** list = itr->value;
-
-		if( first )
-		{
-			wprintf( L"\u250c\u2500\u2500\u2524 " );
-		}
-		else
-		{
-			wprintf( L"\u251c\u2500\u2500\u2524 " );
-		}
-		wconsole_fg_color_8( stdout, CONSOLE_COLOR8_BRIGHT_YELLOW);
-
-
-		struct tm* tz_time = time_local( now, list[0]->timezone );
-		char time_str[ 32 ];
-		strftime(time_str, sizeof(time_str), "%r" /* %T for 24-hour time */, tz_time );
-
-		wprintf( L"%s", time_str );
-		wconsole_reset( stdout );
-
-		wprintf( L" \u251c" );
-		int count = 35 + name_width + email_width;
-		while( count-- > 0 )
-		{
-			wprintf( L"\u2500" );
-		}
-		if( first )
-		{
-			wprintf( L"\u2510\n" );
-			first = false;
-		}
-		else
-		{
-			wprintf( L"\u2524\n" );
-		}
-
-		for( int i = 0; i < lc_vector_size(list); i++ )
-		{
-			timezone_contact_t* contact = list[ i ];
-
-			wprintf( L"\u2502 " );
-
-			wconsole_fg_color_8( stdout, CONSOLE_COLOR8_BRIGHT_CYAN);
-			if( wcslen(contact->name) > name_width)
-			{
-				// truncated
-				wprintf( L"%-.*ls...  ", name_width - 3, contact->name );
-			}
-			else
-			{
-				// fixed width
-				wprintf( L"%-*ls  ", name_width, contact->name );
-			}
-			wconsole_reset( stdout );
-
-			wconsole_fg_color_8( stdout, CONSOLE_COLOR8_GREY_15);
-			if( wcslen(contact->email) > email_width)
-			{
-				// truncated
-				wprintf( L"%lc %-.*ls...  ", (wchar_t) 0x2709, email_width - 3, contact->email );
-			}
-			else
-			{
-				// fixed width
-				wprintf( L"%lc %-*ls  ", (wchar_t) 0x2709, email_width, contact->email );
-			}
-			wconsole_reset( stdout );
-
-			wconsole_fg_color_8( stdout, CONSOLE_COLOR8_GREY_15);
-			if( wcslen(contact->office_phone) > 19)
-			{
-				// truncated
-				wprintf( L"%lc  %-.*ls... ", (wchar_t) 0x260e, 16, contact->office_phone );
-			}
-			else
-			{
-				// fixed width
-				wprintf( L"%lc  %-*ls ", (wchar_t) 0x260e, 19, contact->office_phone );
-			}
-			wconsole_reset( stdout );
-
-			wconsole_fg_color_8( stdout, CONSOLE_COLOR8_GREY_15);
-			if( wcslen(contact->mobile_phone) > 19)
-			{
-				// truncated
-				wprintf( L"%lc%-.*ls... ", (wchar_t) 0x1f4f1, 16, contact->mobile_phone );
-			}
-			else
-			{
-				// fixed width
-				wprintf( L"%lc%-*ls ", (wchar_t) 0x1f4f1, 19, contact->mobile_phone );
-			}
-			wconsole_reset( stdout );
-
-			wprintf( L"\u2502\n" );
-		} // for
-	} // for
-
-
-	wprintf( L"\u2514" );
-	int count = 52 + name_width + email_width;
-	while( count-- > 0 )
-	{
-		wprintf( L"\u2500" );
-	}
-	wprintf( L"\u2518\n" );
-}
-
-
-void tz_display_time_grouping_minimal( lc_tree_map_t* map, time_t now, int name_width, int email_width )
-{
-	if( name_width < 10 )
-	{
-		name_width = 10;
-	}
-
-	if( email_width < 10 )
-	{
-		email_width = 10;
-	}
-
-	if( lc_tree_map_size( map ) == 0 )
-	{
-		return;
-	}
-
-	for( lc_tree_map_iterator_t itr = lc_tree_map_begin( map );
-	     itr != lc_tree_map_end( );
-	     itr = lc_tree_map_next(itr) )
-	{
-		timezone_contact_t** list = itr->value;
-
-
-		struct tm* tz_time = time_local( now, list[0]->timezone );
-		char time_str[ 32 ];
-		strftime(time_str, sizeof(time_str), "%r" /* %T for 24-hour time */, tz_time );
-
-		wprintf( L"%s\n", time_str );
-
-		for( int i = 0; i < lc_vector_size(list); i++ ) // for each contact...
-		{
-			timezone_contact_t* contact = list[ i ];
-
-			if( wcslen(contact->name) > name_width)
-			{
-				// truncated
-				wprintf( L"%-.*ls...  ", name_width - 3, contact->name );
-			}
-			else
-			{
-				// fixed width
-				wprintf( L"%-*ls  ", name_width, contact->name );
-			}
-
-			if( wcslen(contact->email) > email_width)
-			{
-				// truncated
-				wprintf( L" %-.*ls...  ", email_width - 3, contact->email );
-			}
-			else
-			{
-				// fixed width
-				wprintf( L" %-*ls  ", email_width, contact->email );
-			}
-
-			if( wcslen(contact->office_phone) > 19)
-			{
-				// truncated
-				wprintf( L" %-.*ls... ", 16, contact->office_phone );
-			}
-			else
-			{
-				// fixed width
-				wprintf( L"  %-*ls ", 19, contact->office_phone );
-			}
-
-			if( wcslen(contact->mobile_phone) > 19)
-			{
-				// truncated
-				wprintf( L"%-.*ls... ", 16, contact->mobile_phone );
-			}
-			else
-			{
-				// fixed width
-				wprintf( L"%-*ls ", 19, contact->mobile_phone );
-			}
-
-			wprintf(L"\n");
-		} // for
-
-		wprintf(L"\n");
-	} // for
-}
-
-
-void tz_display_utc_grouping( lc_tree_map_t* map, time_t now )
-{
-	if( lc_tree_map_size( map ) == 0 )
-	{
-		return;
-	}
-
-	lc_tree_map_iterator_t last_node = lc_tree_map_node_maximum( lc_tree_map_root(map) );
-
-	// start of headers
-	{
-		wprintf( L"\u250c" );
-		for( lc_tree_map_iterator_t itr = lc_tree_map_begin( map );
-		     itr != lc_tree_map_end( );
-		     itr = lc_tree_map_next(itr) )
-		{
-			int column_width = 25;
-			while( column_width-- > 0 )
-			{
-				wprintf( L"\u2500" );
-			}
-
-			if( itr == last_node )
-			{
-				wprintf( L"\u2510" );
-			}
-			else
-			{
-				wprintf( L"\u252c" );
-			}
-
-		} // for
-		wprintf( L"\n" );
-
-		wprintf( L"\u2502" );
-		for( lc_tree_map_iterator_t itr = lc_tree_map_begin( map );
-		     itr != lc_tree_map_end( );
-		     itr = lc_tree_map_next(itr) )
-		{
-			wconsole_fg_color_8( stdout, CONSOLE_COLOR8_BRIGHT_MAGENTA );
-			wprintf( L"        UTC%s         ", (const char*) itr->key );
-			wconsole_reset( stdout );
-			wprintf( L"\u2502" );
-		} // for
-		wprintf( L"\n" );
-
-		wprintf( L"\u251c" );
-		for( lc_tree_map_iterator_t itr = lc_tree_map_begin( map );
-		     itr != lc_tree_map_end( );
-		     itr = lc_tree_map_next(itr) )
-		{
-			int column_width = 25;
-			while( column_width-- > 0 )
-			{
-				wprintf( L"\u2500" );
-			}
-
-			if( itr == last_node )
-			{
-				wprintf( L"\u2524" );
-			}
-			else
-			{
-				wprintf( L"\u253c" );
-			}
-
-		} // for
-		wprintf( L"\n" );
-
-
-	} // end of headers
-
-
-	int timezone_count = lc_tree_map_size( map );
-
-	while( timezone_count > 0 )
-	{
-		wprintf( L"\u2502" );
-		for( lc_tree_map_iterator_t itr = lc_tree_map_begin( map );
-		     itr != lc_tree_map_end( );
-		     itr = lc_tree_map_next(itr) )
-		{
-			timezone_contact_t** list = itr->value;
-			if( list && lc_vector_size(list) > 0)
-			{
-				timezone_contact_t* contact = lc_vector_last(list);
-
-				wconsole_fg_color_8( stdout, CONSOLE_COLOR8_BRIGHT_CYAN);
-				if( wcslen(contact->name) > 23)
-				{
-					// truncated
-					wprintf( L" %-.*ls... ", 20, contact->name );
-				}
-				else
-				{
-					// fixed width
-					wprintf( L" %-*ls ", 23, contact->name );
-				}
-				wconsole_reset( stdout );
-			}
-			else
-			{
-				wprintf( L" %-23s ", "" );
-			}
-			wprintf( L"\u2502" );
-		} // for
-		wprintf( L"\n" );
-
-		wprintf( L"\u2502" );
-		for( lc_tree_map_iterator_t itr = lc_tree_map_begin( map );
-		     itr != lc_tree_map_end( );
-		     itr = lc_tree_map_next(itr) )
-		{
-			timezone_contact_t** list = itr->value;
-
-			if( list && lc_vector_size(list) > 0)
-			{
-				timezone_contact_t* contact = lc_vector_last(list);
-
-				struct tm* tz_time = time_local( now, contact->timezone );
-
-				char time_str[12];
-				strftime(time_str, sizeof(time_str), "%I:%M:%S %p", tz_time);
-				time_str[ sizeof(time_str) - 1 ] = '\0';
-
-				wconsole_fg_color_8( stdout, CONSOLE_COLOR8_BRIGHT_YELLOW);
-				wprintf( L"  \u23f0 %-*s ", 19, time_str );
-				wconsole_reset( stdout );
-			}
-			else
-			{
-				wprintf( L"%-24s ", "" );
-			}
-			wprintf( L"\u2502" );
-		} // for
-		wprintf( L"\n" );
-
-		wprintf( L"\u2502" );
-		for( lc_tree_map_iterator_t itr = lc_tree_map_begin( map );
-		     itr != lc_tree_map_end( );
-		     itr = lc_tree_map_next(itr) )
-		{
-			timezone_contact_t** list = itr->value;
-			if( list && lc_vector_size(list) > 0)
-			{
-				timezone_contact_t* contact = lc_vector_last(list);
-
-				wconsole_fg_color_8( stdout, CONSOLE_COLOR8_GREY_15);
-
-				if( wcslen(contact->email) > 20)
-				{
-					// truncated
-					wprintf( L"  %lc %-.*ls... ", (wchar_t) 0x2709, 17, contact->email );
-				}
-				else
-				{
-					// fixed width
-					wprintf( L"  %lc %-*ls ", (wchar_t) 0x2709, 20, contact->email );
-				}
-				wconsole_reset( stdout );
-			}
-			else
-			{
-				wprintf( L"%-24s ", "" );
-			}
-			wprintf( L"\u2502" );
-		} // for
-		wprintf( L"\n" );
-
-		wprintf( L"\u2502" );
-		for( lc_tree_map_iterator_t itr = lc_tree_map_begin( map );
-		     itr != lc_tree_map_end( );
-		     itr = lc_tree_map_next(itr) )
-		{
-			timezone_contact_t** list = itr->value;
-			if( list && lc_vector_size(list) > 0)
-			{
-				timezone_contact_t* contact = lc_vector_last(list);
-
-				wconsole_fg_color_8( stdout, CONSOLE_COLOR8_GREY_15);
-				if( wcslen(contact->office_phone) > 17)
-				{
-					// truncated
-					wprintf( L"  \u260E  %-.*ls... ", 17, contact->office_phone );
-				}
-				else
-				{
-					// fixed width
-					wprintf( L"  \u260E  %-*ls ", 19, contact->office_phone );
-				}
-				wconsole_reset( stdout );
-			}
-			else
-			{
-				wprintf( L"%-24s ", "" );
-			}
-
-			wprintf( L"\u2502" );
-		} // for
-		wprintf( L"\n" );
-
-		wprintf( L"\u2502" );
-		for( lc_tree_map_iterator_t itr = lc_tree_map_begin( map );
-		     itr != lc_tree_map_end( );
-		     itr = lc_tree_map_next(itr) )
-		{
-			timezone_contact_t** list = itr->value;
-			if( list && lc_vector_size(list) > 0)
-			{
-				timezone_contact_t* contact = lc_vector_last(list);
-
-				wconsole_fg_color_8( stdout, CONSOLE_COLOR8_GREY_15);
-				if( wcslen(contact->mobile_phone) > 17)
-				{
-					// truncated
-					wprintf( L"   %lc%-.*ls ", (wchar_t) 0x1f4f1, 17, contact->mobile_phone );
-				}
-				else
-				{
-					// fixed width
-					wprintf( L"   %lc%-*ls ", (wchar_t) 0x1f4f1, 19, contact->mobile_phone );
-				}
-				wconsole_reset( stdout );
-				wprintf( L"\u2502" );
-			}
-			else
-			{
-				wprintf( L"%-24s ", "" );
-				wprintf( L"\u2502" );
-			}
-		} // for
-		wprintf( L"\n" );
-
-
-
-		for( lc_tree_map_iterator_t itr = lc_tree_map_begin( map );
-		     itr != lc_tree_map_end( );
-		     itr = lc_tree_map_next(itr) )
-		{
-			timezone_contact_t** list = itr->value;
-
-			if( list )
-			{
-				if(lc_vector_size(list) > 0)
-				{
-					lc_vector_pop(list);
-				}
-
-				if( lc_vector_size(list) == 0 )
-				{
-					lc_vector_destroy(list);
-					itr->value = NULL;
-					timezone_count--;
-				}
-			}
-		} // for
-	} // while
-
-
-	// start of footer
-	{
-		wprintf( L"\u2514" );
-		for( lc_tree_map_iterator_t itr = lc_tree_map_begin( map );
-		     itr != lc_tree_map_end( );
-		     itr = lc_tree_map_next(itr) )
-		{
-			int column_width = 25;
-			while( column_width-- > 0 )
-			{
-				wprintf( L"\u2500" );
-			}
-
-			if( itr == last_node )
-			{
-				wprintf( L"\u2518" );
-			}
-			else
-			{
-				wprintf( L"\u2534" );
-			}
-
-		} // for
-		wprintf( L"\n" );
-	} // end of footer
-
-	lc_tree_map_clear( map );
-}
-
-
-void tz_display_utc_grouping_minimal( lc_tree_map_t* map, time_t now )
-{
-	if( lc_tree_map_size( map ) == 0 )
-	{
-		return;
-	}
-
-	// start of headers
-	{
-		for( lc_tree_map_iterator_t itr = lc_tree_map_begin( map );
-		     itr != lc_tree_map_end( );
-		     itr = lc_tree_map_next(itr) )
-		{
-			wprintf( L"UTC%-5s                ", (const char*) itr->key );
-		} // for
-		wprintf( L"\n\n" );
-
-	} // end of headers
-
-
-	int timezone_count = lc_tree_map_size( map );
-
-	while( timezone_count > 0 )
-	{
-		for( lc_tree_map_iterator_t itr = lc_tree_map_begin( map );
-		     itr != lc_tree_map_end( );
-		     itr = lc_tree_map_next(itr) )
-		{
-			timezone_contact_t** list = itr->value;
-			if( list && lc_vector_size(list) > 0)
-			{
-				timezone_contact_t* contact = lc_vector_last(list);
-
-				if( wcslen(contact->name) > 20)
-				{
-					// truncated
-					wprintf( L"%-.*ls... ", 20, contact->name );
-				}
-				else
-				{
-					// fixed width
-					wprintf( L"%-*ls", 24, contact->name );
-				}
-			}
-			else
-			{
-				wprintf( L"%-24s", "" );
-			}
-		} // for
-		wprintf( L"\n" );
-
-		for( lc_tree_map_iterator_t itr = lc_tree_map_begin( map );
-		     itr != lc_tree_map_end( );
-		     itr = lc_tree_map_next(itr) )
-		{
-			timezone_contact_t** list = itr->value;
-
-			if( list && lc_vector_size(list) > 0)
-			{
-				timezone_contact_t* contact = lc_vector_last(list);
-
-				struct tm* tz_time = time_local( now, contact->timezone );
-
-				char time_str[12];
-				strftime(time_str, sizeof(time_str), "%I:%M:%S %p", tz_time);
-				time_str[ sizeof(time_str) - 1 ] = '\0';
-
-				wprintf( L"  %-*s", 22, time_str );
-			}
-			else
-			{
-				wprintf( L"%-24s", "" );
-			}
-		} // for
-		wprintf( L"\n" );
-
-		for( lc_tree_map_iterator_t itr = lc_tree_map_begin( map );
-		     itr != lc_tree_map_end( );
-		     itr = lc_tree_map_next(itr) )
-		{
-			timezone_contact_t** list = itr->value;
-			if( list && lc_vector_size(list) > 0)
-			{
-				timezone_contact_t* contact = lc_vector_last(list);
-
-				if( wcslen(contact->email) > 19)
-				{
-					// truncated
-					wprintf( L"  %-.*ls...", 19, contact->email );
-				}
-				else
-				{
-					// fixed width
-					wprintf( L"  %-*ls", 22, contact->email );
-				}
-			}
-			else
-			{
-				wprintf( L"%-24s", "" );
-			}
-		} // for
-		wprintf( L"\n" );
-
-		for( lc_tree_map_iterator_t itr = lc_tree_map_begin( map );
-		     itr != lc_tree_map_end( );
-		     itr = lc_tree_map_next(itr) )
-		{
-			timezone_contact_t** list = itr->value;
-			if( list && lc_vector_size(list) > 0)
-			{
-				timezone_contact_t* contact = lc_vector_last(list);
-
-				if( wcslen(contact->office_phone) > 19)
-				{
-					// truncated
-					wprintf( L"  %-.*ls...", 19, contact->office_phone );
-				}
-				else
-				{
-					// fixed width
-					wprintf( L"  %-*ls", 22, contact->office_phone );
-				}
-			}
-			else
-			{
-				wprintf( L"%-24s", "" );
-			}
-
-		} // for
-		wprintf( L"\n" );
-
-		for( lc_tree_map_iterator_t itr = lc_tree_map_begin( map );
-		     itr != lc_tree_map_end( );
-		     itr = lc_tree_map_next(itr) )
-		{
-			timezone_contact_t** list = itr->value;
-			if( list && lc_vector_size(list) > 0)
-			{
-				timezone_contact_t* contact = lc_vector_last(list);
-
-				if( wcslen(contact->mobile_phone) > 19)
-				{
-					// truncated
-					wprintf( L"  %-.*ls", 19, contact->mobile_phone );
-				}
-				else
-				{
-					// fixed width
-					wprintf( L"  %-*ls", 22, contact->mobile_phone );
-				}
-			}
-			else
-			{
-				wprintf( L"%-24s", "" );
-			}
-		} // for
-		wprintf( L"\n\n" );
-
-
-
-		for( lc_tree_map_iterator_t itr = lc_tree_map_begin( map );
-		     itr != lc_tree_map_end( );
-		     itr = lc_tree_map_next(itr) )
-		{
-			timezone_contact_t** list = itr->value;
-
-			if( list )
-			{
-				if(lc_vector_size(list) > 0)
-				{
-					lc_vector_pop(list);
-				}
-
-				if( lc_vector_size(list) == 0 )
-				{
-					lc_vector_destroy(list);
-					itr->value = NULL;
-					timezone_count--;
-				}
-			}
-		} // for
-	} // while
-
-
-	lc_tree_map_clear( map );
-}
-
-
-
-
-bool tz_read_configuration_from_home( const tz_app_t* app, timezone_contact_t** contacts )
-{
-	bool result = true;
-	struct passwd *pw = getpwuid(getuid());
-	const char *homedir = pw->pw_dir;
-
-	char configuration_filename[ PATH_MAX ];
-	snprintf( configuration_filename, sizeof(configuration_filename), "%s/%s", homedir, CONFIGURATION_FILENAME );
-	configuration_filename[ sizeof(configuration_filename) - 1 ] = '\0';
-
-	if( file_exists( configuration_filename ) )
-	{
-		if( !tz_configuration_read( app, configuration_filename, contacts ) )
-		{
-			tz_print_error( app, "Unable to read configuration at '%s'\n", configuration_filename );
-			result = false;
-			goto done;
-		}
-	}
-	else
-	{
-		if( !tz_configuration_write_default( configuration_filename ) )
-		{
-			tz_print_error( app, "Failed to create '%s'.\n", configuration_filename );
-			result = false;
-			goto done;
-		}
-
-		result = tz_read_configuration_from_home( app, contacts );
-	}
-
-done:
-	return result;
-}
-
-bool tz_configuration_read( const tz_app_t* app, const char* configuration_name, timezone_contact_t** contacts )
-{
-	bool result = false;
-	FILE* config = fopen( configuration_name, "r" );
-
-	if( config )
-	{
-#ifdef __APPLE__
-		const char* CONFIG_LINE_REGEX = "([[:alpha:]]+/?[[:alnum:]_]+)" /* group 1: timezone code */
-		                                "[[:space:]]+"
-                                        "\"(.*)\"" /* group 2: email */
-		                                "[[:space:]]+"
-		                                "\"(.*)\"" /* group 3: name */
-		                                "[[:space:]]+"
-		                                "\"(.*)\"" /* group 4: office number */
-		                                "[[:space:]]+"
-		                                "\"(.*)\""; /* group 5: mobile number */
-#else // Linux and MinGW
-		const char* CONFIG_LINE_REGEX = "([[:alpha:]]+?/?[[:alnum:]_]+)" /* group 1: timezone code */
-		                                "[[:space:]]+"
-		                                "\"(.*)\"" /* group 2: email */
-		                                "[[:space:]]+"
-		                                "\"(.*)\"" /* group 3: name */
-		                                "[[:space:]]+"
-		                                "\"(.*)\"" /* group 4: office number */
-		                                "[[:space:]]+"
-		                                "\"(.*)\""; /* group 5: mobile number */
-#endif
-		regex_t regex;
-		int regex_comp_result = regcomp( &regex, CONFIG_LINE_REGEX, REG_EXTENDED | REG_ICASE);
-
-		if( regex_comp_result )
-		{
-			char error[256];
-			regerror(regex_comp_result, &regex, error, sizeof(error));
-			tz_print_error( app, "Unable to compile regular expression.\nProblem: %s\n", error );
-			result = false;
-		}
-		else
-		{
-			char line[ 256 ];
-			int line_number = 1;
-
-			while( !feof(config) )
-			{
-				if( fgets( line, sizeof(line), config ) )
-				{
-					if( strchr(line, '\n') == NULL )
-					{
-						// Check for lines longer than we can support.
-						tz_print_error( app, "Line exceeds maximum possible length of %zu.\n", sizeof(line) );
-
-						result = false;
-						goto cleanup;
-					}
-
-					string_trim( line, " \t\r\n" );
-
-					if( !tz_configuration_read_line(app, line, line_number, &regex, contacts ) )
-					{
-						result = false;
-						goto cleanup;
-					}
-
-					line_number += 1;
-				} // if line
-			} // while !eof
-
-			result = true;
-		} // if regex_comp_result
-
-		cleanup: {
-			regfree( &regex );
-			fclose( config );
-		} // cleanup
-	}// if config
-
-	return result;
-}
-
-bool tz_configuration_read_line( const tz_app_t* app, char* line, int line_number, regex_t* regex, timezone_contact_t** contacts )
-{
-	char* tz_string = NULL;
-
-	wchar_t* email = NULL;
-	wchar_t* name = NULL;
-	wchar_t* office_phone = NULL;
-	wchar_t* mobile_phone = NULL;
-
-	if( *line == '#' )
-	{
-		// skipping comments
-		goto line_read_success;
-	}
-	else if( *line == '\0' )
-	{
-		// skipping empty lines
-		goto line_read_success;
-	}
-	else
-	{
-		const int max_groups = 7;
-		regmatch_t matches[ max_groups ];
-		int regex_result = regexec( regex, line, max_groups, matches, 0 );
-
-		if( !regex_result )
-		{
-			size_t tz_string_len = matches[ 1 ].rm_eo - matches[ 1 ].rm_so;
-			tz_string = malloc( tz_string_len + 1 );
-			if( !tz_check_alloc(app, tz_string) ) goto line_read_failed;
-			memcpy( tz_string, line + matches[ 1 ].rm_so, tz_string_len );
-			tz_string[ tz_string_len ] = '\0';
-
-			line[ matches[ 2 ].rm_eo ] = '\0';
-			size_t email_len = mb_strlen( line + matches[ 2 ].rm_so );
-			email = malloc( sizeof(wchar_t) * (email_len + 1) );
-			if( !tz_check_alloc(app, email) ) goto line_read_failed;
-			mbstowcs( email, line + matches[ 2 ].rm_so, email_len );
-			email[ email_len ] = '\0';
-
-			line[ matches[ 3 ].rm_eo ] = '\0';
-			size_t name_len = mb_strlen( line + matches[ 3 ].rm_so );
-			name = malloc( sizeof(wchar_t) * (name_len + 1) );
-			if( !tz_check_alloc(app, name) ) goto line_read_failed;
-			mbstowcs( name, line + matches[ 3 ].rm_so, name_len );
-			name[ name_len ] = '\0';
-
-			line[ matches[ 4 ].rm_eo ] = '\0';
-			size_t office_phone_len = mb_strlen( line + matches[ 4 ].rm_so );
-			office_phone = malloc( sizeof(wchar_t) * (office_phone_len + 1) );
-			if( !tz_check_alloc(app, office_phone) ) goto line_read_failed;
-			mbstowcs( office_phone, line + matches[ 4 ].rm_so, office_phone_len );
-			office_phone[ office_phone_len ] = '\0';
-
-
-			line[ matches[ 5 ].rm_eo ] = '\0';
-			size_t mobile_phone_len = mb_strlen( line + matches[ 5 ].rm_so );
-			mobile_phone = malloc( sizeof(wchar_t) * (mobile_phone_len + 1) );
-			if( !tz_check_alloc(app, mobile_phone) ) goto line_read_failed;
-			mbstowcs( mobile_phone, line + matches[ 5 ].rm_so, mobile_phone_len );
-			mobile_phone[ mobile_phone_len ] = '\0';
-
-			double utc_offset = time_utc_offset( tz_string );
-
-			timezone_contact_t contact = (timezone_contact_t) {
-				.utc_offset   = utc_offset,
-				.timezone     = tz_string,
-				.email        = email,
-				.name         = name,
-				.office_phone = office_phone,
-				.mobile_phone = mobile_phone
-			};
-			lc_vector_push( *contacts, contact );
-		}
-		else if (regex_result == REG_NOMATCH)
-		{
-			// line did not match.
-			tz_print_error( app, "Unable to match line with regular expression (see line %d).\n", line_number );
-			goto line_read_failed;
-		}
-		else
-		{
-			tz_print_error( app, "Unable to execute regular expression.\n" );
-			goto line_read_failed;
-		}
-	}
-
-line_read_success:
-	return true;
-
-line_read_failed:
-	free( tz_string );
-	free( email );
-	free( name );
-	free( office_phone );
-	free( mobile_phone );
-	return false;
-}
-
-bool tz_configuration_write_default( const char* configuration_filename )
-{
-	bool result = false;
-	FILE* config = fopen( configuration_filename, "w" );
-
-	if( config )
-	{
-		fprintf( config, "# -------------------------------\n" );
-		fprintf( config, "# This is the configuration for the timezoner program. You can\n" );
-		fprintf( config, "# add new contacts here. A list of IANA timezones is available\n" );
-		fprintf( config, "# from here: https://en.wikipedia.org/wiki/List_of_tz_database_time_zones\n" );
-		fprintf( config, "#\n" );
-		fprintf( config, "# The format is:\n" );
-		fprintf( config, "#\n" );
-		fprintf( config, "# Timezone \t\tEmail \tName \tOfficePhone \tMobilePhone\n" );
-		fprintf( config, "America/New_York \t\"john.doe@example.com\" \"John Doe\" \"+1 305 555 1234\" \"+1 954 555 5678\"\n" );
-
-		fclose( config );
-		result = true;
-	}
-
-	return result;
-}
-
-bool timezone_map_element_destroy( void *p_key, void *p_value )
-{
-	timezone_contact_t** list = p_value;
-
-	free( p_key );
-
-	if( list )
-	{
-		while(lc_vector_size(list) > 0)
-		{
-			lc_vector_pop(list);
-		}
-
-		lc_vector_destroy(list);
-	}
-
-	return true;
-}
-
-int timezone_map_compare( const void *p_key_left, const void *p_key_right )
-{
-	const char* l = p_key_left;
-	const char* r = p_key_right;
-	return strcmp( l, r );
-}
-
-int contact_name_compare( const void *l, const void *r )
-{
-	const timezone_contact_t** left = (const timezone_contact_t**) l;
-	const timezone_contact_t** right = (const timezone_contact_t**) r;
-	return wcscmp((*left)->name, (*right)->name );
-}
-
 bool tz_check_alloc( const tz_app_t* app, void* mem )
 {
 	bool result = true;
@@ -0,0 +1,177 @@
+/*
+ * Copyright (C) 2019-2025, Joe Marrero. http://www.joemarrero.com/
+ * Copyright (C) 2017, End Point Corporation. http://www.endpoint.com/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <stdlib.h>
+#include <string.h>
+#include "profile.h"
+
+tz_profile_counters_t* tz_profile_counters = NULL;
+
+static void   profile_end     ( tz_profile_t* profile );
+static double profile_elapsed ( const struct timespec* start );
+
+
+/*
+ * Starts counting; phases are then timed from tz_profile_phase() to the
+ * next one or to tz_profile_stop(). Only one profile can be counting.
+ */
+void tz_profile_start( tz_profile_t* profile )
+{
+	memset( profile, 0, sizeof(*profile) );
+	profile->phase = -1;
+	tz_profile_counters = &profile->counters;
+}
+
+/*
+ * Ends the current phase, if any, and begins another. Does nothing
+ * without a profile.
+ */
+void tz_profile_phase( tz_profile_t* profile, tz_profile_phase_t phase )
+{
+	if( profile )
+	{
+		profile_end( profile );
+
+		profile->phase = phase;
+		profile->begin = profile->counters;
+		clock_gettime( CLOCK_MONOTONIC, &profile->start );
+	}
+}
+
+void tz_profile_stop( tz_profile_t* profile )
+{
+	if( profile )
+	{
+		profile_end( profile );
+		tz_profile_counters = NULL;
+	}
+}
+
+void tz_profile_print( const tz_profile_t* profile, FILE* stream )
+{
+	static const char* PHASE_NAMES[ TZ_PROFILE_PHASES ] = { "read", "organize", "display", "teardown" };
+	tz_profile_counters_t total = { 0 };
+	double total_seconds = 0.0;
+
+	fprintf( stream, "%-9s %10s %12s %14s %8s %12s %14s\n",
+	         "Phase", "Time (ms)", "Allocations", "Bytes alloc'd", "Zones", "time_local()", "Bytes written" );
+
+	for( int phase = 0; phase <= TZ_PROFILE_PHASES; phase++ )
+	{
+		const tz_profile_counters_t* counters = phase < TZ_PROFILE_PHASES ? &profile->phases[ phase ] : &total;
+		double seconds = phase < TZ_PROFILE_PHASES ? profile->seconds[ phase ] : total_seconds;
+		char allocations[ 24 ] = "n/a";
+		char bytes_allocated[ 24 ] = "n/a";
+
+		if( TZ_PROFILE_ALLOCATIONS )
+		{
+			snprintf( allocations, sizeof(allocations), "%zu", counters->allocations );
+			snprintf( bytes_allocated, sizeof(bytes_allocated), "%zu", counters->bytes_allocated );
+		}
+
+		fprintf( stream, "%-9s %10.3f %12s %14s %8zu %12zu %14zu\n",
+		         phase < TZ_PROFILE_PHASES ? PHASE_NAMES[ phase ] : "total", seconds * 1000.0,
+		         allocations, bytes_allocated, counters->zone_computations,
+		         counters->time_local_calls, counters->bytes_written );
+
+		if( phase < TZ_PROFILE_PHASES )
+		{
+			total.allocations       += counters->allocations;
+			total.bytes_allocated   += counters->bytes_allocated;
+			total.zone_computations += counters->zone_computations;
+			total.time_local_calls  += counters->time_local_calls;
+			total.bytes_written     += counters->bytes_written;
+			total_seconds           += seconds;
+		}
+	}
+}
+
+void profile_end( tz_profile_t* profile )
+{
+	if( profile->phase >= 0 )
+	{
+		tz_profile_counters_t* phase = &profile->phases[ profile->phase ];
+
+		phase->allocations       += profile->counters.allocations - profile->begin.allocations;
+		phase->bytes_allocated   += profile->counters.bytes_allocated - profile->begin.bytes_allocated;
+		phase->zone_computations += profile->counters.zone_computations - profile->begin.zone_computations;
+		phase->time_local_calls  += profile->counters.time_local_calls - profile->begin.time_local_calls;
+		phase->bytes_written     += profile->counters.bytes_written - profile->begin.bytes_written;
+
+		profile->seconds[ profile->phase ] += profile_elapsed( &profile->start );
+		profile->phase = -1;
+	}
+}
+
+double profile_elapsed( const struct timespec* start )
+{
+	struct timespec end;
+	clock_gettime( CLOCK_MONOTONIC, &end );
+	return (end.tv_sec - start->tv_sec) + (end.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+#if TZ_PROFILE_ALLOCATIONS
+/*
+ * The linker sends the program's calls here (-Wl,--wrap=malloc and so on)
+ * and the real functions do the work, so libc's own symbols are left be
+ * and static builds link too.
+ */
+void* __real_malloc  ( size_t size );
+void* __real_calloc  ( size_t count, size_t size );
+void* __real_realloc ( void* p, size_t size );
+void* __wrap_malloc  ( size_t size );
+void* __wrap_calloc  ( size_t count, size_t size );
+void* __wrap_realloc ( void* p, size_t size );
+
+void* __wrap_malloc( size_t size )
+{
+	if( tz_profile_counters )
+	{
+		tz_profile_add( &tz_profile_counters->allocations, 1 );
+		tz_profile_add( &tz_profile_counters->bytes_allocated, size );
+	}
+
+	return __real_malloc( size );
+}
+
+void* __wrap_calloc( size_t count, size_t size )
+{
+	if( tz_profile_counters )
+	{
+		tz_profile_add( &tz_profile_counters->allocations, 1 );
+		tz_profile_add( &tz_profile_counters->bytes_allocated, count * size );
+	}
+
+	return __real_calloc( count, size );
+}
+
+void* __wrap_realloc( void* p, size_t size )
+{
+	if( tz_profile_counters )
+	{
+		tz_profile_add( &tz_profile_counters->allocations, 1 );
+		tz_profile_add( &tz_profile_counters->bytes_allocated, size );
+	}
+
+	return __real_realloc( p, size );
+}
+#endif
@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2019-2025, Joe Marrero. http://www.joemarrero.com/
+ * Copyright (C) 2017, End Point Corporation. http://www.endpoint.com/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef _TZ_PROFILE_H_
+#define _TZ_PROFILE_H_
+
+#include <stddef.h>
+#include <stdio.h>
+#include <time.h>
+
+/*
+ * Allocations are counted by wrappers around malloc(), calloc() and
+ * realloc() that the linker puts in with --wrap. That is opt-in (make
+ * PROFILE_ALLOCATIONS=true) since not every linker has it. The build
+ * only links when this and --wrap go together; without them the counts
+ * are reported as n/a.
+ */
+#ifndef TZ_PROFILE_ALLOCATIONS
+# define TZ_PROFILE_ALLOCATIONS    0
+#endif
+
+typedef enum tz_profile_phase {
+	TZ_PROFILE_READ = 0,   /* configuration and --where */
+	TZ_PROFILE_ORGANIZE,
+	TZ_PROFILE_DISPLAY,
+	TZ_PROFILE_TEARDOWN,
+	TZ_PROFILE_PHASES
+} tz_profile_phase_t;
+
+typedef struct tz_profile_counters {
+	size_t allocations;        /* malloc(), calloc() and realloc() calls */
+	size_t bytes_allocated;    /* bytes asked for by those calls */
+	size_t zone_computations;  /* local times computed for a zone */
+	size_t time_local_calls;   /* computations that switched TZ through libc */
+	size_t bytes_written;      /* rendered output */
+} tz_profile_counters_t;
+
+typedef struct tz_profile {
+	tz_profile_counters_t counters;  /* running totals */
+	tz_profile_counters_t begin;     /* totals when the current phase began */
+	struct timespec start;           /* when the current phase began */
+	int phase;                       /* -1 outside of a phase */
+	double seconds[ TZ_PROFILE_PHASES ];
+	tz_profile_counters_t phases[ TZ_PROFILE_PHASES ];
+} tz_profile_t;
+
+/*
+ * The counters being updated; NULL unless profiling, so that counting
+ * costs a single branch when it's off.
+ */
+extern tz_profile_counters_t* tz_profile_counters;
+
+#if defined(__GNUC__)
+# define tz_profile_add(counter, n)     __atomic_fetch_add( (counter), (n), __ATOMIC_RELAXED )
+#else
+# define tz_profile_add(counter, n)     (*(counter) += (n))
+#endif
+
+#define tz_profile_count(counter, n)   do { if( tz_profile_counters ) tz_profile_add( &tz_profile_counters->counter, (size_t) (n) ); } while( 0 )
+
+void tz_profile_start ( tz_profile_t* profile );
+void tz_profile_phase ( tz_profile_t* profile, tz_profile_phase_t phase );
+void tz_profile_stop  ( tz_profile_t* profile );
+void tz_profile_print ( const tz_profile_t* profile, FILE* stream );
+
+#endif /* _TZ_PROFILE_H_ */
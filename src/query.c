@@ -0,0 +1,732 @@
+/*
+ * Copyright (C) 2019-2025, Joe Marrero. http://www.joemarrero.com/
+ * Copyright (C) 2017, End Point Corporation. http://www.endpoint.com/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <ctype.h>
+#include <wchar.h>
+#include <wctype.h>
+#include <time.h>
+#include "timezoner.h"
+#include "query.h"
+
+typedef struct query_zone {
+	const char* name;
+	tz_zone_id_t id;
+} query_zone_t;
+
+static bool        query_parse_term     ( tz_query_t* query, const char* token );
+static bool        query_parse_offset   ( const char* s, const char** end, long* seconds );
+static bool        query_parse_clock    ( const char* s, const char** end, long* seconds );
+static bool        query_glob           ( const char* pattern, const char* name );
+static bool        query_contains       ( const wchar_t* haystack, const wchar_t* needle, size_t length );
+static bool        query_select_zones   ( const tz_query_t* query, const tz_app_t* app, bool at_now, bool* selected );
+static void        query_select_text    ( tz_query_t* query, const tz_query_term_t* term, const tz_contact_index_t* index, const timezone_contact_t* contacts, size_t count, const bool* zones, unsigned char* hits );
+static bool        query_index_build    ( tz_trigram_index_t* index, const timezone_contact_t* contacts, size_t count, tz_query_kind_t field );
+static const wchar_t* query_field       ( const timezone_contact_t* contact, tz_query_kind_t field );
+static int         query_zone_compare   ( const void* l, const void* r );
+
+static inline uint32_t query_trigram( wchar_t a, wchar_t b, wchar_t c )
+{
+	uint32_t hash = (uint32_t) a * 0x9E3779B1u ^ (uint32_t) b * 0x85EBCA77u ^ (uint32_t) c * 0xC2B2AE3Du;
+	return hash >> (32 - TZ_QUERY_BUCKET_BITS);
+}
+
+
+bool tz_query_create( tz_query_t* query )
+{
+	memset( query, 0, sizeof(*query) );
+	lc_vector_create( query->terms, 4 );
+	return query->terms != NULL;
+}
+
+void tz_query_destroy( tz_query_t* query )
+{
+	if( query->terms )
+	{
+		for( size_t i = 0; i < lc_vector_size(query->terms); i++ )
+		{
+			free( query->terms[ i ].pattern );
+			free( query->terms[ i ].text );
+		}
+		lc_vector_destroy( query->terms );
+	}
+	memset( query, 0, sizeof(*query) );
+}
+
+/*
+ * Adds the terms of an expression. Terms are separated by whitespace;
+ * double quotes keep whitespace in a value. Returns false on
+ * a malformed term, leaving the terms before it in place.
+ */
+bool tz_query_parse( tz_query_t* query, const char* expression )
+{
+	char* token = malloc( strlen(expression) + 1 );
+	bool result = token != NULL;
+	const char* p = expression;
+
+	while( result && *p )
+	{
+		while( isspace( (unsigned char) *p ) )
+		{
+			p++;
+		}
+
+		if( *p == '\0' )
+		{
+			break;
+		}
+
+		size_t length = 0;
+		bool quote = false;
+
+		for( ; *p && (quote || !isspace( (unsigned char) *p )); p++ )
+		{
+			if( *p == '"' )
+			{
+				quote = !quote;
+			}
+			else
+			{
+				token[ length++ ] = *p;
+			}
+		}
+		token[ length ] = '\0';
+
+		result = !quote && query_parse_term( query, token );
+	}
+
+	free( token );
+	return result;
+}
+
+/*
+ * Copies the contacts that match the zone and text terms into a new
+ * vector, in their original order. With at_now, offsets and local hours
+ * are also checked at the zone cache's instant.
+ */
+bool tz_query_select( tz_query_t* query, const tz_contact_index_t* index, const tz_app_t* app, const timezone_contact_t* contacts, bool at_now, timezone_contact_t** matching )
+{
+	size_t count = lc_vector_size( contacts );
+	size_t zone_count = tz_zone_cache_size( app->zones );
+	bool has_text = tz_query_has_text(query);
+	bool* zones = malloc( sizeof(bool) * (zone_count + 1) );
+	unsigned char* hits = has_text ? calloc( count + 1, 1 ) : NULL;
+	bool result = false;
+	struct timespec select_start, select_end;
+
+	clock_gettime( CLOCK_MONOTONIC, &select_start );
+	query->candidates = 0;
+	query->matches    = 0;
+
+	if( !zones || (has_text && !hits) || !query_select_zones( query, app, at_now, zones ) )
+	{
+		goto done;
+	}
+
+	if( index && index->count != count )
+	{
+		// Built for another set of contacts.
+		index = NULL;
+	}
+
+	for( size_t i = 0; has_text && i < lc_vector_size(query->terms); i++ )
+	{
+		const tz_query_term_t* term = &query->terms[ i ];
+
+		if( term->kind == TZ_QUERY_NAME || term->kind == TZ_QUERY_EMAIL || term->kind == TZ_QUERY_TEXT )
+		{
+			query_select_text( query, term, index, contacts, count, zones, hits );
+		}
+	}
+
+	// Each kind of text term that is present sets its own bit.
+	unsigned char required = (unsigned char) (query->kinds >> TZ_QUERY_NAME);
+
+	for( size_t row = 0; row < count; row++ )
+	{
+		if( zones[ contacts[ row ].zone ] && (!has_text || hits[ row ] == required) )
+		{
+			lc_vector_push( *matching, contacts[ row ] );
+			query->matches += 1;
+		}
+	}
+
+	result = true;
+
+done:
+	clock_gettime( CLOCK_MONOTONIC, &select_end );
+	query->seconds = (select_end.tv_sec - select_start.tv_sec) + (select_end.tv_nsec - select_start.tv_nsec) / 1e9;
+	free( zones );
+	free( hits );
+	return result;
+}
+
+/*
+ * true if a resolved zone satisfies the offset and local hour terms.
+ */
+bool tz_query_match_zone( const tz_query_t* query, const tz_zone_t* zone )
+{
+	if( !tz_query_is_timed(query) )
+	{
+		return true;
+	}
+
+	bool offset_matched = !tz_query_has(query, TZ_QUERY_OFFSET);
+	bool hour_matched   = !tz_query_has(query, TZ_QUERY_HOUR);
+	long seconds_of_day = tz_zone_seconds_of_day( zone );
+
+	for( size_t i = 0; i < lc_vector_size(query->terms); i++ )
+	{
+		const tz_query_term_t* term = &query->terms[ i ];
+
+		if( term->kind == TZ_QUERY_OFFSET )
+		{
+			offset_matched |= zone->utc_offset >= term->from && zone->utc_offset <= term->to;
+		}
+		else if( term->kind == TZ_QUERY_HOUR )
+		{
+			// A range that ends before it starts wraps past midnight.
+			hour_matched |= term->from <= term->to ?
+			                seconds_of_day >= term->from && seconds_of_day < term->to :
+			                seconds_of_day >= term->from || seconds_of_day < term->to;
+		}
+	}
+
+	return offset_matched && hour_matched;
+}
+
+bool tz_contact_index_create( tz_contact_index_t* index, const timezone_contact_t* contacts, size_t count )
+{
+	memset( index, 0, sizeof(*index) );
+
+	if( !query_index_build( &index->names, contacts, count, TZ_QUERY_NAME ) ||
+	    !query_index_build( &index->emails, contacts, count, TZ_QUERY_EMAIL ) )
+	{
+		tz_contact_index_destroy( index );
+		return false;
+	}
+
+	index->count = count;
+	return true;
+}
+
+void tz_contact_index_destroy( tz_contact_index_t* index )
+{
+	if( !index->mapped )
+	{
+		free( index->names.starts );
+		free( index->names.rows );
+		free( index->emails.starts );
+		free( index->emails.rows );
+	}
+	memset( index, 0, sizeof(*index) );
+}
+
+bool query_parse_term( tz_query_t* query, const char* token )
+{
+	static const struct {
+		const char* key;
+		tz_query_kind_t kind;
+	} keys[] = {
+		{ "zone=",   TZ_QUERY_ZONE },
+		{ "offset=", TZ_QUERY_OFFSET },
+		{ "hour=",   TZ_QUERY_HOUR },
+		{ "name~",   TZ_QUERY_NAME },
+		{ "email~",  TZ_QUERY_EMAIL },
+	};
+	tz_query_term_t term = { .kind = TZ_QUERY_TEXT };
+	const char* value = token;
+
+	for( size_t i = 0; i < sizeof(keys) / sizeof(keys[0]); i++ )
+	{
+		size_t key_length = strlen( keys[ i ].key );
+
+		if( strncmp( token, keys[ i ].key, key_length ) == 0 )
+		{
+			term.kind = keys[ i ].kind;
+			value = token + key_length;
+			break;
+		}
+	}
+
+	if( term.kind == TZ_QUERY_TEXT )
+	{
+		// Catch misspelled keys rather than searching for them.
+		const char* p = token;
+		while( isalpha( (unsigned char) *p ) )
+		{
+			p++;
+		}
+
+		if( p != token && (*p == '=' || *p == '~') )
+		{
+			return false;
+		}
+	}
+
+	if( *value == '\0' )
+	{
+		return false;
+	}
+
+	const char* end = value;
+
+	switch( term.kind )
+	{
+		case TZ_QUERY_ZONE:
+			term.pattern = malloc( strlen(value) + 1 );
+			if( !term.pattern )
+			{
+				return false;
+			}
+			strcpy( term.pattern, value );
+			break;
+
+		case TZ_QUERY_OFFSET:
+			if( !query_parse_offset( value, &end, &term.from ) )
+			{
+				return false;
+			}
+			term.to = term.from;
+			if( strncmp( end, "..", 2 ) == 0 && !query_parse_offset( end + 2, &end, &term.to ) )
+			{
+				return false;
+			}
+			if( *end != '\0' || term.to < term.from )
+			{
+				return false;
+			}
+			break;
+
+		case TZ_QUERY_HOUR:
+			if( !query_parse_clock( value, &end, &term.from ) )
+			{
+				return false;
+			}
+			// A single hour is the whole hour.
+			term.to = (term.from + 3600) % (24 * 3600);
+			if( strncmp( end, "..", 2 ) == 0 && !query_parse_clock( end + 2, &end, &term.to ) )
+			{
+				return false;
+			}
+			if( *end != '\0' )
+			{
+				return false;
+			}
+			break;
+
+		default:
+		{
+			size_t length = mbstowcs( NULL, value, 0 );
+			if( length == (size_t) -1 )
+			{
+				return false;
+			}
+
+			term.text = malloc( sizeof(wchar_t) * (length + 1) );
+			if( !term.text )
+			{
+				return false;
+			}
+			mbstowcs( term.text, value, length + 1 );
+
+			for( size_t i = 0; i < length; i++ )
+			{
+				term.text[ i ] = (wchar_t) towlower( (wint_t) term.text[ i ] );
+			}
+			term.length = length;
+			break;
+		}
+	}
+
+	lc_vector_push( query->terms, term );
+	query->kinds |= 1u << term.kind;
+	return true;
+}
+
+/*
+ * Hours east of UTC as [+-]H, [+-]H.F or [+-]H:MM.
+ */
+bool query_parse_offset( const char* s, const char** end, long* seconds )
+{
+	long sign = 1;
+	long hours = 0;
+	long fraction = 0;
+
+	if( *s == '+' || *s == '-' )
+	{
+		sign = *s == '-' ? -1 : 1;
+		s++;
+	}
+
+	if( !isdigit( (unsigned char) *s ) )
+	{
+		return false;
+	}
+
+	while( isdigit( (unsigned char) *s ) )
+	{
+		hours = hours * 10 + (*s++ - '0');
+		if( hours > 24 ) return false;
+	}
+
+	if( *s == ':' && isdigit( (unsigned char) s[ 1 ] ) && isdigit( (unsigned char) s[ 2 ] ) )
+	{
+		fraction = ((s[ 1 ] - '0') * 10 + (s[ 2 ] - '0')) * 60;
+		s += 3;
+	}
+	else if( *s == '.' && isdigit( (unsigned char) s[ 1 ] ) )
+	{
+		// A decimal fraction, not the start of a range.
+		long scale = 3600;
+
+		for( s++; isdigit( (unsigned char) *s ); s++ )
+		{
+			scale /= 10;
+			fraction += (*s - '0') * scale;
+		}
+	}
+
+	*seconds = sign * (hours * 3600 + fraction);
+	*end = s;
+	return true;
+}
+
+/*
+ * A local time as H or H:MM, from 0 to 24.
+ */
+bool query_parse_clock( const char* s, const char** end, long* seconds )
+{
+	long hour = 0;
+	long minute = 0;
+
+	if( !isdigit( (unsigned char) *s ) )
+	{
+		return false;
+	}
+
+	while( isdigit( (unsigned char) *s ) )
+	{
+		hour = hour * 10 + (*s++ - '0');
+		if( hour > 24 ) return false;
+	}
+
+	if( *s == ':' )
+	{
+		if( !isdigit( (unsigned char) s[ 1 ] ) || !isdigit( (unsigned char) s[ 2 ] ) )
+		{
+			return false;
+		}
+		minute = (s[ 1 ] - '0') * 10 + (s[ 2 ] - '0');
+		s += 3;
+	}
+
+	if( minute > 59 || hour * 60 + minute > 24 * 60 )
+	{
+		return false;
+	}
+
+	*seconds = hour * 3600 + minute * 60;
+	*end = s;
+	return true;
+}
+
+/*
+ * Matches '*' (any run of characters) and '?' (any one character).
+ */
+bool query_glob( const char* pattern, const char* name )
+{
+	const char* star = NULL;
+	const char* resume = NULL;
+
+	while( *name )
+	{
+		if( *pattern == '*' )
+		{
+			star = pattern++;
+			resume = name;
+		}
+		else if( *pattern == '?' || *pattern == *name )
+		{
+			pattern++;
+			name++;
+		}
+		else if( star )
+		{
+			pattern = star + 1;
+			name = ++resume;
+		}
+		else
+		{
+			return false;
+		}
+	}
+
+	while( *pattern == '*' )
+	{
+		pattern++;
+	}
+
+	return *pattern == '\0';
+}
+
+bool query_contains( const wchar_t* haystack, const wchar_t* needle, size_t length )
+{
+	for( ; *haystack; haystack++ )
+	{
+		size_t i = 0;
+
+		while( i < length && haystack[ i ] && (wchar_t) towlower( (wint_t) haystack[ i ] ) == needle[ i ] )
+		{
+			i++;
+		}
+
+		if( i == length )
+		{
+			return true;
+		}
+	}
+
+	return length == 0;
+}
+
+/*
+ * Marks the zones that pass the zone terms (and, with at_now, the
+ * offset and hour terms). Zone names are sorted so that each glob only
+ * looks at the names that start with its literal prefix.
+ */
+bool query_select_zones( const tz_query_t* query, const tz_app_t* app, bool at_now, bool* selected )
+{
+	size_t zone_count = tz_zone_cache_size( app->zones );
+	bool by_zone = tz_query_has(query, TZ_QUERY_ZONE);
+
+	for( tz_zone_id_t id = 0; id < zone_count; id++ )
+	{
+		selected[ id ] = !by_zone;
+	}
+
+	if( by_zone )
+	{
+		query_zone_t* table = malloc( sizeof(query_zone_t) * (zone_count + 1) );
+		if( !table )
+		{
+			return false;
+		}
+
+		for( tz_zone_id_t id = 0; id < zone_count; id++ )
+		{
+			table[ id ] = (query_zone_t) { app->zones->zones[ id ].name, id };
+		}
+		qsort( table, zone_count, sizeof(query_zone_t), query_zone_compare );
+
+		for( size_t i = 0; i < lc_vector_size(query->terms); i++ )
+		{
+			const char* pattern = query->terms[ i ].pattern;
+
+			if( query->terms[ i ].kind != TZ_QUERY_ZONE )
+			{
+				continue;
+			}
+
+			size_t prefix = strcspn( pattern, "*?" );
+			size_t low = 0;
+			size_t high = zone_count;
+
+			while( low < high )
+			{
+				size_t middle = low + (high - low) / 2;
+
+				if( strncmp( table[ middle ].name, pattern, prefix ) < 0 )
+				{
+					low = middle + 1;
+				}
+				else
+				{
+					high = middle;
+				}
+			}
+
+			for( ; low < zone_count && strncmp( table[ low ].name, pattern, prefix ) == 0; low++ )
+			{
+				selected[ table[ low ].id ] |= query_glob( pattern, table[ low ].name );
+			}
+		}
+
+		free( table );
+	}
+
+	for( tz_zone_id_t id = 0; at_now && id < zone_count; id++ )
+	{
+		selected[ id ] = selected[ id ] && tz_query_match_zone( query, tz_zone_cache_resolve( app->zones, id ) );
+	}
+
+	return true;
+}
+
+/*
+ * Sets the term's bit for the rows in selected zones whose name or
+ * email contains it. Terms of three or more characters only look at the rows in the
+ * smallest posting list of their trigrams.
+ */
+void query_select_text( tz_query_t* query, const tz_query_term_t* term, const tz_contact_index_t* index, const timezone_contact_t* contacts, size_t count, const bool* zones, unsigned char* hits )
+{
+	unsigned char bit = (unsigned char) (1u << (term->kind - TZ_QUERY_NAME));
+
+	for( tz_query_kind_t field = TZ_QUERY_NAME; field <= TZ_QUERY_EMAIL; field++ )
+	{
+		if( term->kind != TZ_QUERY_TEXT && term->kind != field )
+		{
+			continue;
+		}
+
+		const uint32_t* rows = NULL;
+		size_t row_count = count;
+
+		if( index && term->length >= 3 )
+		{
+			const tz_trigram_index_t* trigrams = field == TZ_QUERY_NAME ? &index->names : &index->emails;
+
+			for( size_t i = 2; i < term->length; i++ )
+			{
+				uint32_t bucket = query_trigram( term->text[ i - 2 ], term->text[ i - 1 ], term->text[ i ] );
+				size_t size = trigrams->starts[ bucket + 1 ] - trigrams->starts[ bucket ];
+
+				if( !rows || size < row_count )
+				{
+					rows = trigrams->rows + trigrams->starts[ bucket ];
+					row_count = size;
+				}
+			}
+		}
+
+		for( size_t i = 0; i < row_count; i++ )
+		{
+			size_t row = rows ? rows[ i ] : i;
+
+			if( row >= count || (hits[ row ] & bit) || !zones[ contacts[ row ].zone ] )
+			{
+				continue;
+			}
+
+			query->candidates += 1;
+			if( query_contains( query_field( &contacts[ row ], field ), term->text, term->length ) )
+			{
+				hits[ row ] |= bit;
+			}
+		}
+	}
+}
+
+/*
+ * Counts the distinct trigrams of each row per bucket, then fills the
+ * postings in row order so that every bucket comes out sorted.
+ */
+bool query_index_build( tz_trigram_index_t* index, const timezone_contact_t* contacts, size_t count, tz_query_kind_t field )
+{
+	uint32_t* cursors = calloc( TZ_QUERY_BUCKETS, sizeof(uint32_t) );
+	index->starts = calloc( TZ_QUERY_BUCKETS + 1, sizeof(uint32_t) );
+
+	if( !cursors || !index->starts )
+	{
+		free( cursors );
+		return false;
+	}
+
+	// cursors holds the last row (plus one) counted in each bucket.
+	for( uint32_t row = 0; row < count; row++ )
+	{
+		const wchar_t* s = query_field( &contacts[ row ], field );
+		wchar_t a = 0, b = 0;
+
+		for( size_t i = 0; s[ i ]; i++ )
+		{
+			wchar_t c = (wchar_t) towlower( (wint_t) s[ i ] );
+
+			if( i >= 2 )
+			{
+				uint32_t bucket = query_trigram( a, b, c );
+
+				if( cursors[ bucket ] != row + 1 )
+				{
+					cursors[ bucket ] = row + 1;
+					index->starts[ bucket + 1 ] += 1;
+				}
+			}
+			a = b;
+			b = c;
+		}
+	}
+
+	for( uint32_t bucket = 0; bucket < TZ_QUERY_BUCKETS; bucket++ )
+	{
+		index->starts[ bucket + 1 ] += index->starts[ bucket ];
+		cursors[ bucket ] = index->starts[ bucket ];
+	}
+
+	index->rows = malloc( sizeof(uint32_t) * (index->starts[ TZ_QUERY_BUCKETS ] + 1) );
+	if( !index->rows )
+	{
+		free( cursors );
+		return false;
+	}
+
+	for( uint32_t row = 0; row < count; row++ )
+	{
+		const wchar_t* s = query_field( &contacts[ row ], field );
+		wchar_t a = 0, b = 0;
+
+		for( size_t i = 0; s[ i ]; i++ )
+		{
+			wchar_t c = (wchar_t) towlower( (wint_t) s[ i ] );
+
+			if( i >= 2 )
+			{
+				uint32_t bucket = query_trigram( a, b, c );
+				uint32_t cursor = cursors[ bucket ];
+
+				if( cursor == index->starts[ bucket ] || index->rows[ cursor - 1 ] != row )
+				{
+					index->rows[ cursors[ bucket ]++ ] = row;
+				}
+			}
+			a = b;
+			b = c;
+		}
+	}
+
+	free( cursors );
+	return true;
+}
+
+const wchar_t* query_field( const timezone_contact_t* contact, tz_query_kind_t field )
+{
+	return field == TZ_QUERY_NAME ? contact->name : contact->email;
+}
+
+int query_zone_compare( const void* l, const void* r )
+{
+	const query_zone_t* left  = l;
+	const query_zone_t* right = r;
+	return strcmp( left->name, right->name );
+}
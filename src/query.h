@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2019-2025, Joe Marrero. http://www.joemarrero.com/
+ * Copyright (C) 2017, End Point Corporation. http://www.endpoint.com/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef _TZ_QUERY_H_
+#define _TZ_QUERY_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <wchar.h>
+#include "zone.h"
+
+struct tz_app;
+struct timezone_contact;
+
+typedef enum tz_query_kind {
+	TZ_QUERY_ZONE = 0, /* zone=GLOB */
+	TZ_QUERY_OFFSET,   /* offset=HOURS[..HOURS] */
+	TZ_QUERY_HOUR,     /* hour=H[:MM][..H[:MM]] in local time */
+	TZ_QUERY_NAME,     /* name~TEXT */
+	TZ_QUERY_EMAIL,    /* email~TEXT */
+	TZ_QUERY_TEXT,     /* TEXT anywhere in the name or email */
+} tz_query_kind_t;
+
+typedef struct tz_query_term {
+	tz_query_kind_t kind;
+	char* pattern;             /* zone glob */
+	wchar_t* text;             /* lower case */
+	size_t length;
+	long from;                 /* seconds east of UTC, or past local midnight */
+	long to;
+} tz_query_term_t;
+
+/*
+ * A --where filter. Terms of the same kind match when any of them does,
+ * and a contact has to match every kind that is present:
+ *
+ *   zone=Europe/P* zone=America/N* hour=9..17 name~kidd
+ *
+ * Zone and text terms never change, so they are applied once to the
+ * loaded contacts. Offsets and local hours move with the clock and are
+ * checked per zone whenever the contacts are grouped.
+ */
+typedef struct tz_query {
+	tz_query_term_t* terms;    /* vector */
+	unsigned int kinds;        /* bit per kind present */
+	size_t candidates;         /* contacts compared by the last selection */
+	size_t matches;
+	double seconds;            /* time spent on the last selection */
+} tz_query_t;
+
+/*
+ * Trigram postings of the lower case names and emails. Trigrams are
+ * hashed into a fixed number of buckets; each bucket lists the rows
+ * that have one of its trigrams, in ascending order.
+ */
+typedef struct tz_trigram_index {
+	uint32_t* starts;          /* bucket -> first posting, plus the end */
+	uint32_t* rows;
+} tz_trigram_index_t;
+
+#define TZ_QUERY_BUCKET_BITS   (16)
+#define TZ_QUERY_BUCKETS       (1u << TZ_QUERY_BUCKET_BITS)
+
+typedef struct tz_contact_index {
+	tz_trigram_index_t names;
+	tz_trigram_index_t emails;
+	size_t count;              /* contacts indexed */
+	bool mapped;               /* postings belong to the compiled cache */
+} tz_contact_index_t;
+
+bool tz_query_create         ( tz_query_t* query );
+void tz_query_destroy        ( tz_query_t* query );
+bool tz_query_parse          ( tz_query_t* query, const char* expression );
+bool tz_query_select         ( tz_query_t* query, const tz_contact_index_t* index, const struct tz_app* app, const struct timezone_contact* contacts, bool at_now, struct timezone_contact** matching );
+bool tz_query_match_zone     ( const tz_query_t* query, const tz_zone_t* zone );
+
+bool tz_contact_index_create  ( tz_contact_index_t* index, const struct timezone_contact* contacts, size_t count );
+void tz_contact_index_destroy ( tz_contact_index_t* index );
+
+#define tz_query_has(query, kind)      ((query) && ((query)->kinds & (1u << (kind))))
+#define tz_query_is_timed(query)       (tz_query_has(query, TZ_QUERY_OFFSET) || tz_query_has(query, TZ_QUERY_HOUR))
+#define tz_query_has_text(query)       (tz_query_has(query, TZ_QUERY_NAME) || tz_query_has(query, TZ_QUERY_EMAIL) || tz_query_has(query, TZ_QUERY_TEXT))
+
+#endif /* _TZ_QUERY_H_ */
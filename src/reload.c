@@ -0,0 +1,756 @@
+/*
+ * Copyright (C) 2019-2025, Joe Marrero. http://www.joemarrero.com/
+ * Copyright (C) 2017, End Point Corporation. http://www.endpoint.com/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <limits.h>
+#include <xtd/string.h>
+#include "timezoner.h"
+#include "config.h"
+#include "reload.h"
+#if defined(_WIN32) || defined(_WIN64)
+# include <windows.h>
+#else
+# include <unistd.h>
+# include <signal.h>
+# include <sched.h>
+# include <poll.h>
+# include <libgen.h>
+# if defined(__linux__)
+#  include <sys/inotify.h>
+# endif
+#endif
+
+static tz_snapshot_t* reload_load     ( tz_reloader_t* reloader, char*** sources );
+static void           reload_destroy  ( tz_snapshot_t* snapshot );
+static const char*    reload_name     ( const tz_reloader_t* reloader, size_t file );
+static size_t         reload_files    ( const tz_reloader_t* reloader );
+static void           reload_stamp    ( const char* name, tz_reload_stamp_t* stamp );
+static void           reload_adopt    ( tz_reloader_t* reloader, char** sources );
+static void           reload_sources_destroy ( char** sources );
+#if !defined(_WIN32) && !defined(_WIN64)
+static void           reload_watch    ( tz_reloader_t* reloader );
+static void           reload_unwatch  ( tz_reload_watch_t* watches, size_t count );
+static bool           reload_wait     ( tz_reloader_t* reloader );
+static int            reload_poll     ( tz_reloader_t* reloader, int timeout );
+static void*          reload_run      ( void* argument );
+#endif
+
+
+/*
+ * Reads the configuration and publishes it as the first snapshot. Fails
+ * if that first read does.
+ */
+bool tz_reloader_create( tz_reloader_t* reloader, const tz_app_t* app, const char** names, size_t count, int use_cache, bool indexed )
+{
+	memset( reloader, 0, sizeof(*reloader) );
+	reloader->app        = *app;
+	reloader->app.query  = NULL;
+	reloader->app.errors = NULL;
+	reloader->names      = names;
+	reloader->count      = count;
+	reloader->use_cache  = use_cache;
+	reloader->indexed    = indexed;
+
+	if( count == 0 )
+	{
+		tz_configuration_home_name( reloader->home_name, sizeof(reloader->home_name) );
+	}
+
+#if !defined(_WIN32) && !defined(_WIN64)
+	reloader->notify    = -1;
+	reloader->wake[ 0 ] = -1;
+	reloader->wake[ 1 ] = -1;
+	pthread_mutex_init( &reloader->lock, NULL );
+#endif
+
+	// Until the first load says otherwise, the sources are the files named.
+	lc_vector_create( reloader->sources, reload_files( reloader ) );
+	reloader->stamps = calloc( reload_files( reloader ), sizeof(tz_reload_stamp_t) );
+	if( !tz_check_alloc( app, reloader->sources ) || !tz_check_alloc( app, reloader->stamps ) )
+	{
+		tz_reloader_destroy( reloader );
+		return false;
+	}
+
+	for( size_t file = 0; file < (count > 0 ? count : 1); file++ )
+	{
+		char* source = string_dup( count > 0 ? names[ file ] : reloader->home_name );
+		if( !tz_check_alloc( app, source ) )
+		{
+			tz_reloader_destroy( reloader );
+			return false;
+		}
+
+		lc_vector_push( reloader->sources, source );
+		reload_stamp( source, &reloader->stamps[ file ] );
+	}
+
+	// The files are watched before they are read, so no edit goes unseen.
+#if defined(__linux__)
+	reloader->notify = inotify_init1( IN_CLOEXEC | IN_NONBLOCK );
+#endif
+#if !defined(_WIN32) && !defined(_WIN64)
+	reload_watch( reloader );
+#endif
+
+	char** sources = NULL;
+	reloader->current = reload_load( reloader, &sources );
+	if( !reloader->current )
+	{
+		reload_sources_destroy( sources );
+		tz_reloader_destroy( reloader );
+		return false;
+	}
+
+	// The files it included are watched by the thread from its start.
+	reload_adopt( reloader, sources );
+
+	reloader->generation = 1;
+	reloader->current->generation = reloader->generation;
+
+#if !defined(_WIN32) && !defined(_WIN64)
+	if( pipe( reloader->wake ) == 0 )
+	{
+		// Signals are left to the threads that handle them.
+		sigset_t signals, previous;
+		sigfillset( &signals );
+		pthread_sigmask( SIG_BLOCK, &signals, &previous );
+		reloader->started = pthread_create( &reloader->thread, NULL, reload_run, reloader ) == 0;
+		pthread_sigmask( SIG_SETMASK, &previous, NULL );
+	}
+
+	if( !reloader->started )
+	{
+		tz_print_error( app, "Unable to watch the configuration for changes.\n" );
+	}
+#endif
+
+	return true;
+}
+
+/*
+ * Stops watching and releases the published snapshot. Readers must
+ * have released theirs.
+ */
+void tz_reloader_destroy( tz_reloader_t* reloader )
+{
+#if !defined(_WIN32) && !defined(_WIN64)
+	if( reloader->started )
+	{
+		// Any byte wakes the thread up to stop.
+		while( write( reloader->wake[ 1 ], "", 1 ) < 0 && errno == EINTR );
+		pthread_join( reloader->thread, NULL );
+		reloader->started = false;
+	}
+
+	for( int i = 0; i < 2; i++ )
+	{
+		if( reloader->wake[ i ] >= 0 )
+		{
+			close( reloader->wake[ i ] );
+			reloader->wake[ i ] = -1;
+		}
+	}
+
+	if( reloader->notify >= 0 )
+	{
+		close( reloader->notify );
+		reloader->notify = -1;
+	}
+
+	reload_unwatch( reloader->watches, reloader->watch_count );
+	reloader->watches     = NULL;
+	reloader->watch_count = 0;
+
+	pthread_mutex_destroy( &reloader->lock );
+#endif
+
+	if( reloader->current )
+	{
+		tz_snapshot_release( reloader->current );
+		reloader->current = NULL;
+	}
+
+	reload_sources_destroy( reloader->sources );
+	reloader->sources = NULL;
+	free( reloader->stamps );
+	reloader->stamps = NULL;
+}
+
+/*
+ * Rereads the configuration if a file changed, or if forced, and
+ * publishes it. The previous snapshot is freed once the last reader
+ * lets go of it. Returns false if the configuration failed to load, in
+ * which case the last good snapshot stays published and the files are
+ * not read again until they change once more.
+ */
+bool tz_reloader_reload( tz_reloader_t* reloader, bool forced )
+{
+	bool result = true;
+
+#if !defined(_WIN32) && !defined(_WIN64)
+	pthread_mutex_lock( &reloader->lock );
+#endif
+
+	size_t count = reload_files( reloader );
+	tz_reload_stamp_t stamps[ count ];
+
+	for( size_t file = 0; file < count; file++ )
+	{
+		reload_stamp( reload_name( reloader, file ), &stamps[ file ] );
+	}
+
+	if( forced || memcmp( stamps, reloader->stamps, sizeof(stamps) ) != 0 )
+	{
+		char** sources = NULL;
+
+		memcpy( reloader->stamps, stamps, sizeof(stamps) );
+
+		tz_snapshot_t* snapshot = reload_load( reloader, &sources );
+
+		if( snapshot )
+		{
+			snapshot->generation = reloader->generation + 1;
+
+			tz_snapshot_t* previous = __atomic_exchange_n( &reloader->current, snapshot, __ATOMIC_SEQ_CST );
+			__atomic_store_n( &reloader->generation, snapshot->generation, __ATOMIC_RELEASE );
+
+			// Wait out the readers that may have loaded the previous
+			// snapshot but not yet referenced it; it takes a few instructions.
+			while( __atomic_load_n( &reloader->readers, __ATOMIC_SEQ_CST ) != 0 )
+			{
+#if !defined(_WIN32) && !defined(_WIN64)
+				sched_yield( );
+#endif
+			}
+
+			tz_snapshot_release( previous );
+		}
+		else
+		{
+			tz_print_error( &reloader->app, "Keeping the last good configuration.\n" );
+			result = false;
+		}
+
+		// Whatever the load got to, a broken file included, is watched
+		// from now on.
+		reload_adopt( reloader, sources );
+
+#if !defined(_WIN32) && !defined(_WIN64)
+		if( reloader->started && !pthread_equal( pthread_self( ), reloader->thread ) )
+		{
+			// The thread watches the new sources once it wakes up.
+			while( write( reloader->wake[ 1 ], "w", 1 ) < 0 && errno == EINTR );
+		}
+#endif
+	}
+
+#if !defined(_WIN32) && !defined(_WIN64)
+	pthread_mutex_unlock( &reloader->lock );
+#endif
+	return result;
+}
+
+unsigned int tz_reloader_generation( const tz_reloader_t* reloader )
+{
+	return __atomic_load_n( &reloader->generation, __ATOMIC_ACQUIRE );
+}
+
+/*
+ * References the published snapshot. This never blocks, even while a
+ * reload is in progress.
+ */
+tz_snapshot_t* tz_snapshot_acquire( tz_reloader_t* reloader )
+{
+	__atomic_fetch_add( &reloader->readers, 1, __ATOMIC_SEQ_CST );
+
+	tz_snapshot_t* snapshot = __atomic_load_n( &reloader->current, __ATOMIC_SEQ_CST );
+	__atomic_fetch_add( &snapshot->references, 1, __ATOMIC_RELAXED );
+
+	__atomic_fetch_sub( &reloader->readers, 1, __ATOMIC_RELEASE );
+	return snapshot;
+}
+
+void tz_snapshot_release( tz_snapshot_t* snapshot )
+{
+	if( __atomic_sub_fetch( &snapshot->references, 1, __ATOMIC_ACQ_REL ) == 0 )
+	{
+		reload_destroy( snapshot );
+	}
+}
+
+/*
+ * Creates a zone cache with the same IDs as the snapshot's, for a
+ * reader to resolve zones in.
+ */
+bool tz_snapshot_zones( const tz_snapshot_t* snapshot, tz_zone_cache_t* zones, time_t now )
+{
+	if( !tz_zone_cache_create( zones, now ) )
+	{
+		tz_zone_cache_destroy( zones );
+		return false;
+	}
+
+	// Interned in the same order, every zone gets the same ID.
+	for( tz_zone_id_t id = 0; id < tz_zone_cache_size( &snapshot->zones ); id++ )
+	{
+		if( tz_zone_cache_intern( zones, snapshot->zones.zones[ id ].name ) != id )
+		{
+			tz_zone_cache_destroy( zones );
+			return false;
+		}
+	}
+
+	return true;
+}
+
+const tz_contact_index_t* tz_snapshot_index( const tz_snapshot_t* snapshot )
+{
+	if( snapshot->cache.index.count > 0 )
+	{
+		return &snapshot->cache.index;
+	}
+
+	return snapshot->index.count > 0 ? &snapshot->index : NULL;
+}
+
+/*
+ * Reads the configuration into a new snapshot. The files and include
+ * directories it resolved are returned in sources, even when it fails.
+ */
+tz_snapshot_t* reload_load( tz_reloader_t* reloader, char*** sources )
+{
+	bool loaded = false;
+	tz_snapshot_t* snapshot = calloc( 1, sizeof(tz_snapshot_t) );
+
+	lc_vector_create( *sources, 4 );
+
+	if( !tz_check_alloc( &reloader->app, snapshot ) )
+	{
+		return NULL;
+	}
+
+	tz_app_t app = reloader->app;
+	app.now        = time( NULL );
+	app.zones      = &snapshot->zones;
+	app.strings    = &snapshot->strings;
+	app.load_stats = &snapshot->load_stats;
+	app.cache      = reloader->use_cache > 0 || (reloader->use_cache < 0 && reloader->count == 0) ? &snapshot->cache : NULL;
+	app.sources    = *sources ? sources : NULL;
+
+	snapshot->references = 1; /* published */
+	tz_arena_create( &snapshot->strings, TZ_ARENA_BLOCK_SIZE );
+	lc_vector_create( snapshot->contacts, 1 );
+
+	if( !tz_zone_cache_create( &snapshot->zones, app.now ) || !tz_check_alloc( &app, snapshot->contacts ) )
+	{
+		goto done;
+	}
+
+	if( reloader->count > 0 )
+	{
+		loaded = tz_configuration_load( &app, reloader->names, reloader->count, &snapshot->contacts );
+	}
+	else
+	{
+		loaded = tz_read_configuration_from_home( &app, &snapshot->contacts );
+	}
+
+	if( !loaded )
+	{
+		goto done;
+	}
+
+	size_t count = lc_vector_size( snapshot->contacts );
+	if( reloader->indexed && snapshot->cache.index.count == 0 && count > 0 )
+	{
+		loaded = tz_contact_index_create( &snapshot->index, snapshot->contacts, count );
+		if( !loaded )
+		{
+			tz_print_error( &app, "Out of memory.\n" );
+			goto done;
+		}
+	}
+
+	for( size_t id = 0; id < tz_zone_cache_size( &snapshot->zones ); id++ )
+	{
+		snapshot->fallback = snapshot->fallback || !snapshot->zones.zones[ id ].info;
+	}
+
+done:
+	if( !loaded )
+	{
+		reload_destroy( snapshot );
+		snapshot = NULL;
+	}
+	return snapshot;
+}
+
+void reload_destroy( tz_snapshot_t* snapshot )
+{
+	tz_contact_index_destroy( &snapshot->index );
+
+	// contact strings are all released with the arena, or the cache
+	if( snapshot->contacts )
+	{
+		lc_vector_destroy( snapshot->contacts );
+	}
+	tz_arena_destroy( &snapshot->strings );
+	tz_cache_close( &snapshot->cache );
+	tz_zone_cache_destroy( &snapshot->zones );
+	free( snapshot );
+}
+
+const char* reload_name( const tz_reloader_t* reloader, size_t file )
+{
+	return reloader->sources[ file ];
+}
+
+/*
+ * The number of sources; before there are any, the number of files named.
+ */
+size_t reload_files( const tz_reloader_t* reloader )
+{
+	if( reloader->sources && lc_vector_size(reloader->sources) > 0 )
+	{
+		return lc_vector_size( reloader->sources );
+	}
+
+	return reloader->count > 0 ? reloader->count : 1;
+}
+
+void reload_stamp( const char* name, tz_reload_stamp_t* stamp )
+{
+	struct stat status;
+
+	memset( stamp, 0, sizeof(tz_reload_stamp_t) );
+
+	if( stat( name, &status ) == 0 )
+	{
+#if defined(_WIN32) || defined(_WIN64)
+		stamp->modified.tv_sec = status.st_mtime;
+#else
+		stamp->modified = status.st_mtim;
+#endif
+		stamp->size  = status.st_size;
+		stamp->inode = status.st_ino;
+	}
+}
+
+/*
+ * Replaces the sources with the ones a load resolved; the caller holds
+ * the lock. Sources that were already known keep the stamp taken before
+ * the load, so an edit made while it was reading is still noticed. New
+ * ones are stamped now. Without any sources, the old ones stay.
+ */
+void reload_adopt( tz_reloader_t* reloader, char** sources )
+{
+	size_t count = sources ? lc_vector_size( sources ) : 0;
+	tz_reload_stamp_t* stamps = count > 0 ? calloc( count, sizeof(tz_reload_stamp_t) ) : NULL;
+
+	if( !stamps )
+	{
+		reload_sources_destroy( sources );
+		return;
+	}
+
+	for( size_t file = 0; file < count; file++ )
+	{
+		size_t known = 0;
+
+		while( known < lc_vector_size(reloader->sources) && strcmp( reloader->sources[ known ], sources[ file ] ) != 0 )
+		{
+			known++;
+		}
+
+		if( known < lc_vector_size(reloader->sources) )
+		{
+			stamps[ file ] = reloader->stamps[ known ];
+		}
+		else
+		{
+			reload_stamp( sources[ file ], &stamps[ file ] );
+		}
+	}
+
+	reload_sources_destroy( reloader->sources );
+	free( reloader->stamps );
+
+	reloader->sources = sources;
+	reloader->stamps  = stamps;
+	reloader->source_generation += 1;
+}
+
+void reload_sources_destroy( char** sources )
+{
+	if( sources )
+	{
+		for( size_t file = 0; file < lc_vector_size(sources); file++ )
+		{
+			free( sources[ file ] );
+		}
+		lc_vector_destroy( sources );
+	}
+}
+
+#if !defined(_WIN32) && !defined(_WIN64)
+/*
+ * Watches the directory of each file, not the file itself: editors
+ * usually save by writing a new file and renaming it over the old one.
+ * An included directory is watched for files coming and going. This is
+ * redone whenever a load replaced the sources; it keeps to inotify's
+ * one watch per directory, so the directories that are still needed
+ * aren't watched anew.
+ */
+void reload_watch( tz_reloader_t* reloader )
+{
+#if defined(__linux__)
+	pthread_mutex_lock( &reloader->lock );
+
+	if( reloader->notify < 0 || (reloader->watches && reloader->watch_generation == reloader->source_generation) )
+	{
+		pthread_mutex_unlock( &reloader->lock );
+		return;
+	}
+
+	size_t count = reload_files( reloader );
+	tz_reload_watch_t* watches = calloc( count, sizeof(tz_reload_watch_t) );
+
+	for( size_t file = 0; watches && file < count; file++ )
+	{
+		char path[ PATH_MAX ];
+		struct stat status;
+
+		// Follow a link to where the edits actually happen.
+		if( !realpath( reload_name( reloader, file ), path ) )
+		{
+			snprintf( path, sizeof(path), "%s", reload_name( reloader, file ) );
+		}
+
+		if( stat( path, &status ) == 0 && S_ISDIR( status.st_mode ) )
+		{
+			watches[ file ].descriptor = inotify_add_watch( reloader->notify, path,
+			                                                IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_CREATE | IN_DELETE );
+		}
+		else
+		{
+			char directory[ PATH_MAX ];
+			char base[ PATH_MAX ];
+			snprintf( directory, sizeof(directory), "%s", path );
+			snprintf( base, sizeof(base), "%s", path );
+
+			watches[ file ].name       = string_dup( basename( base ) );
+			watches[ file ].descriptor = inotify_add_watch( reloader->notify, dirname( directory ),
+			                                                IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_DELETE );
+
+			if( !watches[ file ].name )
+			{
+				watches[ file ].descriptor = -1;
+			}
+		}
+
+		if( watches[ file ].descriptor < 0 )
+		{
+			// Checking every second still notices the changes.
+			reload_unwatch( watches, file + 1 );
+			watches = NULL;
+		}
+	}
+
+	if( !watches )
+	{
+		close( reloader->notify );
+		reloader->notify = -1;
+	}
+	else
+	{
+		// Directories no longer needed stop being watched.
+		for( size_t old = 0; old < reloader->watch_count; old++ )
+		{
+			bool needed = false;
+
+			for( size_t file = 0; file < count && !needed; file++ )
+			{
+				needed = watches[ file ].descriptor == reloader->watches[ old ].descriptor;
+			}
+
+			if( !needed )
+			{
+				inotify_rm_watch( reloader->notify, reloader->watches[ old ].descriptor );
+				reloader->watches[ old ].descriptor = -1;
+			}
+		}
+	}
+
+	reload_unwatch( reloader->watches, reloader->watch_count );
+	reloader->watches          = watches;
+	reloader->watch_count      = watches ? count : 0;
+	reloader->watch_generation = reloader->source_generation;
+
+	pthread_mutex_unlock( &reloader->lock );
+#endif
+}
+
+/*
+ * Frees the watches. The descriptors are left to the caller, or go with
+ * the inotify descriptor.
+ */
+void reload_unwatch( tz_reload_watch_t* watches, size_t count )
+{
+	if( watches )
+	{
+		for( size_t file = 0; file < count; file++ )
+		{
+			free( watches[ file ].name );
+		}
+		free( watches );
+	}
+}
+
+void* reload_run( void* argument )
+{
+	tz_reloader_t* reloader = argument;
+
+	for( ;; )
+	{
+		// After a load, the files it resolved are the ones watched.
+		reload_watch( reloader );
+
+		if( !reload_wait( reloader ) )
+		{
+			break;
+		}
+
+		tz_reloader_reload( reloader, false );
+	}
+
+	return NULL;
+}
+
+/*
+ * Waits for one of the files to change and then for the writes to
+ * settle. Without inotify, this just waits a second. Returns false when
+ * it is time to stop.
+ */
+bool reload_wait( tz_reloader_t* reloader )
+{
+	int ready = 0;
+
+	if( reloader->notify < 0 )
+	{
+		return reload_poll( reloader, 1000 ) >= 0;
+	}
+
+	while( ready == 0 )
+	{
+		ready = reload_poll( reloader, -1 );
+	}
+
+	// An editor may write in several steps.
+	for( int settle = 0; settle < 20 && ready > 0; settle++ )
+	{
+		ready = reload_poll( reloader, TZ_RELOAD_SETTLE_MS );
+	}
+
+	return ready >= 0;
+}
+
+/*
+ * Waits up to timeout milliseconds, or forever if negative. Returns -1
+ * when asked to stop, 1 if one of the files changed or there are new
+ * sources to watch, and 0 otherwise.
+ */
+int reload_poll( tz_reloader_t* reloader, int timeout )
+{
+	struct pollfd descriptors[ 2 ] = {
+		{ .fd = reloader->wake[ 0 ], .events = POLLIN },
+		{ .fd = reloader->notify,    .events = POLLIN }
+	};
+	nfds_t count = reloader->notify >= 0 ? 2 : 1;
+
+	if( poll( descriptors, count, timeout ) < 0 )
+	{
+		return errno == EINTR ? 0 : -1;
+	}
+
+	int changed = 0;
+
+	if( descriptors[ 0 ].revents )
+	{
+		// A NUL stops the thread; a 'w' brings it back to watch new sources.
+		char byte = '\0';
+
+		if( read( reloader->wake[ 0 ], &byte, 1 ) != 1 || byte != 'w' )
+		{
+			return -1;
+		}
+
+		changed = 1;
+	}
+
+#if defined(__linux__)
+	if( count == 2 && (descriptors[ 1 ].revents & POLLIN) )
+	{
+		union {
+			struct inotify_event event;
+			char bytes[ 4096 ];
+		} buffer;
+		ssize_t length;
+
+		while( (length = read( reloader->notify, buffer.bytes, sizeof(buffer) )) > 0 )
+		{
+			for( const char* p = buffer.bytes; p < buffer.bytes + length; )
+			{
+				const struct inotify_event* event = (const struct inotify_event*) p;
+
+				// Other files in the same directory, like the cache, are ignored.
+				for( size_t file = 0; file < reloader->watch_count; file++ )
+				{
+					const tz_reload_watch_t* watch = &reloader->watches[ file ];
+
+					if( event->wd == watch->descriptor && event->len > 0 &&
+					    (watch->name ? strcmp( event->name, watch->name ) == 0 : !tz_configuration_is_cache( event->name )) )
+					{
+						changed = 1;
+					}
+				}
+
+				if( event->mask & IN_Q_OVERFLOW )
+				{
+					changed = 1;
+				}
+
+				p += sizeof(struct inotify_event) + event->len;
+			}
+		}
+	}
+#endif
+
+	return changed;
+}
+#endif
@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 2019-2025, Joe Marrero. http://www.joemarrero.com/
+ * Copyright (C) 2017, End Point Corporation. http://www.endpoint.com/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef _TZ_RELOAD_H_
+#define _TZ_RELOAD_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <limits.h>
+#if !defined(_WIN32) && !defined(_WIN64)
+# include <pthread.h>
+# include <sys/stat.h>
+#endif
+#include "timezoner.h"
+#include "query.h"
+
+#define TZ_RELOAD_SETTLE_MS     (50)  /* quiet time after a change before rereading */
+
+/*
+ * Everything read from the configuration. Once published a snapshot
+ * never changes, so any number of readers can share it; readers resolve
+ * zones through their own copy of the zone cache.
+ */
+typedef struct tz_snapshot {
+	tz_zone_cache_t zones;        /* zone IDs of the contacts */
+	tz_arena_t strings;
+	tz_cache_t cache;
+	tz_load_stats_t load_stats;
+	timezone_contact_t* contacts; /* vector */
+	tz_contact_index_t index;     /* built on request, unless the cache brought one */
+	bool fallback;                /* a zone is computed by libc, which switches TZ */
+	unsigned int generation;
+	size_t references;            /* readers, plus one while published */
+} tz_snapshot_t;
+
+/*
+ * A configuration file, or a directory it includes, as it was when last
+ * read.
+ */
+typedef struct tz_reload_stamp {
+	struct timespec modified;
+	off_t size;
+	ino_t inode;
+} tz_reload_stamp_t;
+
+typedef struct tz_reload_watch {
+	int descriptor;               /* inotify watch of the file's directory, or of the included directory */
+	char* name;                   /* of the file within that directory; NULL for any file but a cache */
+} tz_reload_watch_t;
+
+/*
+ * Rereads the configuration when it changes and publishes each version
+ * as a new snapshot. Every file a load resolved, included ones too, is
+ * watched with inotify (or checked every second without it) from a
+ * thread of their own, so readers never wait for a parse. A
+ * configuration that fails to load leaves the last good snapshot
+ * published.
+ */
+typedef struct tz_reloader {
+	tz_app_t app;
+	const char** names;           /* configuration files; none for the home configuration */
+	size_t count;
+	char home_name[ PATH_MAX ];
+	int use_cache;
+	bool indexed;                 /* build a trigram index for each snapshot */
+	tz_snapshot_t* current;       /* swapped atomically */
+	size_t readers;               /* between loading current and referencing it */
+	unsigned int generation;
+	char** sources;               /* vector of the files and include directories the last load resolved */
+	tz_reload_stamp_t* stamps;    /* of each source */
+	unsigned int source_generation; /* counts the loads that replaced the sources */
+#if !defined(_WIN32) && !defined(_WIN64)
+	pthread_mutex_t lock;         /* one reload at a time; guards the sources */
+	pthread_t thread;
+	bool started;
+	int notify;                   /* inotify descriptor; -1 to poll */
+	tz_reload_watch_t* watches;   /* one per source; only touched by the thread */
+	size_t watch_count;
+	unsigned int watch_generation; /* of the sources being watched */
+	int wake[ 2 ];                /* stops the thread, or has it watch new sources */
+#endif
+} tz_reloader_t;
+
+bool                      tz_reloader_create     ( tz_reloader_t* reloader, const tz_app_t* app, const char** names, size_t count, int use_cache, bool indexed );
+void                      tz_reloader_destroy    ( tz_reloader_t* reloader );
+bool                      tz_reloader_reload     ( tz_reloader_t* reloader, bool forced );
+unsigned int              tz_reloader_generation ( const tz_reloader_t* reloader );
+tz_snapshot_t*            tz_snapshot_acquire    ( tz_reloader_t* reloader );
+void                      tz_snapshot_release    ( tz_snapshot_t* snapshot );
+bool                      tz_snapshot_zones      ( const tz_snapshot_t* snapshot, tz_zone_cache_t* zones, time_t now );
+const tz_contact_index_t* tz_snapshot_index      ( const tz_snapshot_t* snapshot );
+
+#endif /* _TZ_RELOAD_H_ */
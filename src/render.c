@@ -0,0 +1,463 @@
+/*
+ * Copyright (C) 2019-2025, Joe Marrero. http://www.joemarrero.com/
+ * Copyright (C) 2017, End Point Corporation. http://www.endpoint.com/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <stdlib.h>
+#include <limits.h>
+#include <string.h>
+#include <time.h>
+#include <wchar.h>
+#include <xtd/console.h>
+#include <collections/vector.h>
+#include "profile.h"
+#include "render.h"
+#include "text.h"
+
+#define RENDER_INITIAL_CAPACITY    (16 * 1024)
+#define RENDER_RESET               (256)
+
+static bool        render_reserve ( tz_render_t* render, size_t size );
+static void        render_append  ( tz_render_t* render, const char* bytes, size_t size );
+static size_t      render_encode  ( const tz_render_t* render, wchar_t c, char* out );
+static const char* render_escape  ( tz_render_t* render, int index );
+
+
+bool tz_render_create( tz_render_t* render, FILE* stream, size_t flush_threshold )
+{
+	*render = (tz_render_t) {
+		.stream           = stream,
+		.buffer           = malloc( RENDER_INITIAL_CAPACITY ),
+		.length           = 0,
+		.capacity         = RENDER_INITIAL_CAPACITY,
+		.flush_threshold  = flush_threshold,
+		.bytes_written    = 0,
+		.utf8             = false,
+		.error            = false,
+		.color            = TZ_RENDER_COLOR_DEFAULT,
+		.run_glyph        = L'\0',
+		.run_length       = 0,
+		.run_glyph_length = 0,
+		.clocks           = NULL
+	};
+
+	for( int i = 0; i <= RENDER_RESET; i++ )
+	{
+		render->escapes[ i ] = NULL;
+	}
+
+	// Encode directly when the locale is UTF-8; otherwise defer to wcrtomb().
+	char probe[ MB_LEN_MAX ];
+	mbstate_t state;
+	memset( &state, 0, sizeof(state) );
+	render->utf8 = wcrtomb( probe, L'\u2502', &state ) == 3 && memcmp( probe, "\xe2\x94\x82", 3 ) == 0;
+
+	return render->buffer != NULL;
+}
+
+void tz_render_destroy( tz_render_t* render )
+{
+	for( int i = 0; i <= RENDER_RESET; i++ )
+	{
+		free( render->escapes[ i ] );
+	}
+
+	if( render->clocks )
+	{
+		lc_vector_destroy( render->clocks );
+	}
+
+	free( render->buffer );
+	render->buffer = NULL;
+}
+
+/*
+ * Start recording where clocks are drawn (see tz_render_clock).
+ */
+bool tz_render_record( tz_render_t* render )
+{
+	if( !render->clocks )
+	{
+		lc_vector_create( render->clocks, 16 );
+	}
+
+	return render->clocks != NULL;
+}
+
+/*
+ * Discards the buffered frame without writing it.
+ */
+void tz_render_clear( tz_render_t* render )
+{
+	render->length = 0;
+	render->color  = TZ_RENDER_COLOR_DEFAULT;
+	render->error  = false;
+
+	if( render->clocks )
+	{
+		while( lc_vector_size(render->clocks) > 0 )
+		{
+			lc_vector_pop( render->clocks );
+		}
+	}
+}
+
+void tz_render_bytes( tz_render_t* render, const char* bytes, size_t size )
+{
+	render_append( render, bytes, size );
+}
+
+void tz_render_text( tz_render_t* render, const wchar_t* text )
+{
+	while( *text )
+	{
+		tz_render_char( render, *text++ );
+	}
+}
+
+void tz_render_char( tz_render_t* render, wchar_t c )
+{
+	if( c < 0x80 && render_reserve( render, 1 ) )
+	{
+		render->buffer[ render->length++ ] = (char) c;
+	}
+	else if( render_reserve( render, MB_LEN_MAX ) )
+	{
+		render->length += render_encode( render, c, render->buffer + render->length );
+	}
+}
+
+void tz_render_repeat( tz_render_t* render, wchar_t c, int count )
+{
+	if( count <= 0 )
+	{
+		return;
+	}
+
+	if( render->run_glyph != c || render->run_length == 0 )
+	{
+		// Pre-encode a run of the glyph; borders reuse the same one.
+		char glyph[ MB_LEN_MAX ];
+		size_t glyph_length = render_encode( render, c, glyph );
+
+		render->run_glyph        = c;
+		render->run_glyph_length = glyph_length;
+		render->run_length       = 0;
+
+		for( int i = 0; i < TZ_RENDER_RUN_LENGTH && glyph_length <= 4; i++ )
+		{
+			memcpy( render->run + render->run_length, glyph, glyph_length );
+			render->run_length += glyph_length;
+		}
+
+		if( render->run_length == 0 )
+		{
+			// Not representable as a short run; encode one at a time.
+			while( count-- > 0 )
+			{
+				render_append( render, glyph, glyph_length );
+			}
+			return;
+		}
+	}
+
+	while( count > 0 )
+	{
+		int glyphs = count < TZ_RENDER_RUN_LENGTH ? count : TZ_RENDER_RUN_LENGTH;
+		render_append( render, render->run, glyphs * render->run_glyph_length );
+		count -= glyphs;
+	}
+}
+
+/*
+ * Draws a string whose width in terminal columns is known, padded to
+ * the given width like the "%-*ls" conversion, but by columns rather
+ * than characters so that wide characters line up.
+ */
+void tz_render_field( tz_render_t* render, const wchar_t* s, int s_width, int width )
+{
+	while( *s )
+	{
+		tz_render_char( render, *s++ );
+	}
+
+	tz_render_repeat( render, L' ', width - s_width );
+}
+
+/*
+ * Draws as much of a string as fits in the given number of columns,
+ * like the "%-.*ls" conversion. A wide character that doesn't fit is
+ * left out and its column is padded instead.
+ */
+void tz_render_truncated( tz_render_t* render, const wchar_t* s, int columns )
+{
+	while( *s )
+	{
+		int width = tz_text_char_width( *s );
+
+		if( width > columns )
+		{
+			break;
+		}
+		tz_render_char( render, *s++ );
+		columns -= width;
+	}
+
+	if( *s )
+	{
+		tz_render_repeat( render, L' ', columns );
+	}
+}
+
+/*
+ * Equivalent to the "%-*s" conversion in a wide format string. The
+ * string is already in the locale's encoding so it is copied as is.
+ */
+void tz_render_string( tz_render_t* render, const char* s, int width )
+{
+	size_t length = strlen( s );
+	render_append( render, s, length );
+
+	if( width > 0 )
+	{
+		size_t count = mbstowcs( NULL, s, 0 );
+		if( count == (size_t) -1 )
+		{
+			count = length;
+		}
+
+		tz_render_repeat( render, L' ', width - (int) count );
+	}
+}
+
+/*
+ * Draws a zone's local time like tz_render_string() would.
+ */
+void tz_render_clock( tz_render_t* render, const tz_zone_t* zone, tz_zone_id_t id, const char* format, int width )
+{
+	char time_str[ 32 ];
+
+	if( strftime( time_str, sizeof(time_str), format, &zone->local_time ) == 0 )
+	{
+		time_str[ 0 ] = '\0';
+	}
+
+	if( render->clocks )
+	{
+		tz_render_clock_t clock = (tz_render_clock_t) {
+			.offset = render->length,
+			.length = strlen( time_str ),
+			.zone   = id,
+			.format = format
+		};
+		lc_vector_push( render->clocks, clock );
+	}
+
+	tz_render_string( render, time_str, width );
+}
+
+void tz_render_color( tz_render_t* render, int color )
+{
+	if( render->color != color && color >= 0 && color < RENDER_RESET )
+	{
+		const char* escape = render_escape( render, color );
+		render_append( render, escape, strlen(escape) );
+		render->color = color;
+	}
+}
+
+void tz_render_reset( tz_render_t* render )
+{
+	if( render->color != TZ_RENDER_COLOR_DEFAULT )
+	{
+		const char* escape = render_escape( render, RENDER_RESET );
+		render_append( render, escape, strlen(escape) );
+		render->color = TZ_RENDER_COLOR_DEFAULT;
+	}
+}
+
+bool tz_render_flush( tz_render_t* render )
+{
+	if( render->length > 0 && !render->error )
+	{
+		if( fwrite( render->buffer, 1, render->length, render->stream ) != render->length )
+		{
+			render->error = true;
+		}
+
+		fflush( render->stream );
+		render->bytes_written += render->length;
+		tz_profile_count( bytes_written, render->length );
+	}
+
+	render->length = 0;
+	return !render->error;
+}
+
+bool render_reserve( tz_render_t* render, size_t size )
+{
+	if( render->error )
+	{
+		return false;
+	}
+
+	if( render->length + size > render->capacity )
+	{
+		if( render->flush_threshold > 0 && render->length >= render->flush_threshold )
+		{
+			// Bound the memory used by very large frames.
+			tz_render_flush( render );
+
+			if( render->length + size <= render->capacity )
+			{
+				return !render->error;
+			}
+		}
+
+		size_t capacity = render->capacity * 2;
+		while( capacity < render->length + size )
+		{
+			capacity *= 2;
+		}
+
+		char* buffer = realloc( render->buffer, capacity );
+		if( !buffer )
+		{
+			render->error = true;
+			return false;
+		}
+
+		render->buffer   = buffer;
+		render->capacity = capacity;
+	}
+
+	return true;
+}
+
+void render_append( tz_render_t* render, const char* bytes, size_t size )
+{
+	if( render_reserve( render, size ) )
+	{
+		memcpy( render->buffer + render->length, bytes, size );
+		render->length += size;
+	}
+}
+
+size_t render_encode( const tz_render_t* render, wchar_t c, char* out )
+{
+	unsigned long cp = (unsigned long) c;
+
+	if( render->utf8 && cp < 0x110000 )
+	{
+		if( cp < 0x80 )
+		{
+			out[ 0 ] = (char) cp;
+			return 1;
+		}
+		else if( cp < 0x800 )
+		{
+			out[ 0 ] = (char) (0xC0 | (cp >> 6));
+			out[ 1 ] = (char) (0x80 | (cp & 0x3F));
+			return 2;
+		}
+		else if( cp < 0x10000 )
+		{
+			out[ 0 ] = (char) (0xE0 | (cp >> 12));
+			out[ 1 ] = (char) (0x80 | ((cp >> 6) & 0x3F));
+			out[ 2 ] = (char) (0x80 | (cp & 0x3F));
+			return 3;
+		}
+		else
+		{
+			out[ 0 ] = (char) (0xF0 | (cp >> 18));
+			out[ 1 ] = (char) (0x80 | ((cp >> 12) & 0x3F));
+			out[ 2 ] = (char) (0x80 | ((cp >> 6) & 0x3F));
+			out[ 3 ] = (char) (0x80 | (cp & 0x3F));
+			return 4;
+		}
+	}
+	else
+	{
+		mbstate_t state;
+		memset( &state, 0, sizeof(state) );
+		size_t length = wcrtomb( out, c, &state );
+
+		if( length == (size_t) -1 )
+		{
+			// not representable in this locale
+			out[ 0 ] = '?';
+			length = 1;
+		}
+
+		return length;
+	}
+}
+
+/*
+ * Escape sequences come from libxtd so they match what it would write to
+ * the terminal. They're captured from an in-memory stream the first
+ * time each one is needed.
+ */
+const char* render_escape( tz_render_t* render, int index )
+{
+	if( !render->escapes[ index ] )
+	{
+		char* escape = NULL;
+
+#if defined(_WIN32) || defined(_WIN64)
+		// Console colors aren't escape sequences on Windows.
+		escape = calloc( 1, 1 );
+#else
+		wchar_t* wide = NULL;
+		size_t wide_length = 0;
+		FILE* stream = open_wmemstream( &wide, &wide_length );
+
+		if( stream )
+		{
+			if( index == RENDER_RESET )
+			{
+				wconsole_reset( stream );
+			}
+			else
+			{
+				wconsole_fg_color_8( stream, index );
+			}
+			fclose( stream );
+
+			escape = malloc( wide_length * MB_LEN_MAX + 1 );
+			if( escape )
+			{
+				size_t length = 0;
+				for( size_t i = 0; i < wide_length; i++ )
+				{
+					length += render_encode( render, wide[ i ], escape + length );
+				}
+				escape[ length ] = '\0';
+			}
+
+			free( wide );
+		}
+#endif
+
+		render->escapes[ index ] = escape;
+	}
+
+	return render->escapes[ index ] ? render->escapes[ index ] : "";
+}
@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2019-2025, Joe Marrero. http://www.joemarrero.com/
+ * Copyright (C) 2017, End Point Corporation. http://www.endpoint.com/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef _TZ_RENDER_H_
+#define _TZ_RENDER_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <wchar.h>
+#include "zone.h"
+
+#define TZ_RENDER_COLOR_DEFAULT    (-1)
+#define TZ_RENDER_RUN_LENGTH       (64)
+
+/*
+ * A clock drawn into the frame. Watch mode uses these to redraw just the
+ * clocks between minute boundaries.
+ */
+typedef struct tz_render_clock {
+	size_t offset;        /* where the clock's text starts in the buffer */
+	size_t length;        /* bytes of text, excluding padding */
+	tz_zone_id_t zone;
+	const char* format;   /* strftime() format */
+} tz_render_clock_t;
+
+/*
+ * Builds a whole frame of output in one multibyte (normally UTF-8)
+ * buffer and writes it with a single call. Repeated glyphs are copied
+ * from a pre-encoded run, and color escapes are only emitted when the
+ * color actually changes. The output is byte-for-byte what the
+ * equivalent wprintf() calls would have produced.
+ */
+typedef struct tz_render {
+	FILE* stream;
+	char* buffer;
+	size_t length;
+	size_t capacity;
+	size_t flush_threshold;   /* flush early once this many bytes are buffered; 0 for never */
+	size_t bytes_written;
+	bool utf8;                /* the locale's encoding is UTF-8 */
+	bool error;
+	int color;                /* current foreground color */
+	char* escapes[ 257 ];     /* captured escape sequences; last one is the reset */
+	wchar_t run_glyph;
+	char run[ TZ_RENDER_RUN_LENGTH * 4 ];
+	size_t run_length;        /* bytes in run */
+	size_t run_glyph_length;  /* bytes in one glyph */
+	tz_render_clock_t* clocks; /* vector of clocks drawn; NULL unless recording */
+} tz_render_t;
+
+bool tz_render_create    ( tz_render_t* render, FILE* stream, size_t flush_threshold );
+void tz_render_destroy   ( tz_render_t* render );
+bool tz_render_record    ( tz_render_t* render );
+void tz_render_clear     ( tz_render_t* render );
+void tz_render_bytes     ( tz_render_t* render, const char* bytes, size_t size );
+void tz_render_text      ( tz_render_t* render, const wchar_t* text );
+void tz_render_char      ( tz_render_t* render, wchar_t c );
+void tz_render_repeat    ( tz_render_t* render, wchar_t c, int count );
+void tz_render_field     ( tz_render_t* render, const wchar_t* s, int s_width, int width );
+void tz_render_truncated ( tz_render_t* render, const wchar_t* s, int columns );
+void tz_render_string    ( tz_render_t* render, const char* s, int width );
+void tz_render_clock     ( tz_render_t* render, const tz_zone_t* zone, tz_zone_id_t id, const char* format, int width );
+void tz_render_color     ( tz_render_t* render, int color );
+void tz_render_reset     ( tz_render_t* render );
+bool tz_render_flush     ( tz_render_t* render );
+
+#endif /* _TZ_RENDER_H_ */
@@ -0,0 +1,327 @@
+/*
+ * Copyright (C) 2019-2025, Joe Marrero. http://www.joemarrero.com/
+ * Copyright (C) 2017, End Point Corporation. http://www.endpoint.com/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <xtd/console.h>
+#include "timezoner.h"
+#include "slot.h"
+
+/*
+ * Contacts that share a zone and working hours are always available at
+ * the same time, so they are only evaluated once.
+ */
+typedef struct slot_shift {
+	tz_zone_id_t zone;
+	short start;      /* minutes past local midnight */
+	short end;
+	size_t count;     /* contacts on this shift */
+} slot_shift_t;
+
+typedef struct slot_window {
+	size_t slot;      /* first slot of the window */
+	size_t available; /* contacts within working hours for the whole window */
+} slot_window_t;
+
+static int  slot_shift_compare  ( const void* l, const void* r );
+static int  slot_window_compare ( const void* l, const void* r );
+static void slot_print          ( tz_render_t* render, const tz_app_t* app, const slot_window_t* window, size_t length, time_t start, size_t total );
+
+
+/*
+ * Parses working hours given as HH:MM-HH:MM. Hours that end before they
+ * start span midnight.
+ */
+bool tz_slot_parse_hours( const char* s, short hours[ 2 ] )
+{
+	int start_hour, start_minute, end_hour, end_minute;
+	char extra;
+
+	if( sscanf( s, "%d:%d-%d:%d%c", &start_hour, &start_minute, &end_hour, &end_minute, &extra ) != 4 )
+	{
+		return false;
+	}
+
+	int start = start_hour * 60 + start_minute;
+	int end   = end_hour * 60 + end_minute;
+
+	if( start_hour < 0 || start_minute < 0 || start_minute > 59 || start >= 24 * 60 ||
+	    end_hour < 0 || end_minute < 0 || end_minute > 59 || end > 24 * 60 || start == end )
+	{
+		return false;
+	}
+
+	hours[ 0 ] = (short) start;
+	hours[ 1 ] = (short) end;
+	return true;
+}
+
+/*
+ * Sweeps the next app->slot_days days in 15 minute steps and ranks the
+ * meeting windows by how many contacts are within their working hours,
+ * Monday to Friday in their own zone. Offsets are computed per zone and
+ * step, so the cost doesn't grow with contacts times steps.
+ */
+bool tz_find_slots( tz_render_t* render, const tz_app_t* app, const timezone_contact_t* contacts )
+{
+	bool result = false;
+	const long step = TZ_SLOT_MINUTES * 60;
+	size_t contact_count = lc_vector_size( contacts );
+	size_t slot_count = (size_t) app->slot_days * (24 * 60 / TZ_SLOT_MINUTES);
+	size_t length = (app->slot_minutes + TZ_SLOT_MINUTES - 1) / TZ_SLOT_MINUTES;
+	time_t start = (app->now + step - 1) / step * step;
+
+	struct timespec search_start, search_end;
+	clock_gettime( CLOCK_MONOTONIC, &search_start );
+
+	if( length < 1 )
+	{
+		length = 1;
+	}
+
+	slot_shift_t* shifts = malloc( sizeof(slot_shift_t) * (contact_count + 1) );
+	short* minutes       = malloc( sizeof(short) * slot_count ); /* local minute of day, or -1 on weekends */
+	size_t* available    = calloc( slot_count + 1, sizeof(size_t) );
+	slot_window_t* windows = malloc( sizeof(slot_window_t) * (slot_count + 1) );
+	size_t shift_count = 0;
+	size_t window_count = 0;
+
+	if( !tz_check_alloc( app, shifts ) || !tz_check_alloc( app, minutes ) ||
+	    !tz_check_alloc( app, available ) || !tz_check_alloc( app, windows ) )
+	{
+		goto done;
+	}
+
+	for( size_t i = 0; i < contact_count; i++ )
+	{
+		shifts[ i ] = (slot_shift_t) {
+			.zone  = contacts[ i ].zone,
+			.start = contacts[ i ].working_hours[ 0 ] >= 0 ? contacts[ i ].working_hours[ 0 ] : app->working_hours[ 0 ],
+			.end   = contacts[ i ].working_hours[ 1 ] >= 0 ? contacts[ i ].working_hours[ 1 ] : app->working_hours[ 1 ],
+			.count = 1
+		};
+	}
+
+	qsort( shifts, contact_count, sizeof(slot_shift_t), slot_shift_compare );
+
+	for( size_t i = 0; i < contact_count; i++ )
+	{
+		if( shift_count > 0 && slot_shift_compare( &shifts[ shift_count - 1 ], &shifts[ i ] ) == 0 )
+		{
+			shifts[ shift_count - 1 ].count += 1;
+		}
+		else
+		{
+			shifts[ shift_count++ ] = shifts[ i ];
+		}
+	}
+
+	for( size_t i = 0; i < shift_count; i++ )
+	{
+		const slot_shift_t* shift = &shifts[ i ];
+
+		if( i == 0 || shift->zone != shifts[ i - 1 ].zone )
+		{
+			// Shifts are sorted by zone; local times are computed once per zone.
+			for( size_t slot = 0; slot < slot_count; slot++ )
+			{
+				tz_zone_t zone;
+
+				if( !tz_zone_cache_lookup( app->zones, shift->zone, start + (time_t) slot * step, &zone ) )
+				{
+					minutes[ slot ] = -1;
+				}
+				else if( zone.local_time.tm_wday == 0 || zone.local_time.tm_wday == 6 )
+				{
+					minutes[ slot ] = -1;
+				}
+				else
+				{
+					minutes[ slot ] = (short) (zone.local_time.tm_hour * 60 + zone.local_time.tm_min);
+				}
+			}
+		}
+
+		size_t run = 0;
+
+		for( size_t slot = 0; slot < slot_count; slot++ )
+		{
+			short minute = minutes[ slot ];
+			bool working;
+
+			if( minute < 0 )
+			{
+				working = false;
+			}
+			else if( shift->start < shift->end )
+			{
+				// A step is working time only if all of it is.
+				working = minute >= shift->start && minute + TZ_SLOT_MINUTES <= shift->end;
+			}
+			else
+			{
+				working = minute >= shift->start || minute + TZ_SLOT_MINUTES <= shift->end;
+			}
+
+			run = working ? run + 1 : 0;
+
+			if( run >= length )
+			{
+				available[ slot + 1 - length ] += shift->count;
+			}
+		}
+	}
+
+	for( size_t slot = 0; slot + length <= slot_count; slot++ )
+	{
+		if( available[ slot ] > 0 )
+		{
+			windows[ window_count++ ] = (slot_window_t) { .slot = slot, .available = available[ slot ] };
+		}
+	}
+
+	qsort( windows, window_count, sizeof(slot_window_t), slot_window_compare );
+
+	// The best windows, without overlapping ones.
+	size_t chosen = 0;
+
+	for( size_t i = 0; i < window_count && chosen < TZ_SLOT_RESULTS; i++ )
+	{
+		bool overlaps = false;
+
+		for( size_t j = 0; j < chosen && !overlaps; j++ )
+		{
+			size_t a = windows[ i ].slot;
+			size_t b = windows[ j ].slot;
+			overlaps = (a > b ? a - b : b - a) < length;
+		}
+
+		if( !overlaps )
+		{
+			windows[ chosen++ ] = windows[ i ];
+		}
+	}
+
+	clock_gettime( CLOCK_MONOTONIC, &search_end );
+
+	if( chosen == 0 )
+	{
+		tz_render_text( render, L"No meeting slot has anyone within working hours.\n" );
+	}
+
+	for( size_t i = 0; i < chosen; i++ )
+	{
+		slot_print( render, app, &windows[ i ], length, start, contact_count );
+	}
+
+	if( app->stats )
+	{
+		fprintf( stderr, "Searched %zu slots for %zu contacts on %zu shifts in %.3f ms.\n",
+		         slot_count, contact_count, shift_count,
+		         (search_end.tv_sec - search_start.tv_sec) * 1000.0 + (search_end.tv_nsec - search_start.tv_nsec) / 1e6 );
+	}
+
+	result = true;
+
+done:
+	free( windows );
+	free( available );
+	free( minutes );
+	free( shifts );
+	return result;
+}
+
+void slot_print( tz_render_t* render, const tz_app_t* app, const slot_window_t* window, size_t length, time_t start, size_t total )
+{
+	time_t begin = start + (time_t) window->slot * TZ_SLOT_MINUTES * 60;
+	time_t end   = begin + (time_t) length * TZ_SLOT_MINUTES * 60;
+	struct tm tm;
+	char begin_str[ 64 ];
+	char end_str[ 32 ];
+	char utc_str[ 32 ];
+	char count_str[ 64 ];
+
+	// Shown in our own zone, like -t is given.
+	localtime_r( &begin, &tm );
+	strftime( begin_str, sizeof(begin_str), "%a %b %d %I:%M %p", &tm );
+	localtime_r( &end, &tm );
+	strftime( end_str, sizeof(end_str), "%I:%M %p", &tm );
+	tz_zoneinfo_gmtime( begin, &tm );
+	strftime( utc_str, sizeof(utc_str), "(%H:%M UTC)", &tm );
+	snprintf( count_str, sizeof(count_str), "%zu of %zu available (%.0f%%)",
+	          window->available, total, total > 0 ? 100.0 * window->available / total : 0.0 );
+
+	if( !app->minimal )
+	{
+		tz_render_color( render, CONSOLE_COLOR8_BRIGHT_YELLOW );
+	}
+	tz_render_string( render, begin_str, 0 );
+	tz_render_text( render, L" - " );
+	tz_render_string( render, end_str, 0 );
+	tz_render_reset( render );
+	tz_render_text( render, L"  " );
+	tz_render_string( render, utc_str, 0 );
+	tz_render_text( render, L"  " );
+	if( !app->minimal )
+	{
+		tz_render_color( render, CONSOLE_COLOR8_BRIGHT_CYAN );
+	}
+	tz_render_string( render, count_str, 0 );
+	tz_render_reset( render );
+	tz_render_text( render, L"\n" );
+}
+
+int slot_shift_compare( const void* l, const void* r )
+{
+	const slot_shift_t* left  = l;
+	const slot_shift_t* right = r;
+
+	if( left->zone != right->zone )
+	{
+		return left->zone < right->zone ? -1 : 1;
+	}
+	else if( left->start != right->start )
+	{
+		return left->start - right->start;
+	}
+
+	return left->end - right->end;
+}
+
+int slot_window_compare( const void* l, const void* r )
+{
+	const slot_window_t* left  = l;
+	const slot_window_t* right = r;
+
+	if( left->available != right->available )
+	{
+		// Most available first...
+		return left->available > right->available ? -1 : 1;
+	}
+
+	// ...then the soonest.
+	return (left->slot > right->slot) - (left->slot < right->slot);
+}
@@ -0,0 +1,526 @@
+/*
+ * Copyright (C) 2019-2025, Joe Marrero. http://www.joemarrero.com/
+ * Copyright (C) 2017, End Point Corporation. http://www.endpoint.com/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <wchar.h>
+#include "store.h"
+
+#define STORE_INSERTION_SORT    (16)
+#define STORE_EXCLUDED          SIZE_MAX  /* group of a zone the query leaves out */
+
+/*
+ * Collation keys of the names, NUL terminated, in one pool.
+ */
+typedef struct store_keys {
+	unsigned char* pool;
+	size_t* offsets;           /* row -> key */
+	size_t size;
+	size_t capacity;
+} store_keys_t;
+
+typedef struct store_entry {
+	uint64_t prefix;           /* the next bytes of the key */
+	uint32_t row;
+} store_entry_t;
+
+static bool   store_reserve_zones  ( tz_contact_store_t* store, size_t zone_count );
+static bool   store_collate        ( store_keys_t* keys, const timezone_contact_t* contacts, size_t count );
+static size_t store_encode         ( unsigned char* bytes, wchar_t weight );
+static void   store_sort_keys      ( const store_keys_t* keys, store_entry_t* entries, size_t count, size_t depth );
+static void   store_fill_prefixes  ( const store_keys_t* keys, store_entry_t* entries, size_t count, size_t depth );
+static int    store_entry_compare  ( const store_keys_t* keys, const store_entry_t* left, const store_entry_t* right, size_t depth );
+static int    store_row_compare    ( const void* l, const void* r );
+static int    store_zone_compare   ( const void* l, const void* r );
+static bool   store_group_destroy  ( void *p_key, void *p_value );
+static int    store_group_compare  ( const void *p_key_left, const void *p_key_right );
+
+
+bool tz_contact_store_create( tz_contact_store_t* store, const timezone_contact_t* contacts )
+{
+	size_t count = lc_vector_size( contacts );
+	store_entry_t* entries = malloc( sizeof(store_entry_t) * (count + 1) );
+	store_keys_t keys = { NULL, NULL, 0, 0 };
+
+	memset( store, 0, sizeof(*store) );
+	store->contacts = contacts;
+	store->count    = count;
+	store->zones    = malloc( sizeof(tz_zone_id_t) * (count + 1) );
+	store->by_name  = malloc( sizeof(uint32_t) * (count + 1) );
+	store->rows     = malloc( sizeof(uint32_t) * (count + 1) );
+
+	if( !entries || !store->zones || !store->by_name || !store->rows ||
+	    !store_collate( &keys, contacts, count ) )
+	{
+		free( entries );
+		free( keys.pool );
+		free( keys.offsets );
+		tz_contact_store_destroy( store );
+		return false;
+	}
+
+	for( uint32_t row = 0; row < count; row++ )
+	{
+		store->zones[ row ] = contacts[ row ].zone;
+
+		entries[ row ] = (store_entry_t) {
+			.prefix = 0,
+			.row    = row
+		};
+	}
+
+	// Names don't change with the time, so they are only sorted once.
+	store_fill_prefixes( &keys, entries, count, 0 );
+	store_sort_keys( &keys, entries, count, 0 );
+
+	for( size_t i = 0; i < count; i++ )
+	{
+		store->by_name[ i ] = entries[ i ].row;
+	}
+
+	free( entries );
+	free( keys.pool );
+	free( keys.offsets );
+	return true;
+}
+
+void tz_contact_store_destroy( tz_contact_store_t* store )
+{
+	free( store->zones );
+	free( store->by_name );
+	free( store->rows );
+	free( store->zone_order );
+	free( store->zone_groups );
+	free( store->group_starts );
+	free( store->group_ends );
+	memset( store, 0, sizeof(*store) );
+}
+
+/*
+ * Creates the map that tz_organize_data() fills in: each group's
+ * seconds-of-day or UTC offset maps to a vector of its contacts.
+ */
+bool tz_organize_map_create( lc_tree_map_t* map )
+{
+	return lc_tree_map_create( map, store_group_destroy, store_group_compare, malloc, free );
+}
+
+/*
+ * Groups the contacts by the local time (or UTC offset) of their zone,
+ * each group sorted by name. Zones are resolved once each; the rows are
+ * then scattered into their groups in name order, which keeps every
+ * group sorted without comparing anything. Rows of zones that fail the
+ * query's offset or hour terms (if any) are left out.
+ */
+bool tz_organize_data( tz_contact_store_t* store, lc_tree_map_t* map, tz_zone_cache_t* zones, bool organize_by_time, const tz_query_t* query )
+{
+	size_t zone_count = tz_zone_cache_size( zones );
+	size_t group_count = 0;
+
+	if( !store_reserve_zones( store, zone_count ) )
+	{
+		return false;
+	}
+
+	for( tz_zone_id_t id = 0; id < zone_count; id++ )
+	{
+		const tz_zone_t* zone = tz_zone_cache_resolve( zones, id );
+
+		store->zone_order[ id ] = (tz_store_zone_t) {
+			.key      = organize_by_time ? tz_zone_seconds_of_day( zone ) : zone->utc_offset,
+			.id       = id,
+			.excluded = !tz_query_match_zone( query, zone )
+		};
+	}
+
+	// Zones with the same key share a group.
+	qsort( store->zone_order, zone_count, sizeof(tz_store_zone_t), store_zone_compare );
+
+	for( size_t i = 0; i < zone_count; i++ )
+	{
+		if( i > 0 && store->zone_order[ i ].key != store->zone_order[ i - 1 ].key )
+		{
+			group_count += 1;
+		}
+
+		store->zone_groups[ store->zone_order[ i ].id ] = store->zone_order[ i ].excluded ? STORE_EXCLUDED : group_count;
+	}
+	group_count += zone_count > 0;
+
+	memset( store->group_ends, 0, sizeof(size_t) * group_count );
+
+	for( size_t row = 0; row < store->count; row++ )
+	{
+		size_t group = store->zone_groups[ store->zones[ row ] ];
+
+		if( group != STORE_EXCLUDED )
+		{
+			store->group_ends[ group ] += 1;
+		}
+	}
+
+
+	size_t start = 0;
+	for( size_t group = 0; group < group_count; group++ )
+	{
+		size_t size = store->group_ends[ group ];
+
+		store->group_starts[ group ] = start;
+		store->group_ends[ group ]   = start;
+		start += size;
+	}
+
+	// group_ends is the insertion point until every row is placed.
+	for( size_t i = 0; i < store->count; i++ )
+	{
+		uint32_t row = store->by_name[ i ];
+		size_t group = store->zone_groups[ store->zones[ row ] ];
+
+		if( group != STORE_EXCLUDED )
+		{
+			store->rows[ store->group_ends[ group ]++ ] = row;
+		}
+	}
+
+	size_t zone = 0;
+	for( size_t group = 0; group < group_count; group++ )
+	{
+		const uint32_t* rows = store->rows + store->group_starts[ group ];
+		size_t count = store->group_ends[ group ] - store->group_starts[ group ];
+		intptr_t group_key = store->zone_order[ zone ].key;
+
+		while( zone < zone_count && store->zone_order[ zone ].key == group_key )
+		{
+			zone++;
+		}
+
+		if( count == 0 )
+		{
+			continue;
+		}
+
+		lc_tree_map_iterator_t itr = lc_tree_map_find( map, (void*) group_key );
+		timezone_contact_t const ** list = NULL;
+
+		if( itr != lc_tree_map_end() )
+		{
+			list = itr->value;
+		}
+		else
+		{
+			lc_vector_create( list, count );
+			if( !list || !lc_tree_map_insert( map, (void*) group_key, list ) )
+			{
+				lc_vector_destroy( list );
+				return false;
+			}
+			itr = lc_tree_map_find( map, (void*) group_key );
+		}
+
+		for( size_t i = 0; i < count; i++ )
+		{
+			lc_vector_push( list, &store->contacts[ rows[ i ] ] );
+		}
+
+		/* list is relocatable in memory as vector grows. */
+		itr->value = list;
+	}
+
+	return true;
+}
+
+bool store_reserve_zones( tz_contact_store_t* store, size_t zone_count )
+{
+	if( zone_count <= store->zone_capacity )
+	{
+		return true;
+	}
+
+	tz_store_zone_t* zone_order = realloc( store->zone_order, sizeof(tz_store_zone_t) * zone_count );
+	if( zone_order ) store->zone_order = zone_order;
+	size_t* zone_groups = realloc( store->zone_groups, sizeof(size_t) * zone_count );
+	if( zone_groups ) store->zone_groups = zone_groups;
+	size_t* group_starts = realloc( store->group_starts, sizeof(size_t) * zone_count );
+	if( group_starts ) store->group_starts = group_starts;
+	size_t* group_ends = realloc( store->group_ends, sizeof(size_t) * zone_count );
+	if( group_ends ) store->group_ends = group_ends;
+
+	if( !zone_order || !zone_groups || !group_starts || !group_ends )
+	{
+		return false;
+	}
+
+	store->zone_capacity = zone_count;
+	return true;
+}
+
+/*
+ * Transforms every name with wcsxfrm() so that the names sort in the
+ * order of the locale's LC_COLLATE with plain byte comparisons. Each
+ * weight is written with an order preserving, UTF-8 like encoding.
+ */
+bool store_collate( store_keys_t* keys, const timezone_contact_t* contacts, size_t count )
+{
+	wchar_t* weights = NULL;
+	size_t weights_size = 0;
+	bool result = false;
+
+	keys->offsets = malloc( sizeof(size_t) * (count + 1) );
+	if( !keys->offsets )
+	{
+		goto done;
+	}
+
+	for( size_t row = 0; row < count; row++ )
+	{
+		const wchar_t* name = contacts[ row ].name;
+		size_t length = wcsxfrm( weights, name, weights_size );
+
+		if( length >= weights_size )
+		{
+			weights_size = length + 64;
+			wchar_t* grown = realloc( weights, sizeof(wchar_t) * weights_size );
+			if( !grown )
+			{
+				goto done;
+			}
+
+			weights = grown;
+			length = wcsxfrm( weights, name, weights_size );
+		}
+
+		// Up to six bytes per weight, and the terminator.
+		if( keys->size + 6 * length + 1 > keys->capacity )
+		{
+			size_t capacity = keys->capacity > 0 ? keys->capacity * 2 : 64 * 1024;
+			while( capacity < keys->size + 6 * length + 1 )
+			{
+				capacity *= 2;
+			}
+
+			unsigned char* grown = realloc( keys->pool, capacity );
+			if( !grown )
+			{
+				goto done;
+			}
+
+			keys->pool     = grown;
+			keys->capacity = capacity;
+		}
+
+		keys->offsets[ row ] = keys->size;
+
+		for( size_t i = 0; i < length; i++ )
+		{
+			keys->size += store_encode( keys->pool + keys->size, weights[ i ] );
+		}
+
+		keys->pool[ keys->size++ ] = '\0';
+	}
+
+	result = true;
+
+done:
+	free( weights );
+	return result;
+}
+
+/*
+ * Encodes a weight in one to six bytes. Like UTF-8 (as it was first
+ * defined, for 31 bits) the encodings compare in the order of the
+ * weights, and a zero byte never appears.
+ */
+size_t store_encode( unsigned char* bytes, wchar_t weight )
+{
+	uint32_t w = (uint32_t) weight;
+
+	if( w == 0 )
+	{
+		w = 1;
+	}
+	else if( w > 0x7FFFFFFF )
+	{
+		w = 0x7FFFFFFF;
+	}
+
+	if( w < 0x80 )
+	{
+		bytes[ 0 ] = w;
+		return 1;
+	}
+
+	size_t length = w < 0x800 ? 2 : w < 0x10000 ? 3 : w < 0x200000 ? 4 : w < 0x4000000 ? 5 : 6;
+
+	for( size_t i = length - 1; i > 0; i-- )
+	{
+		bytes[ i ] = 0x80 | (w & 0x3F);
+		w >>= 6;
+	}
+	bytes[ 0 ] = (unsigned char) (0xFF00 >> length) | w;
+
+	return length;
+}
+
+/*
+ * A three-way radix quicksort (Bentley and Sedgewick) of the collation
+ * keys. Each entry caches the next eight bytes of its key, so
+ * partitioning runs over the entries alone; a key is only read again
+ * when a whole run of entries ties on those bytes.
+ */
+void store_sort_keys( const store_keys_t* keys, store_entry_t* entries, size_t count, size_t depth )
+{
+	while( count > STORE_INSERTION_SORT )
+	{
+		uint64_t a = entries[ 0 ].prefix;
+		uint64_t b = entries[ count / 2 ].prefix;
+		uint64_t c = entries[ count - 1 ].prefix;
+		uint64_t pivot = a < b ? (b < c ? b : (a < c ? c : a)) : (a < c ? a : (b < c ? c : b));
+
+		size_t less = 0;
+		size_t i = 0;
+		size_t greater = count;
+
+		while( i < greater )
+		{
+			uint64_t prefix = entries[ i ].prefix;
+			store_entry_t swap;
+
+			if( prefix < pivot )
+			{
+				swap = entries[ less ]; entries[ less++ ] = entries[ i ]; entries[ i++ ] = swap;
+			}
+			else if( prefix > pivot )
+			{
+				swap = entries[ --greater ]; entries[ greater ] = entries[ i ]; entries[ i ] = swap;
+			}
+			else
+			{
+				i++;
+			}
+		}
+
+		store_sort_keys( keys, entries, less, depth );
+
+		if( (pivot & 0xFF) != 0 )
+		{
+			store_fill_prefixes( keys, entries + less, greater - less, depth + sizeof(uint64_t) );
+			store_sort_keys( keys, entries + less, greater - less, depth + sizeof(uint64_t) );
+		}
+		else
+		{
+			// The keys ended; equal names keep the order they were loaded in.
+			qsort( entries + less, greater - less, sizeof(store_entry_t), store_row_compare );
+		}
+
+		entries += greater;
+		count   -= greater;
+	}
+
+	for( size_t i = 1; i < count; i++ )
+	{
+		store_entry_t entry = entries[ i ];
+		size_t j = i;
+
+		while( j > 0 && store_entry_compare( keys, &entry, &entries[ j - 1 ], depth ) < 0 )
+		{
+			entries[ j ] = entries[ j - 1 ];
+			j--;
+		}
+
+		entries[ j ] = entry;
+	}
+}
+
+/*
+ * Loads the eight key bytes at depth into each entry, big-endian and
+ * zero padded past the end of the key. Every key is at least depth
+ * bytes long.
+ */
+void store_fill_prefixes( const store_keys_t* keys, store_entry_t* entries, size_t count, size_t depth )
+{
+	for( size_t i = 0; i < count; i++ )
+	{
+		const unsigned char* key = keys->pool + keys->offsets[ entries[ i ].row ] + depth;
+		uint64_t prefix = 0;
+
+		for( size_t j = 0; j < sizeof(uint64_t); j++ )
+		{
+			prefix = (prefix << 8) | *key;
+			key += *key != '\0';
+		}
+
+		entries[ i ].prefix = prefix;
+	}
+}
+
+int store_entry_compare( const store_keys_t* keys, const store_entry_t* left, const store_entry_t* right, size_t depth )
+{
+	int result = strcmp( (const char*) keys->pool + keys->offsets[ left->row ] + depth,
+	                     (const char*) keys->pool + keys->offsets[ right->row ] + depth );
+
+	if( result != 0 )
+	{
+		return result;
+	}
+
+	return (left->row > right->row) - (left->row < right->row);
+}
+
+int store_row_compare( const void* l, const void* r )
+{
+	const store_entry_t* left  = l;
+	const store_entry_t* right = r;
+	return (left->row > right->row) - (left->row < right->row);
+}
+
+int store_zone_compare( const void* l, const void* r )
+{
+	const tz_store_zone_t* left  = l;
+	const tz_store_zone_t* right = r;
+	return (left->key > right->key) - (left->key < right->key);
+}
+
+bool store_group_destroy( void *p_key, void *p_value )
+{
+	// The key is the group's seconds-of-day or UTC offset; nothing to free.
+	timezone_contact_t** list = p_value;
+
+	if( list )
+	{
+		while(lc_vector_size(list) > 0)
+		{
+			lc_vector_pop(list);
+		}
+
+		lc_vector_destroy(list);
+	}
+
+	return true;
+}
+
+int store_group_compare( const void *p_key_left, const void *p_key_right )
+{
+	intptr_t l = (intptr_t) p_key_left;
+	intptr_t r = (intptr_t) p_key_right;
+	return (l > r) - (l < r);
+}
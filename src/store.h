@@ -0,0 +1,65 @@
+/*
+ * Copyright (C) 2019-2025, Joe Marrero. http://www.joemarrero.com/
+ * Copyright (C) 2017, End Point Corporation. http://www.endpoint.com/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef _TZ_STORE_H_
+#define _TZ_STORE_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <collections/tree-map.h>
+#include "timezoner.h"
+#include "query.h"
+#include "zone.h"
+
+typedef struct tz_store_zone {
+	long key;                  /* seconds of day or UTC offset */
+	tz_zone_id_t id;
+	bool excluded;             /* left out by the query at this instant */
+} tz_store_zone_t;
+
+/*
+ * A columnar view of the contacts for grouping and sorting. The rows are
+ * put in name order once, by the locale's collation, when the store is
+ * created; grouping is then a stable counting sort over the dense
+ * columns that never compares names and never touches the contact
+ * records until the groups are collected.
+ */
+typedef struct tz_contact_store {
+	const timezone_contact_t* contacts; /* row -> string fields */
+	size_t count;
+	tz_zone_id_t* zones;                /* row -> zone ID */
+	uint32_t* by_name;                  /* rows in collation order of their names */
+	uint32_t* rows;                     /* rows sorted by group, then name */
+	tz_store_zone_t* zone_order;        /* zones ordered by group key */
+	size_t* zone_groups;                /* zone ID -> group index */
+	size_t* group_starts;               /* group index -> first row */
+	size_t* group_ends;                 /* group index -> one past its last row */
+	size_t zone_capacity;
+} tz_contact_store_t;
+
+bool tz_contact_store_create  ( tz_contact_store_t* store, const timezone_contact_t* contacts );
+void tz_contact_store_destroy ( tz_contact_store_t* store );
+bool tz_organize_map_create   ( lc_tree_map_t* map );
+bool tz_organize_data         ( tz_contact_store_t* store, lc_tree_map_t* map, tz_zone_cache_t* zones, bool organize_by_time, const tz_query_t* query );
+
+#endif /* _TZ_STORE_H_ */
@@ -0,0 +1,181 @@
+/*
+ * Copyright (C) 2019-2025, Joe Marrero. http://www.joemarrero.com/
+ * Copyright (C) 2017, End Point Corporation. http://www.endpoint.com/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#define _XOPEN_SOURCE 700 /* wcwidth() */
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <wchar.h>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#include "text.h"
+
+static int text_wcwidth ( wchar_t c );
+
+
+/*
+ * Counts the bytes before the first non-ASCII one. Contact fields are
+ * mostly ASCII, so this is how decoding skips ahead: sixteen bytes at a
+ * time with SSE2, or eight at a time in a word otherwise.
+ */
+size_t tz_text_ascii( const char* s, size_t length )
+{
+	size_t i = 0;
+
+#if defined(__SSE2__)
+	for( ; i + 16 <= length; i += 16 )
+	{
+		int high = _mm_movemask_epi8( _mm_loadu_si128( (const __m128i*) (s + i) ) );
+
+		if( high )
+		{
+			return i + __builtin_ctz( high );
+		}
+	}
+#else
+	for( ; i + 8 <= length; i += 8 )
+	{
+		uint64_t word;
+		memcpy( &word, s + i, sizeof(word) );
+
+		if( word & UINT64_C(0x8080808080808080) )
+		{
+			break;
+		}
+	}
+#endif
+
+	while( i < length && (unsigned char) s[ i ] < 0x80 )
+	{
+		i++;
+	}
+
+	return i;
+}
+
+/*
+ * The terminal columns taken by a character, like wcwidth(), except
+ * that characters without a width count as one column as they did
+ * before widths were measured.
+ */
+int tz_text_char_width( wchar_t c )
+{
+	if( (unsigned long) c < 0x7F )
+	{
+		return 1;
+	}
+
+	int width = text_wcwidth( c );
+	return width < 0 ? 1 : width;
+}
+
+unsigned short tz_text_width( const wchar_t* s )
+{
+	size_t width = 0;
+
+	for( ; *s; s++ )
+	{
+		width += tz_text_char_width( *s );
+	}
+
+	return width > TZ_TEXT_WIDTH_MAX ? TZ_TEXT_WIDTH_MAX : (unsigned short) width;
+}
+
+/*
+ * Widens a multibyte string of the given length into the arena and
+ * measures its width in terminal columns, in a single pass. Runs of
+ * ASCII are copied as they are and are one column per character; only
+ * the other characters go through mbrtowc() and wcwidth(). Bytes that
+ * are not valid in the locale's encoding become '?'.
+ */
+wchar_t* tz_text_widen( tz_arena_t* arena, const char* s, size_t length, unsigned short* width )
+{
+	// There are never more characters than bytes.
+	wchar_t* ws = tz_arena_alloc( arena, sizeof(wchar_t) * (length + 1) );
+	size_t count = 0;
+	size_t columns = 0;
+	mbstate_t state;
+
+	if( !ws )
+	{
+		return NULL;
+	}
+
+	memset( &state, 0, sizeof(state) );
+
+	for( size_t i = 0; i < length; )
+	{
+		size_t ascii = tz_text_ascii( s + i, length - i );
+
+		for( size_t j = 0; j < ascii; j++ )
+		{
+			ws[ count + j ] = (unsigned char) s[ i + j ];
+		}
+		count   += ascii;
+		columns += ascii;
+		i       += ascii;
+
+		if( i < length )
+		{
+			wchar_t c;
+			size_t size = mbrtowc( &c, s + i, length - i, &state );
+
+			if( size == (size_t) -1 || size == (size_t) -2 || size == 0 )
+			{
+				memset( &state, 0, sizeof(state) );
+				c = L'?';
+				size = 1;
+			}
+
+			ws[ count++ ] = c;
+			columns += tz_text_char_width( c );
+			i += size;
+		}
+	}
+
+	ws[ count ] = L'\0';
+	*width = columns > TZ_TEXT_WIDTH_MAX ? TZ_TEXT_WIDTH_MAX : (unsigned short) columns;
+
+	return ws;
+}
+
+int text_wcwidth( wchar_t c )
+{
+#if defined(_WIN32) || defined(_WIN64)
+	// No wcwidth(); combining marks take no columns and East Asian wide
+	// characters take two.
+	if( (c >= 0x0300 && c <= 0x036F) || (c >= 0x200B && c <= 0x200F) )
+	{
+		return 0;
+	}
+	if( (c >= 0x1100 && c <= 0x115F) || (c >= 0x2E80 && c <= 0xA4CF) || (c >= 0xAC00 && c <= 0xD7A3) ||
+	    (c >= 0xF900 && c <= 0xFAFF) || (c >= 0xFE30 && c <= 0xFE4F) || (c >= 0xFF00 && c <= 0xFF60) ||
+	    (c >= 0xFFE0 && c <= 0xFFE6) )
+	{
+		return 2;
+	}
+	return 1;
+#else
+	return wcwidth( c );
+#endif
+}
@@ -0,0 +1,429 @@
+/*
+ * Copyright (C) 2019-2025, Joe Marrero. http://www.joemarrero.com/
+ * Copyright (C) 2017, End Point Corporation. http://www.endpoint.com/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#define __USE_XOPEN
+#include <time.h>
+#include "timezoner.h"
+#include "format.h"
+#include "timeline.h"
+#include "zoneinfo.h"
+
+static void   timeline_zone    ( tz_render_t* render, tz_format_t format, const tz_zone_t* zone );
+static void   timeline_contact ( tz_render_t* render, tz_format_t format, const timezone_contact_t* contact );
+static time_t timeline_timegm  ( struct tm* tm );
+static bool   timeline_clock   ( const char* s, time_t now, int days, time_t* t );
+
+
+/*
+ * Parses an instant on the timeline: "now", "@<seconds since the epoch>"
+ * or an ISO 8601 date and time. Times are local unless they end in 'Z'.
+ */
+bool tz_timeline_parse_instant( const char* s, time_t now, time_t* t )
+{
+	const char* formats[] = {
+		"%Y-%m-%dT%H:%M:%S",
+		"%Y-%m-%dT%H:%M",
+		"%Y-%m-%d %H:%M:%S",
+		"%Y-%m-%d %H:%M",
+		"%Y-%m-%d"
+	};
+
+	if( strcmp( s, "now" ) == 0 )
+	{
+		*t = now;
+		return true;
+	}
+
+	if( *s == '@' )
+	{
+		char* end = NULL;
+		long long seconds = strtoll( s + 1, &end, 10 );
+
+		*t = (time_t) seconds;
+		return end != s + 1 && *end == '\0';
+	}
+
+	for( size_t i = 0; i < sizeof(formats) / sizeof(formats[0]); i++ )
+	{
+		struct tm tm;
+		memset( &tm, 0, sizeof(tm) );
+
+		const char* end = strptime( s, formats[ i ], &tm );
+		if( end && (*end == '\0' || (end[ 0 ] == 'Z' && end[ 1 ] == '\0')) )
+		{
+			tm.tm_isdst = -1;
+			*t = *end == 'Z' ? timeline_timegm( &tm ) : mktime( &tm );
+			return *t != (time_t) -1;
+		}
+	}
+
+	return false;
+}
+
+/*
+ * Parses a time of day for -t, such as "1:35 PM", "9am" or "13:35:10",
+ * on the same day as now.
+ */
+bool tz_timeline_parse_clock( const char* s, time_t now, time_t* t )
+{
+	return timeline_clock( s, now, 0, t );
+}
+
+/*
+ * Parses one time for -t: a time of day, "tomorrow" and a time of day,
+ * an offset from now such as "+3h" or "-30m", or any instant that
+ * tz_timeline_parse_instant() takes.
+ */
+bool tz_timeline_parse_time( const char* s, time_t now, time_t* t )
+{
+	long seconds;
+
+	if( (*s == '+' || *s == '-') && tz_timeline_parse_step( s + 1, &seconds ) )
+	{
+		*t = *s == '+' ? now + seconds : now - seconds;
+		return true;
+	}
+
+	if( strncmp( s, "tomorrow ", 9 ) == 0 )
+	{
+		return timeline_clock( s + 9, now, 1, t );
+	}
+
+	return timeline_clock( s, now, 0, t ) || tz_timeline_parse_instant( s, now, t );
+}
+
+/*
+ * Parses the argument of -t into instants appended to times: a single
+ * time or a range, START..END[/STEP], with an hour between instants
+ * unless a step is given.
+ */
+bool tz_timeline_parse_times( const char* s, time_t now, time_t* times, size_t capacity, size_t* count )
+{
+	const char* range = strstr( s, ".." );
+
+	if( !range )
+	{
+		time_t t;
+
+		if( *count >= capacity || !tz_timeline_parse_time( s, now, &t ) )
+		{
+			return false;
+		}
+		times[ (*count)++ ] = t;
+		return true;
+	}
+
+	char start_text[ 64 ];
+	char end_text[ 64 ];
+	const char* step_text = strrchr( range + 2, '/' );
+	size_t start_length = range - s;
+	size_t end_length = step_text ? (size_t) (step_text - (range + 2)) : strlen( range + 2 );
+	time_t start;
+	time_t end;
+	long step = 60 * 60;
+
+	if( start_length >= sizeof(start_text) || end_length >= sizeof(end_text) )
+	{
+		return false;
+	}
+	memcpy( start_text, s, start_length );
+	start_text[ start_length ] = '\0';
+	memcpy( end_text, range + 2, end_length );
+	end_text[ end_length ] = '\0';
+
+	if( !tz_timeline_parse_time( start_text, now, &start ) || !tz_timeline_parse_time( end_text, now, &end ) ||
+	    end < start || (step_text && !tz_timeline_parse_step( step_text + 1, &step )) )
+	{
+		return false;
+	}
+
+	for( time_t t = start; t <= end; t += step )
+	{
+		if( *count >= capacity )
+		{
+			return false;
+		}
+		times[ (*count)++ ] = t;
+	}
+
+	return true;
+}
+
+/*
+ * Parses a step such as "900", "15m", "1h" or "1d".
+ */
+bool tz_timeline_parse_step( const char* s, long* seconds )
+{
+	char* end = NULL;
+	long value = strtol( s, &end, 10 );
+	long unit = 1;
+
+	if( end == s || value <= 0 )
+	{
+		return false;
+	}
+
+	switch( *end )
+	{
+		case '\0':
+		case 's': unit = 1; break;
+		case 'm': unit = 60; break;
+		case 'h': unit = 60 * 60; break;
+		case 'd': unit = 24 * 60 * 60; break;
+		default: return false;
+	}
+
+	if( *end != '\0' && end[ 1 ] != '\0' )
+	{
+		return false;
+	}
+
+	*seconds = value * unit;
+	return true;
+}
+
+/*
+ * Writes a record for every contact at every instant from the start to
+ * the end of the timeline. Each record is three preformatted pieces:
+ * the instant, the contact's zone at that instant and the contact's own
+ * columns. Zones are looked up in their transition tables once per
+ * instant, so the work per record is just copying bytes. Records are
+ * streamed through the render, which flushes as it fills up.
+ */
+bool tz_timeline( tz_render_t* render, const tz_app_t* app, const timezone_contact_t* contacts )
+{
+	bool result = false;
+	tz_format_t format = app->format == TZ_FORMAT_TEXT ? TZ_FORMAT_CSV : app->format;
+	size_t contact_count = lc_vector_size( contacts );
+	size_t zone_count = tz_zone_cache_size( app->zones );
+	size_t* contact_offsets = malloc( sizeof(size_t) * (contact_count + 1) );
+	size_t* zone_offsets = malloc( sizeof(size_t) * (zone_count + 1) );
+	tz_render_t contact_text;
+	tz_render_t zone_text;
+	bool contact_text_created = tz_render_create( &contact_text, NULL, 0 );
+	bool zone_text_created = tz_render_create( &zone_text, NULL, 0 );
+	size_t records = 0;
+
+	struct timespec export_start, export_end;
+	clock_gettime( CLOCK_MONOTONIC, &export_start );
+
+	if( !tz_check_alloc( app, contact_offsets ) || !tz_check_alloc( app, zone_offsets ) ||
+	    !tz_check_alloc( app, contact_text_created ? &contact_text : NULL ) ||
+	    !tz_check_alloc( app, zone_text_created ? &zone_text : NULL ) )
+	{
+		goto done;
+	}
+
+	for( size_t i = 0; i < contact_count; i++ )
+	{
+		contact_offsets[ i ] = contact_text.length;
+		timeline_contact( &contact_text, format, &contacts[ i ] );
+	}
+	contact_offsets[ contact_count ] = contact_text.length;
+
+	if( contact_text.error )
+	{
+		tz_print_error( app, "Out of memory.\n" );
+		goto done;
+	}
+
+	if( format == TZ_FORMAT_CSV )
+	{
+		tz_render_text( render, L"instant,zone,local_time,utc_offset,dst,abbreviation,email,name\n" );
+	}
+	else if( format == TZ_FORMAT_TSV )
+	{
+		tz_render_text( render, L"instant\tzone\tlocal_time\tutc_offset\tdst\tabbreviation\temail\tname\n" );
+	}
+
+	size_t instant_count = (size_t) ((app->timeline_end - app->timeline_start) / app->timeline_step) + 1;
+
+	for( size_t instant = 0; instant < instant_count && !render->error; instant++ )
+	{
+		time_t t = app->timeline_start + (time_t) instant * app->timeline_step;
+		char instant_text[ 64 ];
+		struct tm tm;
+
+		tz_zoneinfo_gmtime( (int64_t) t, &tm );
+		int instant_length = snprintf( instant_text, sizeof(instant_text),
+		                               format == TZ_FORMAT_NDJSON ? "{\"instant\":\"%04d-%02d-%02dT%02d:%02d:%02dZ\"," : "%04d-%02d-%02dT%02d:%02d:%02dZ%c",
+		                               tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday, tm.tm_hour, tm.tm_min, tm.tm_sec, (char) tz_format_separator( format ) );
+
+		tz_render_clear( &zone_text );
+		for( tz_zone_id_t id = 0; id < zone_count; id++ )
+		{
+			tz_zone_t zone;
+
+			// Zones the query leaves out at this instant get no text.
+			zone_offsets[ id ] = zone_text.length;
+			if( tz_zone_cache_lookup( app->zones, id, t, &zone ) && tz_query_match_zone( app->query, &zone ) )
+			{
+				timeline_zone( &zone_text, format, &zone );
+			}
+		}
+		zone_offsets[ zone_count ] = zone_text.length;
+
+		if( zone_text.error )
+		{
+			tz_print_error( app, "Out of memory.\n" );
+			goto done;
+		}
+
+		for( size_t i = 0; i < contact_count; i++ )
+		{
+			tz_zone_id_t id = contacts[ i ].zone;
+
+			if( zone_offsets[ id ] == zone_offsets[ id + 1 ] )
+			{
+				continue;
+			}
+
+			tz_render_bytes( render, instant_text, instant_length );
+			tz_render_bytes( render, zone_text.buffer + zone_offsets[ id ], zone_offsets[ id + 1 ] - zone_offsets[ id ] );
+			tz_render_bytes( render, contact_text.buffer + contact_offsets[ i ], contact_offsets[ i + 1 ] - contact_offsets[ i ] );
+			records += 1;
+		}
+	}
+
+	result = tz_render_flush( render );
+	clock_gettime( CLOCK_MONOTONIC, &export_end );
+
+	if( app->stats )
+	{
+		double seconds = (export_end.tv_sec - export_start.tv_sec) + (export_end.tv_nsec - export_start.tv_nsec) / 1e9;
+
+		fprintf( stderr, "Exported %zu records (%zu instants, %zu zones) in %.3f ms (%.0f records/s).\n",
+		         records, instant_count, zone_count, seconds * 1000.0, seconds > 0.0 ? records / seconds : 0.0 );
+	}
+
+done:
+	if( zone_text_created )
+	{
+		tz_render_destroy( &zone_text );
+	}
+	if( contact_text_created )
+	{
+		tz_render_destroy( &contact_text );
+	}
+	free( zone_offsets );
+	free( contact_offsets );
+	return result;
+}
+
+void timeline_zone( tz_render_t* render, tz_format_t format, const tz_zone_t* zone )
+{
+	char text[ 192 ];
+	long offset = zone->utc_offset < 0 ? -zone->utc_offset : zone->utc_offset;
+	const struct tm* tm = &zone->local_time;
+
+	if( format != TZ_FORMAT_NDJSON )
+	{
+		char separator = (char) tz_format_separator( format );
+
+		tz_format_narrow_string( render, format, zone->name );
+		snprintf( text, sizeof(text), "%c%04d-%02d-%02dT%02d:%02d:%02d%c%02ld:%02ld%c%ld%c%s%c",
+		          separator, tm->tm_year + 1900, tm->tm_mon + 1, tm->tm_mday, tm->tm_hour, tm->tm_min, tm->tm_sec,
+		          zone->utc_offset < 0 ? '-' : '+', offset / 3600, offset / 60 % 60,
+		          separator, zone->utc_offset, separator, zone->dst ? "true" : "false", separator );
+		tz_render_bytes( render, text, strlen(text) );
+		tz_format_narrow_string( render, format, zone->abbreviation );
+		tz_render_char( render, separator );
+	}
+	else
+	{
+		tz_render_bytes( render, "\"zone\":", 7 );
+		tz_format_narrow_string( render, format, zone->name );
+		snprintf( text, sizeof(text), ",\"local_time\":\"%04d-%02d-%02dT%02d:%02d:%02d%c%02ld:%02ld\",\"utc_offset\":%ld,\"dst\":%s,\"abbreviation\":",
+		          tm->tm_year + 1900, tm->tm_mon + 1, tm->tm_mday, tm->tm_hour, tm->tm_min, tm->tm_sec,
+		          zone->utc_offset < 0 ? '-' : '+', offset / 3600, offset / 60 % 60,
+		          zone->utc_offset, zone->dst ? "true" : "false" );
+		tz_render_bytes( render, text, strlen(text) );
+		tz_format_narrow_string( render, format, zone->abbreviation );
+		tz_render_char( render, L',' );
+	}
+}
+
+void timeline_contact( tz_render_t* render, tz_format_t format, const timezone_contact_t* contact )
+{
+	if( format != TZ_FORMAT_NDJSON )
+	{
+		tz_format_string( render, format, contact->email );
+		tz_render_char( render, tz_format_separator( format ) );
+		tz_format_string( render, format, contact->name );
+		tz_render_char( render, L'\n' );
+	}
+	else
+	{
+		tz_render_bytes( render, "\"email\":", 8 );
+		tz_format_string( render, format, contact->email );
+		tz_render_bytes( render, ",\"name\":", 8 );
+		tz_format_string( render, format, contact->name );
+		tz_render_bytes( render, "}\n", 2 );
+	}
+}
+
+bool timeline_clock( const char* s, time_t now, int days, time_t* t )
+{
+	const char* formats[] = {
+		"%I:%M:%S %p", /* 01:35:10 PM */
+		"%I:%M %p",    /* 01:35 PM */
+		"%I %p",       /* 1 PM */
+		"%I%p",        /* 1pm */
+		"%H:%M:%S",    /* 13:35:10  */
+		"%H:%M"        /* 13:35 */
+	};
+
+	for( size_t i = 0; i < sizeof(formats) / sizeof(formats[0]); i++ )
+	{
+		struct tm tm;
+
+		/* Initialize with today's date and clear hours, minutes, seconds. */
+		localtime_r( &now, &tm );
+		tm.tm_sec  = 0;
+		tm.tm_min  = 0;
+		tm.tm_hour = 0;
+
+		char* end = strptime( s, formats[ i ], &tm );
+		if( end && *end == '\0' )
+		{
+			tm.tm_mday += days;
+			tm.tm_isdst = -1;
+			*t = mktime( &tm );
+			return *t != (time_t) -1;
+		}
+	}
+
+	return false;
+}
+
+time_t timeline_timegm( struct tm* tm )
+{
+#if defined(_WIN32) || defined(_WIN64)
+	return _mkgmtime( tm );
+#else
+	return timegm( tm );
+#endif
+}
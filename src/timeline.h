@@ -0,0 +1,38 @@
+/*
+ * Copyright (C) 2019-2025, Joe Marrero. http://www.joemarrero.com/
+ * Copyright (C) 2017, End Point Corporation. http://www.endpoint.com/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef _TZ_TIMELINE_H_
+#define _TZ_TIMELINE_H_
+
+#include <stdbool.h>
+#include <time.h>
+#include "timezoner.h"
+#include "render.h"
+
+bool tz_timeline_parse_instant ( const char* s, time_t now, time_t* t );
+bool tz_timeline_parse_clock   ( const char* s, time_t now, time_t* t );
+bool tz_timeline_parse_time    ( const char* s, time_t now, time_t* t );
+bool tz_timeline_parse_times   ( const char* s, time_t now, time_t* times, size_t capacity, size_t* count );
+bool tz_timeline_parse_step    ( const char* s, long* seconds );
+bool tz_timeline               ( tz_render_t* render, const tz_app_t* app, const timezone_contact_t* contacts );
+
+#endif /* _TZ_TIMELINE_H_ */
@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 2019-2025, Joe Marrero. http://www.joemarrero.com/
+ * Copyright (C) 2017, End Point Corporation. http://www.endpoint.com/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef _TIMEZONER_H_
+#define _TIMEZONER_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <time.h>
+#include <wchar.h>
+/* Grow vectors geometrically (roughly doubling) so that pushes are amortized O(1). */
+#define VECTOR_GROW_AMOUNT(array)      (1 + lc_vector_size(array))
+#include <collections/vector.h>
+#include "arena.h"
+#include "cache.h"
+#include "query.h"
+#include "zone.h"
+
+#define CONFIGURATION_FILENAME  ".timezoner"
+
+typedef struct timezone_contact {
+	tz_zone_id_t zone; /* Interned IANA Timezone Code; https://en.wikipedia.org/wiki/List_of_tz_database_time_zones */
+	const wchar_t* email;
+	const wchar_t* name;
+	const wchar_t* office_phone;
+	const wchar_t* mobile_phone;
+	short working_hours[ 2 ]; /* Minutes past local midnight; -1 for the default */
+	unsigned short email_width; /* Terminal columns of each field, measured once at load */
+	unsigned short name_width;
+	unsigned short office_phone_width;
+	unsigned short mobile_phone_width;
+} timezone_contact_t;
+
+typedef enum tz_parser {
+	TZ_PARSER_FAST = 0, /* single-pass scanner */
+	TZ_PARSER_REGEX,    /* POSIX regular expression */
+} tz_parser_t;
+
+typedef enum tz_format {
+	TZ_FORMAT_TEXT = 0, /* boxes and columns for a terminal */
+	TZ_FORMAT_CSV,
+	TZ_FORMAT_TSV,
+	TZ_FORMAT_JSON,
+	TZ_FORMAT_NDJSON,   /* one JSON object per line */
+} tz_format_t;
+
+typedef struct tz_load_stats {
+	size_t bytes;       /* bytes of configuration read */
+	size_t lines;
+	size_t contacts;
+	double seconds;     /* time spent loading */
+	bool cached;        /* contacts came from the compiled cache */
+} tz_load_stats_t;
+
+typedef struct tz_include {
+	size_t position;             /* contacts read before the include line */
+	const char* pattern;         /* file, directory or glob, relative to the including file */
+} tz_include_t;
+
+typedef struct tz_app { /* App state */
+	bool minimal;
+	bool organize_by_time;
+	bool stats;
+	bool memory_map;
+	tz_parser_t parser;
+	tz_format_t format;
+	int jobs;                    /* threads parsing the configuration */
+	int watch_interval;          /* seconds between redraws; 0 to draw once */
+	int slot_days;               /* days to search for a meeting slot; 0 to not search */
+	int slot_minutes;            /* length of the meeting */
+	time_t timeline_start;       /* first instant to export */
+	time_t timeline_end;         /* last instant to export, inclusive */
+	long timeline_step;          /* seconds between instants; 0 to not export */
+	short working_hours[ 2 ];    /* default working hours, in minutes past local midnight */
+	int column_widths[ 2 ];
+	time_t now;
+	const time_t* instants;      /* every -t, drawn side by side; NULL unless there are several */
+	size_t instant_count;
+	tz_zone_cache_t* zones;
+	tz_arena_t* strings;         /* contact strings */
+	tz_cache_t* cache;           /* compiled configuration; NULL to always parse */
+	tz_query_t* query;           /* --where filter; NULL for every contact */
+	tz_load_stats_t* load_stats;
+	tz_include_t** includes;     /* include lines of the file being read; NULL to refuse them */
+	char*** sources;             /* vector of the files and include directories a load resolved, allocated; NULL to not collect them */
+	FILE* errors;                /* where errors are printed; NULL for stderr */
+} tz_app_t;
+
+void tz_print_error ( const tz_app_t* app,  const char* format, ... );
+bool tz_check_alloc ( const tz_app_t* app, void* mem );
+
+#endif /* _TIMEZONER_H_ */
@@ -0,0 +1,662 @@
+/*
+ * Copyright (C) 2019-2025, Joe Marrero. http://www.joemarrero.com/
+ * Copyright (C) 2017, End Point Corporation. http://www.endpoint.com/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <signal.h>
+#include <time.h>
+#if defined(_WIN32) || defined(_WIN64)
+# include <windows.h>
+#else
+# include <unistd.h>
+# include <sys/ioctl.h>
+#endif
+#include "timezoner.h"
+#include "display.h"
+#include "reload.h"
+#include "render.h"
+#include "text.h"
+#include "watch.h"
+
+#define WATCH_HIDE_CURSOR    "\033[?25l"
+#define WATCH_SHOW_CURSOR    "\033[?25h"
+#define WATCH_CLEAR_SCREEN   "\033[H\033[2J"
+#define WATCH_CLEAR_LINE     "\033[K"
+#define WATCH_CLEAR_BELOW    "\033[J"
+
+/*
+ * What is currently on the terminal. Clock positions are kept in the
+ * frame renderer; clock_lines maps each of them to its line.
+ */
+typedef struct watch_screen {
+	char* frame;
+	size_t length;
+	size_t capacity;
+	size_t* lines;        /* vector of line start offsets */
+	size_t* line_rows;    /* vector of the screen row each line starts on, then the rows in all */
+	size_t* clock_lines;  /* vector of the line each clock is on */
+	size_t rows;          /* terminal height */
+	size_t columns;       /* terminal width; lines wider than it wrap */
+	size_t ticks;
+	size_t redraws;       /* ticks that regrouped and redrew the frame */
+	size_t lines_drawn;
+} watch_screen_t;
+
+/*
+ * The version of the configuration being shown, and what was built
+ * from it: a zone cache to resolve in, the contacts the query selects
+ * and the store they are grouped from.
+ */
+typedef struct watch_contacts {
+	tz_snapshot_t* snapshot;
+	unsigned int generation;
+	tz_zone_cache_t zones;
+	bool zones_created;
+	timezone_contact_t* matching; /* vector; NULL without a query */
+	tz_contact_store_t store;
+	bool store_created;
+} watch_contacts_t;
+
+#if !defined(_WIN32) && !defined(_WIN64)
+static volatile sig_atomic_t watch_stop    = 0;
+static volatile sig_atomic_t watch_resized = 0;
+
+static void   watch_signal  ( int number );
+static void   watch_size    ( size_t* rows, size_t* columns );
+static void   watch_sleep   ( int interval );
+static bool   watch_load    ( tz_app_t* app, tz_reloader_t* reloader, watch_contacts_t* contacts );
+static void   watch_unload  ( watch_contacts_t* contacts );
+static bool   watch_redraw  ( tz_app_t* app, tz_contact_store_t* store, lc_tree_map_t* map, tz_render_t* frame, tz_render_t* screen, watch_screen_t* shown );
+static bool   watch_patch   ( tz_app_t* app, tz_render_t* frame, tz_render_t* screen, watch_screen_t* shown );
+static void   watch_index   ( const char* frame, size_t length, size_t** lines );
+static void   watch_wrap    ( const char* frame, size_t length, const size_t* lines, size_t columns, size_t** line_rows );
+static size_t watch_line_length ( const char* frame, size_t length, const size_t* lines, size_t line );
+static void   watch_draw    ( tz_render_t* screen, watch_screen_t* shown, size_t row, const char* bytes, size_t length );
+#endif
+
+
+/*
+ * Redraws the contacts every interval until interrupted. Contacts stay
+ * in memory and are only regrouped when a minute boundary is crossed
+ * (which is also when offsets change). In between, only the clocks are
+ * recomputed, and only the lines they are on are redrawn.
+ */
+bool tz_watch( tz_app_t* app, tz_reloader_t* reloader, lc_tree_map_t* map )
+{
+#if defined(_WIN32) || defined(_WIN64)
+	tz_print_error( app, "Watch mode is not supported on this platform.\n" );
+	return false;
+#else
+	bool result = false;
+	watch_screen_t shown = { 0 };
+	watch_contacts_t contacts = { 0 };
+	tz_zone_cache_t* zones = app->zones;
+	tz_render_t frame;
+	tz_render_t screen;
+
+	bool frame_created  = tz_render_create( &frame, NULL, 0 ) && tz_render_record( &frame );
+	bool screen_created = tz_render_create( &screen, stdout, 0 );
+	lc_vector_create( shown.lines, 64 );
+	lc_vector_create( shown.line_rows, 64 );
+	lc_vector_create( shown.clock_lines, 64 );
+
+	if( !frame_created || !screen_created || !shown.lines || !shown.line_rows || !shown.clock_lines )
+	{
+		tz_print_error( app, "Out of memory.\n" );
+		goto done;
+	}
+
+	// Nothing is on screen yet.
+	watch_wrap( shown.frame, 0, shown.lines, shown.columns, &shown.line_rows );
+
+	struct sigaction action;
+	memset( &action, 0, sizeof(action) );
+	action.sa_handler = watch_signal;
+	sigemptyset( &action.sa_mask );
+	// No SA_RESTART; signals should cut the sleep short.
+	sigaction( SIGINT, &action, NULL );
+	sigaction( SIGTERM, &action, NULL );
+	sigaction( SIGWINCH, &action, NULL );
+
+	// With -t the clocks start at that time and advance in real time.
+	time_t started = time(NULL);
+	time_t base    = app->now;
+	time_t minute  = (time_t) -1;
+
+	tz_render_bytes( &screen, WATCH_HIDE_CURSOR WATCH_CLEAR_SCREEN, strlen(WATCH_HIDE_CURSOR WATCH_CLEAR_SCREEN) );
+
+	while( !watch_stop )
+	{
+		time_t now = base + (time(NULL) - started);
+		bool redraw = now / 60 != minute;
+
+		app->now = now;
+
+		if( tz_reloader_generation( reloader ) != contacts.generation )
+		{
+			// The configuration changed; start over with the new version.
+			if( !watch_load( app, reloader, &contacts ) )
+			{
+				tz_print_error( app, "Out of memory.\n" );
+				goto restore;
+			}
+			watch_resized = 1;
+		}
+
+		tz_zone_cache_set_time( app->zones, now );
+
+		// A new width wraps the lines differently, so it's a resize too.
+		size_t columns = shown.columns;
+		watch_size( &shown.rows, &shown.columns );
+		if( shown.columns != columns )
+		{
+			watch_resized = 1;
+		}
+
+		if( watch_resized )
+		{
+			watch_resized = 0;
+			redraw = true;
+			shown.length = 0;
+			watch_index( shown.frame, 0, &shown.lines );
+			watch_wrap( shown.frame, 0, shown.lines, shown.columns, &shown.line_rows );
+			tz_render_bytes( &screen, WATCH_CLEAR_SCREEN, strlen(WATCH_CLEAR_SCREEN) );
+		}
+
+		if( !redraw && !watch_patch( app, &frame, &screen, &shown ) )
+		{
+			// A clock changed width; nothing on screen can be trusted.
+			redraw = true;
+			shown.length = 0;
+			watch_index( shown.frame, 0, &shown.lines );
+			watch_wrap( shown.frame, 0, shown.lines, shown.columns, &shown.line_rows );
+			tz_render_bytes( &screen, WATCH_CLEAR_SCREEN, strlen(WATCH_CLEAR_SCREEN) );
+		}
+
+		if( redraw )
+		{
+			if( !watch_redraw( app, &contacts.store, map, &frame, &screen, &shown ) )
+			{
+				tz_print_error( app, "Out of memory.\n" );
+				goto restore;
+			}
+			minute = now / 60;
+		}
+
+		shown.ticks += 1;
+
+		if( !tz_render_flush( &screen ) )
+		{
+			// The terminal went away.
+			goto done;
+		}
+
+		watch_sleep( app->watch_interval );
+	}
+
+	result = true;
+
+restore:
+	{
+		size_t row_count = shown.line_rows[ lc_vector_size(shown.line_rows) - 1 ];
+		char move[ 32 ];
+		int length = snprintf( move, sizeof(move), "\033[%zu;1H", (row_count < shown.rows ? row_count : shown.rows) + 1 );
+
+		tz_render_bytes( &screen, move, length );
+		tz_render_bytes( &screen, WATCH_SHOW_CURSOR, strlen(WATCH_SHOW_CURSOR) );
+		tz_render_flush( &screen );
+	}
+
+	if( app->stats )
+	{
+		fprintf( stderr, "Watched %zu ticks: %zu redraws, %zu lines drawn.\n", shown.ticks, shown.redraws, shown.lines_drawn );
+	}
+
+done:
+	// The groups point into the snapshot.
+	lc_tree_map_clear( map );
+	watch_unload( &contacts );
+	app->zones = zones;
+	if( shown.lines ) lc_vector_destroy( shown.lines );
+	if( shown.line_rows ) lc_vector_destroy( shown.line_rows );
+	if( shown.clock_lines ) lc_vector_destroy( shown.clock_lines );
+	free( shown.frame );
+	if( screen_created ) tz_render_destroy( &screen );
+	if( frame_created ) tz_render_destroy( &frame );
+	return result;
+#endif
+}
+
+#if !defined(_WIN32) && !defined(_WIN64)
+void watch_signal( int number )
+{
+	if( number == SIGWINCH )
+	{
+		watch_resized = 1;
+	}
+	else
+	{
+		watch_stop = 1;
+	}
+}
+
+void watch_size( size_t* rows, size_t* columns )
+{
+	struct winsize size;
+
+	// Not a terminal; keep every line, unwrapped.
+	*rows    = SIZE_MAX - 1;
+	*columns = SIZE_MAX;
+
+	if( ioctl( STDOUT_FILENO, TIOCGWINSZ, &size ) == 0 )
+	{
+		if( size.ws_row > 0 )
+		{
+			*rows = size.ws_row;
+		}
+		if( size.ws_col > 0 )
+		{
+			*columns = size.ws_col;
+		}
+	}
+}
+
+/*
+ * Sleeps until just after the wall clock's second changes, so the
+ * clocks tick in step with it.
+ */
+void watch_sleep( int interval )
+{
+	struct timespec now;
+	clock_gettime( CLOCK_REALTIME, &now );
+
+	struct timespec delay = {
+		.tv_sec  = interval - 1,
+		.tv_nsec = 1000000000L - now.tv_nsec
+	};
+
+	if( delay.tv_nsec >= 1000000000L )
+	{
+		delay.tv_sec  += 1;
+		delay.tv_nsec -= 1000000000L;
+	}
+
+	nanosleep( &delay, NULL );
+}
+
+/*
+ * Takes the latest snapshot of the configuration and builds what is
+ * shown from it. What was built from the previous one is let go.
+ */
+bool watch_load( tz_app_t* app, tz_reloader_t* reloader, watch_contacts_t* contacts )
+{
+	watch_contacts_t loaded = { 0 };
+	tz_app_t selecting = *app;
+
+	loaded.snapshot   = tz_snapshot_acquire( reloader );
+	loaded.generation = loaded.snapshot->generation;
+
+	loaded.zones_created = tz_snapshot_zones( loaded.snapshot, &loaded.zones, app->now );
+	if( !loaded.zones_created )
+	{
+		goto failed;
+	}
+
+	const timezone_contact_t* rows = loaded.snapshot->contacts;
+
+	if( app->query )
+	{
+		// Only the contacts that match are ever grouped or drawn.
+		selecting.zones = &loaded.zones;
+		lc_vector_create( loaded.matching, lc_vector_size(rows) + 1 );
+
+		if( !loaded.matching ||
+		    !tz_query_select( app->query, tz_snapshot_index( loaded.snapshot ), &selecting, rows, false, &loaded.matching ) )
+		{
+			goto failed;
+		}
+		rows = loaded.matching;
+	}
+
+	loaded.store_created = tz_contact_store_create( &loaded.store, rows );
+	if( !loaded.store_created )
+	{
+		goto failed;
+	}
+
+	watch_unload( contacts );
+	*contacts  = loaded;
+	app->zones = &contacts->zones;
+	return true;
+
+failed:
+	watch_unload( &loaded );
+	return false;
+}
+
+void watch_unload( watch_contacts_t* contacts )
+{
+	if( contacts->store_created )
+	{
+		tz_contact_store_destroy( &contacts->store );
+	}
+
+	if( contacts->matching )
+	{
+		lc_vector_destroy( contacts->matching );
+	}
+
+	if( contacts->zones_created )
+	{
+		tz_zone_cache_destroy( &contacts->zones );
+	}
+
+	if( contacts->snapshot )
+	{
+		tz_snapshot_release( contacts->snapshot );
+	}
+
+	memset( contacts, 0, sizeof(*contacts) );
+}
+
+/*
+ * Regroups, renders a whole frame and redraws the lines that differ
+ * from what is on the terminal.
+ */
+bool watch_redraw( tz_app_t* app, tz_contact_store_t* store, lc_tree_map_t* map, tz_render_t* frame, tz_render_t* screen, watch_screen_t* shown )
+{
+	lc_tree_map_clear( map );
+	if( !tz_organize_data( store, map, app->zones, app->organize_by_time, app->query ) )
+	{
+		return false;
+	}
+
+	tz_render_clear( frame );
+	tz_display( frame, app, map );
+
+	if( frame->error )
+	{
+		return false;
+	}
+
+	size_t* lines = NULL;
+	size_t* line_rows = NULL;
+	lc_vector_create( lines, lc_vector_size(shown->lines) + 1 );
+	lc_vector_create( line_rows, lc_vector_size(shown->lines) + 2 );
+	if( !lines || !line_rows )
+	{
+		if( lines ) lc_vector_destroy( lines );
+		if( line_rows ) lc_vector_destroy( line_rows );
+		return false;
+	}
+	watch_index( frame->buffer, frame->length, &lines );
+	watch_wrap( frame->buffer, frame->length, lines, shown->columns, &line_rows );
+
+	size_t old_count = lc_vector_size( shown->lines );
+	size_t new_count = lc_vector_size( lines );
+	size_t old_rows  = shown->line_rows[ old_count ];
+	size_t new_rows  = line_rows[ new_count ];
+
+	// A line is drawn whole or not at all: running past the last row
+	// would scroll the screen. It's redrawn when it changed, or when a
+	// line above wrapped differently and moved it.
+	for( size_t line = 0; line < new_count && line_rows[ line + 1 ] <= shown->rows; line++ )
+	{
+		size_t length = watch_line_length( frame->buffer, frame->length, lines, line );
+		const char* bytes = frame->buffer + lines[ line ];
+
+		if( line >= old_count ||
+		    line_rows[ line ] != shown->line_rows[ line ] ||
+		    line_rows[ line + 1 ] != shown->line_rows[ line + 1 ] ||
+		    length != watch_line_length( shown->frame, shown->length, shown->lines, line ) ||
+		    memcmp( bytes, shown->frame + shown->lines[ line ], length ) != 0 )
+		{
+			watch_draw( screen, shown, line_rows[ line ], bytes, length );
+		}
+	}
+
+	if( new_rows < old_rows && new_rows < shown->rows )
+	{
+		char move[ 32 ];
+		int length = snprintf( move, sizeof(move), "\033[%zu;1H", new_rows + 1 );
+		tz_render_bytes( screen, move, length );
+		tz_render_bytes( screen, WATCH_CLEAR_BELOW, strlen(WATCH_CLEAR_BELOW) );
+	}
+
+	// What was rendered is now what's on screen.
+	if( frame->length > shown->capacity )
+	{
+		char* copy = realloc( shown->frame, frame->length );
+		if( !copy )
+		{
+			lc_vector_destroy( lines );
+			lc_vector_destroy( line_rows );
+			return false;
+		}
+		shown->frame    = copy;
+		shown->capacity = frame->length;
+	}
+
+	memcpy( shown->frame, frame->buffer, frame->length );
+	shown->length = frame->length;
+
+	lc_vector_destroy( shown->lines );
+	shown->lines = lines;
+	lc_vector_destroy( shown->line_rows );
+	shown->line_rows = line_rows;
+
+	while( lc_vector_size(shown->clock_lines) > 0 )
+	{
+		lc_vector_pop( shown->clock_lines );
+	}
+
+	size_t line = 0;
+	for( size_t i = 0; i < lc_vector_size(frame->clocks); i++ )
+	{
+		while( line + 1 < new_count && lines[ line + 1 ] <= frame->clocks[ i ].offset )
+		{
+			line++;
+		}
+		lc_vector_push( shown->clock_lines, line );
+	}
+
+	shown->redraws += 1;
+	return true;
+}
+
+/*
+ * Recomputes the visible clocks in place and redraws only the lines
+ * they changed. Returns false if a clock no longer fits its slot.
+ */
+bool watch_patch( tz_app_t* app, tz_render_t* frame, tz_render_t* screen, watch_screen_t* shown )
+{
+	size_t count = lc_vector_size( frame->clocks );
+	size_t current_line = 0;
+	bool dirty = false;
+
+	for( size_t i = 0; i < count; i++ )
+	{
+		const tz_render_clock_t* clock = &frame->clocks[ i ];
+		size_t line = shown->clock_lines[ i ];
+
+		if( shown->line_rows[ line + 1 ] > shown->rows )
+		{
+			// Clocks are in frame order; the rest are off screen.
+			break;
+		}
+
+		if( line != current_line && dirty )
+		{
+			watch_draw( screen, shown, shown->line_rows[ current_line ], shown->frame + shown->lines[ current_line ],
+			            watch_line_length( shown->frame, shown->length, shown->lines, current_line ) );
+			dirty = false;
+		}
+		current_line = line;
+
+		const tz_zone_t* zone = tz_zone_cache_resolve( app->zones, clock->zone );
+		char time_str[ 32 ];
+
+		if( !zone || strftime( time_str, sizeof(time_str), clock->format, &zone->local_time ) != clock->length )
+		{
+			return false;
+		}
+
+		if( memcmp( shown->frame + clock->offset, time_str, clock->length ) != 0 )
+		{
+			memcpy( shown->frame + clock->offset, time_str, clock->length );
+			dirty = true;
+		}
+	}
+
+	if( dirty )
+	{
+		watch_draw( screen, shown, shown->line_rows[ current_line ], shown->frame + shown->lines[ current_line ],
+		            watch_line_length( shown->frame, shown->length, shown->lines, current_line ) );
+	}
+
+	return true;
+}
+
+void watch_index( const char* frame, size_t length, size_t** lines )
+{
+	while( lc_vector_size(*lines) > 0 )
+	{
+		lc_vector_pop( *lines );
+	}
+
+	for( size_t start = 0; start < length; )
+	{
+		lc_vector_push( *lines, start );
+
+		const char* newline = memchr( frame + start, '\n', length - start );
+		start = newline ? (size_t) (newline - frame) + 1 : length;
+	}
+}
+
+/*
+ * Works out the screen row each line starts on when lines wider than
+ * the terminal wrap, the way the terminal does it: a character that
+ * doesn't fit in what's left of a row moves to the next. The rows taken
+ * by all of them are pushed last. Escape sequences take no room.
+ */
+void watch_wrap( const char* frame, size_t length, const size_t* lines, size_t columns, size_t** line_rows )
+{
+	size_t row = 0;
+
+	while( lc_vector_size(*line_rows) > 0 )
+	{
+		lc_vector_pop( *line_rows );
+	}
+
+	for( size_t line = 0; line < lc_vector_size(lines); line++ )
+	{
+		size_t end = lines[ line ] + watch_line_length( frame, length, lines, line );
+		size_t column = 0;
+		mbstate_t state;
+
+		lc_vector_push( *line_rows, row );
+		memset( &state, 0, sizeof(state) );
+
+		for( size_t i = lines[ line ]; i < end; )
+		{
+			size_t width = 1;
+			size_t size = 1;
+
+			if( frame[ i ] == '\033' )
+			{
+				// A CSI sequence ends with a byte from '@' to '~'; other escapes are two bytes.
+				size = 2;
+				if( i + 1 < end && frame[ i + 1 ] == '[' )
+				{
+					while( i + size < end && (frame[ i + size ] < '@' || frame[ i + size ] > '~') )
+					{
+						size++;
+					}
+					size++;
+				}
+				width = 0;
+			}
+			else if( (unsigned char) frame[ i ] >= 0x80 )
+			{
+				wchar_t c;
+				size = mbrtowc( &c, frame + i, end - i, &state );
+
+				if( size == (size_t) -1 || size == (size_t) -2 || size == 0 )
+				{
+					memset( &state, 0, sizeof(state) );
+					size = 1;
+				}
+				else
+				{
+					width = tz_text_char_width( c );
+				}
+			}
+
+			if( column + width > columns )
+			{
+				row++;
+				column = 0;
+			}
+			column += width;
+			i += size;
+		}
+
+		row++;
+	}
+
+	lc_vector_push( *line_rows, row );
+}
+
+/*
+ * Length of a line without its newline.
+ */
+size_t watch_line_length( const char* frame, size_t length, const size_t* lines, size_t line )
+{
+	size_t end = line + 1 < lc_vector_size(lines) ? lines[ line + 1 ] : length;
+
+	if( end > lines[ line ] && frame[ end - 1 ] == '\n' )
+	{
+		end -= 1;
+	}
+
+	return end - lines[ line ];
+}
+
+/*
+ * Draws a line from the screen row it starts on. A wrapped line fills
+ * the rows before its last one, so only the end of that needs clearing.
+ */
+void watch_draw( tz_render_t* screen, watch_screen_t* shown, size_t row, const char* bytes, size_t length )
+{
+	char move[ 32 ];
+	int move_length = snprintf( move, sizeof(move), "\033[%zu;1H", row + 1 );
+
+	tz_render_bytes( screen, move, move_length );
+	tz_render_bytes( screen, bytes, length );
+	tz_render_bytes( screen, WATCH_CLEAR_LINE, strlen(WATCH_CLEAR_LINE) );
+
+	shown->lines_drawn += 1;
+}
+#endif
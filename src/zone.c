@@ -0,0 +1,291 @@
+/*
+ * Copyright (C) 2019-2025, Joe Marrero. http://www.joemarrero.com/
+ * Copyright (C) 2017, End Point Corporation. http://www.endpoint.com/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <xtd/string.h>
+#include <xtd/time.h>
+#include <collections/vector.h>
+#include "profile.h"
+#include "zone.h"
+
+static bool zone_map_element_destroy ( void *p_key, void *p_value );
+static int  zone_map_compare         ( const void *p_key_left, const void *p_key_right );
+static long zone_tm_to_seconds       ( const struct tm* tm );
+static void zone_compute             ( tz_zone_t* zone, time_t t );
+static void zone_apply               ( tz_zone_t* zone, const tz_zoneinfo_type_t* type, time_t t );
+
+#define ZONE_LOOKUP_BATCH  (64)
+
+
+bool tz_zone_cache_create( tz_zone_cache_t* cache, time_t now )
+{
+	cache->now        = now;
+	cache->generation = 1;
+	cache->hits       = 0;
+	cache->misses     = 0;
+	cache->load_zoneinfo = true;
+
+	lc_vector_create( cache->zones, 16 );
+	if( !cache->zones )
+	{
+		return false;
+	}
+
+	return lc_tree_map_create( &cache->ids, zone_map_element_destroy, zone_map_compare, malloc, free );
+}
+
+void tz_zone_cache_destroy( tz_zone_cache_t* cache )
+{
+	for( size_t i = 0; i < lc_vector_size(cache->zones); i++ )
+	{
+		if( cache->zones[ i ].info )
+		{
+			tz_zoneinfo_destroy( cache->zones[ i ].info );
+			free( cache->zones[ i ].info );
+		}
+	}
+
+	// The names are owned by the ID map.
+	lc_tree_map_destroy( &cache->ids );
+	lc_vector_destroy( cache->zones );
+}
+
+void tz_zone_cache_set_time( tz_zone_cache_t* cache, time_t now )
+{
+	if( cache->now != now )
+	{
+		// Every zone becomes stale; they are lazily re-resolved.
+		cache->now = now;
+		cache->generation += 1;
+	}
+}
+
+tz_zone_id_t tz_zone_cache_intern( tz_zone_cache_t* cache, const char* name )
+{
+	lc_tree_map_iterator_t itr = lc_tree_map_find( &cache->ids, name );
+
+	if( itr != lc_tree_map_end() )
+	{
+		return (tz_zone_id_t) (uintptr_t) itr->value;
+	}
+
+	tz_zone_id_t id = lc_vector_size( cache->zones );
+	char* interned_name = string_dup( name );
+
+	if( !interned_name )
+	{
+		return TZ_ZONE_ID_INVALID;
+	}
+
+	if( !lc_tree_map_insert( &cache->ids, interned_name, (void*) (uintptr_t) id ) )
+	{
+		free( interned_name );
+		return TZ_ZONE_ID_INVALID;
+	}
+
+	// Zones missing from the tz database fall back to libc.
+	tz_zoneinfo_t* info = cache->load_zoneinfo ? malloc( sizeof(tz_zoneinfo_t) ) : NULL;
+	if( info && !tz_zoneinfo_load( info, name ) )
+	{
+		free( info );
+		info = NULL;
+	}
+
+	tz_zone_t zone = (tz_zone_t) {
+		.name       = interned_name,
+		.info       = info,
+		.utc_offset = 0,
+		.dst        = false,
+		.generation = 0 /* never resolved */
+	};
+	lc_vector_push( cache->zones, zone );
+
+	return id;
+}
+
+const tz_zone_t* tz_zone_cache_resolve( tz_zone_cache_t* cache, tz_zone_id_t id )
+{
+	if( id >= lc_vector_size(cache->zones) )
+	{
+		return NULL;
+	}
+
+	tz_zone_t* zone = &cache->zones[ id ];
+
+	if( zone->generation == cache->generation )
+	{
+		cache->hits += 1;
+	}
+	else
+	{
+		zone_compute( zone, cache->now );
+		zone->generation = cache->generation;
+
+		cache->misses += 1;
+	}
+
+	return zone;
+}
+
+/*
+ * Computes a zone at any instant without changing the cache. This is
+ * pure computation (and so safe from any thread) unless the zone had to
+ * fall back to libc.
+ */
+bool tz_zone_cache_lookup( const tz_zone_cache_t* cache, tz_zone_id_t id, time_t t, tz_zone_t* zone )
+{
+	if( id >= lc_vector_size(cache->zones) )
+	{
+		return false;
+	}
+
+	*zone = cache->zones[ id ];
+	zone_compute( zone, t );
+	zone->generation = 0;
+
+	return true;
+}
+
+/*
+ * Computes a zone at several instants, like tz_zone_cache_lookup(), with
+ * one pass over its transition table. Instants should be ascending.
+ */
+bool tz_zone_cache_lookup_many( const tz_zone_cache_t* cache, tz_zone_id_t id, const time_t* times, size_t count, tz_zone_t* zones )
+{
+	if( id >= lc_vector_size(cache->zones) )
+	{
+		return false;
+	}
+
+	const tz_zone_t* zone = &cache->zones[ id ];
+
+	for( size_t i = 0; i < count; i += ZONE_LOOKUP_BATCH )
+	{
+		size_t batch = count - i < ZONE_LOOKUP_BATCH ? count - i : ZONE_LOOKUP_BATCH;
+		int64_t batch_times[ ZONE_LOOKUP_BATCH ];
+		const tz_zoneinfo_type_t* types[ ZONE_LOOKUP_BATCH ];
+
+		for( size_t j = 0; j < batch; j++ )
+		{
+			batch_times[ j ] = (int64_t) times[ i + j ];
+			zones[ i + j ] = *zone;
+			zones[ i + j ].generation = 0;
+		}
+
+		if( zone->info )
+		{
+			tz_profile_count( zone_computations, batch );
+			tz_zoneinfo_lookup_sorted( zone->info, batch_times, batch, types );
+
+			for( size_t j = 0; j < batch; j++ )
+			{
+				zone_apply( &zones[ i + j ], types[ j ], times[ i + j ] );
+			}
+		}
+		else
+		{
+			for( size_t j = 0; j < batch; j++ )
+			{
+				zone_compute( &zones[ i + j ], times[ i + j ] );
+			}
+		}
+	}
+
+	return true;
+}
+
+size_t tz_zone_cache_size( const tz_zone_cache_t* cache )
+{
+	return lc_vector_size( cache->zones );
+}
+
+bool zone_map_element_destroy( void *p_key, void *p_value )
+{
+	// The value is a zone ID; only the name is allocated.
+	free( p_key );
+	return true;
+}
+
+int zone_map_compare( const void *p_key_left, const void *p_key_right )
+{
+	const char* l = p_key_left;
+	const char* r = p_key_right;
+	return strcmp( l, r );
+}
+
+void zone_compute( tz_zone_t* zone, time_t t )
+{
+	tz_profile_count( zone_computations, 1 );
+
+	if( zone->info )
+	{
+		zone_apply( zone, tz_zoneinfo_lookup( zone->info, t ), t );
+	}
+	else
+	{
+		// This is the only place that switches TZ through libxtd.
+		struct tm* tz_time = time_local( t, zone->name );
+		tz_profile_count( time_local_calls, 1 );
+
+		zone->local_time = *tz_time;
+		zone->utc_offset = zone_tm_to_seconds( tz_time ) - (long) t;
+		zone->dst        = tz_time->tm_isdst > 0;
+
+		if( strftime( zone->abbreviation, sizeof(zone->abbreviation), "%Z", tz_time ) == 0 )
+		{
+			zone->abbreviation[ 0 ] = '\0';
+		}
+	}
+}
+
+void zone_apply( tz_zone_t* zone, const tz_zoneinfo_type_t* type, time_t t )
+{
+	tz_zoneinfo_gmtime( (int64_t) t + type->utc_offset, &zone->local_time );
+	zone->local_time.tm_isdst = type->dst;
+	zone->utc_offset = type->utc_offset;
+	zone->dst        = type->dst;
+	memcpy( zone->abbreviation, type->abbreviation, sizeof(zone->abbreviation) );
+}
+
+/*
+ * Converts a broken-down time to seconds since the epoch as though it
+ * were UTC. The difference from the original instant is the UTC offset,
+ * which avoids depending on the non-portable tm_gmtoff field.
+ */
+long zone_tm_to_seconds( const struct tm* tm )
+{
+	long year  = tm->tm_year + 1900L;
+	long month = tm->tm_mon + 1L;
+
+	// days from civil; see http://howardhinnant.github.io/date_algorithms.html
+	year -= month <= 2;
+	long era = (year >= 0 ? year : year - 399) / 400;
+	long yoe = year - era * 400;
+	long doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + tm->tm_mday - 1;
+	long doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+	long days = era * 146097 + doe - 719468;
+
+	return days * 86400L + tm->tm_hour * 3600L + tm->tm_min * 60L + tm->tm_sec;
+}
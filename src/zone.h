@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2019-2025, Joe Marrero. http://www.joemarrero.com/
+ * Copyright (C) 2017, End Point Corporation. http://www.endpoint.com/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef _TZ_ZONE_H_
+#define _TZ_ZONE_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <time.h>
+#include <collections/tree-map.h>
+#include "zoneinfo.h"
+
+typedef unsigned int tz_zone_id_t;
+
+#define TZ_ZONE_ID_INVALID  ((tz_zone_id_t) -1)
+
+/*
+ * A resolved timezone. The local time, UTC offset and DST flag are
+ * computed once for the cache's current instant and reused by every
+ * contact in the zone.
+ */
+typedef struct tz_zone {
+	const char* name;       /* IANA Timezone Code */
+	tz_zoneinfo_t* info;    /* Transition table; NULL if not in the tz database */
+	struct tm local_time;   /* Local time at the cache's instant */
+	long utc_offset;        /* Seconds east of UTC */
+	bool dst;               /* true if DST is in effect */
+	char abbreviation[ 8 ]; /* e.g. "EST" */
+	unsigned int generation; /* Cache generation this zone was resolved in */
+} tz_zone_t;
+
+/*
+ * Every distinct IANA name is interned once and assigned a small integer
+ * ID, which is simply its index in the zones vector.
+ */
+typedef struct tz_zone_cache {
+	lc_tree_map_t ids; /* name -> zone ID */
+	tz_zone_t* zones;  /* vector indexed by zone ID */
+	time_t now;
+	unsigned int generation;
+	size_t hits;
+	size_t misses;
+	bool load_zoneinfo;      /* false to only intern names */
+} tz_zone_cache_t;
+
+bool             tz_zone_cache_create   ( tz_zone_cache_t* cache, time_t now );
+void             tz_zone_cache_destroy  ( tz_zone_cache_t* cache );
+void             tz_zone_cache_set_time ( tz_zone_cache_t* cache, time_t now );
+tz_zone_id_t     tz_zone_cache_intern   ( tz_zone_cache_t* cache, const char* name );
+const tz_zone_t* tz_zone_cache_resolve  ( tz_zone_cache_t* cache, tz_zone_id_t id );
+bool             tz_zone_cache_lookup   ( const tz_zone_cache_t* cache, tz_zone_id_t id, time_t t, tz_zone_t* zone );
+bool             tz_zone_cache_lookup_many ( const tz_zone_cache_t* cache, tz_zone_id_t id, const time_t* times, size_t count, tz_zone_t* zones );
+size_t           tz_zone_cache_size     ( const tz_zone_cache_t* cache );
+
+#define tz_zone_utc_offset_hours(zone)   ((zone)->utc_offset / 3600.0)
+#define tz_zone_seconds_of_day(zone)     ((zone)->local_time.tm_hour * 3600L + (zone)->local_time.tm_min * 60L + (zone)->local_time.tm_sec)
+
+#endif /* _TZ_ZONE_H_ */
@@ -0,0 +1,772 @@
+/*
+ * Copyright (C) 2019-2025, Joe Marrero. http://www.joemarrero.com/
+ * Copyright (C) 2017, End Point Corporation. http://www.endpoint.com/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+#include <limits.h>
+#include "zoneinfo.h"
+
+#define ZONEINFO_HEADER_SIZE     (44)
+#define ZONEINFO_MAX_FILE_SIZE   (1024 * 1024)
+#define ZONEINFO_MAX_RULE_SIZE   (128)
+
+typedef struct zoneinfo_counts {
+	size_t isutcnt;
+	size_t isstdcnt;
+	size_t leapcnt;
+	size_t timecnt;
+	size_t typecnt;
+	size_t charcnt;
+} zoneinfo_counts_t;
+
+/*
+ * When daylight saving starts and ends in one year of a footer rule.
+ */
+typedef struct zoneinfo_year {
+	int64_t first;              /* the year's first instant, in standard time */
+	int64_t next;               /* the next year's first instant */
+	int64_t start;
+	int64_t end;
+} zoneinfo_year_t;
+
+static void        zoneinfo_counts      ( const unsigned char* header, zoneinfo_counts_t* counts );
+static size_t      zoneinfo_block_size  ( const zoneinfo_counts_t* counts, size_t time_size );
+static uint32_t    zoneinfo_u32         ( const unsigned char* p );
+static int64_t     zoneinfo_i64         ( const unsigned char* p );
+static const char* zoneinfo_parse_name  ( const char* p, char* abbreviation, size_t size );
+static const char* zoneinfo_parse_time  ( const char* p, long* seconds );
+static const char* zoneinfo_parse_date  ( const char* p, tz_zoneinfo_date_t* date );
+static int64_t     zoneinfo_rule_date   ( int64_t year, const tz_zoneinfo_date_t* date );
+static const tz_zoneinfo_type_t* zoneinfo_rule_lookup ( const tz_zoneinfo_rule_t* rule, int64_t t );
+static void        zoneinfo_rule_year   ( const tz_zoneinfo_rule_t* rule, int64_t t, zoneinfo_year_t* year );
+static const tz_zoneinfo_type_t* zoneinfo_rule_type ( const tz_zoneinfo_rule_t* rule, const zoneinfo_year_t* year, int64_t t );
+static int64_t     zoneinfo_days_from_civil ( int64_t year, int month, int day );
+static void        zoneinfo_civil_from_days ( int64_t days, int64_t* year, int* month, int* day );
+static int64_t     zoneinfo_floor_div   ( int64_t a, int64_t b );
+
+
+#if defined(TZ_ZONEINFO_EMBEDDED)
+/*
+ * Finds a zone, e.g. "America/New_York", in the tables compiled into
+ * the program. The tables are shared, so this never touches the file
+ * system and always gives the same answer.
+ */
+bool tz_zoneinfo_load( tz_zoneinfo_t* info, const char* name )
+{
+	size_t low  = 0;
+	size_t high = tz_zoneinfo_name_count;
+
+	memset( info, 0, sizeof(*info) );
+
+	while( low < high )
+	{
+		size_t middle = low + (high - low) / 2;
+		int order = strcmp( tz_zoneinfo_names[ middle ].name, name );
+
+		if( order == 0 )
+		{
+			*info = *tz_zoneinfo_names[ middle ].info;
+			return true;
+		}
+		else if( order < 0 )
+		{
+			low = middle + 1;
+		}
+		else
+		{
+			high = middle;
+		}
+	}
+
+	return false;
+}
+#else
+/*
+ * Loads a zone from the tz database, e.g. "America/New_York". The
+ * TZDIR environment variable overrides the default directory.
+ */
+bool tz_zoneinfo_load( tz_zoneinfo_t* info, const char* name )
+{
+	bool result = false;
+	const char* directory = getenv( "TZDIR" );
+	char filename[ PATH_MAX ];
+
+	memset( info, 0, sizeof(*info) );
+
+	if( !directory || *directory == '\0' )
+	{
+		directory = TZ_ZONEINFO_DIRECTORY;
+	}
+
+	if( *name == '\0' || *name == '/' || strstr( name, ".." ) )
+	{
+		// Only names within the database.
+		return false;
+	}
+
+	if( snprintf( filename, sizeof(filename), "%s/%s", directory, name ) >= (int) sizeof(filename) )
+	{
+		return false;
+	}
+
+	FILE* file = fopen( filename, "rb" );
+	if( !file )
+	{
+		return false;
+	}
+
+	unsigned char* data = malloc( ZONEINFO_MAX_FILE_SIZE );
+	if( data )
+	{
+		size_t size = fread( data, 1, ZONEINFO_MAX_FILE_SIZE, file );
+
+		if( !ferror( file ) && size < ZONEINFO_MAX_FILE_SIZE )
+		{
+			result = tz_zoneinfo_parse( info, data, size );
+		}
+
+		free( data );
+	}
+
+	fclose( file );
+	return result;
+}
+#endif
+
+/*
+ * Parses TZif data (RFC 8536). Version 2 and later files are read from
+ * their 64-bit block, and the footer supplies the rule for instants
+ * past the last transition.
+ */
+bool tz_zoneinfo_parse( tz_zoneinfo_t* info, const unsigned char* data, size_t size )
+{
+	zoneinfo_counts_t counts;
+	size_t time_size = 4;
+	const unsigned char* end = data + size;
+	const unsigned char* block;
+
+	memset( info, 0, sizeof(*info) );
+
+	if( size < ZONEINFO_HEADER_SIZE || memcmp( data, "TZif", 4 ) != 0 )
+	{
+		return false;
+	}
+
+	zoneinfo_counts( data, &counts );
+	block = data + ZONEINFO_HEADER_SIZE;
+
+	if( data[ 4 ] >= '2' )
+	{
+		// Skip the version 1 data in favor of the 64-bit data.
+		const unsigned char* header = block + zoneinfo_block_size( &counts, 4 );
+
+		if( header + ZONEINFO_HEADER_SIZE > end || memcmp( header, "TZif", 4 ) != 0 )
+		{
+			return false;
+		}
+
+		zoneinfo_counts( header, &counts );
+		block = header + ZONEINFO_HEADER_SIZE;
+		time_size = 8;
+	}
+
+	if( counts.typecnt == 0 || counts.typecnt > 256 || counts.charcnt == 0 ||
+	    block + zoneinfo_block_size( &counts, time_size ) > end )
+	{
+		return false;
+	}
+
+	int64_t* transitions       = malloc( sizeof(int64_t) * (counts.timecnt + 1) );
+	unsigned char* indices     = malloc( counts.timecnt + 1 );
+	tz_zoneinfo_type_t* types  = malloc( sizeof(tz_zoneinfo_type_t) * counts.typecnt );
+
+	info->transitions = transitions;
+	info->indices     = indices;
+	info->types       = types;
+
+	if( !transitions || !indices || !types )
+	{
+		goto failed;
+	}
+
+	const unsigned char* p = block;
+
+	for( size_t i = 0; i < counts.timecnt; i++, p += time_size )
+	{
+		transitions[ i ] = time_size == 8 ? zoneinfo_i64( p ) : (int32_t) zoneinfo_u32( p );
+
+		if( i > 0 && transitions[ i ] <= transitions[ i - 1 ] )
+		{
+			goto failed;
+		}
+	}
+
+	for( size_t i = 0; i < counts.timecnt; i++, p++ )
+	{
+		if( *p >= counts.typecnt )
+		{
+			goto failed;
+		}
+		indices[ i ] = *p;
+	}
+
+	const unsigned char* abbreviations = p + counts.typecnt * 6;
+
+	for( size_t i = 0; i < counts.typecnt; i++, p += 6 )
+	{
+		tz_zoneinfo_type_t* type = &types[ i ];
+		size_t index = p[ 5 ];
+
+		if( index >= counts.charcnt )
+		{
+			goto failed;
+		}
+
+		type->utc_offset = (int32_t) zoneinfo_u32( p );
+		type->dst        = p[ 4 ] != 0;
+
+		size_t length = 0;
+		while( index + length < counts.charcnt && abbreviations[ index + length ] &&
+		       length < sizeof(type->abbreviation) - 1 )
+		{
+			type->abbreviation[ length ] = abbreviations[ index + length ];
+			length++;
+		}
+		type->abbreviation[ length ] = '\0';
+	}
+
+	info->transition_count = counts.timecnt;
+	info->type_count       = counts.typecnt;
+
+	// The footer is a POSIX TZ string between two newlines.
+	p = block + zoneinfo_block_size( &counts, time_size );
+
+	if( time_size == 8 && p < end && *p == '\n' )
+	{
+		const unsigned char* newline = memchr( p + 1, '\n', end - p - 1 );
+
+		if( newline && newline - p - 1 < ZONEINFO_MAX_RULE_SIZE )
+		{
+			char tz[ ZONEINFO_MAX_RULE_SIZE ];
+			memcpy( tz, p + 1, newline - p - 1 );
+			tz[ newline - p - 1 ] = '\0';
+
+			info->has_rule = *tz && tz_zoneinfo_parse_rule( &info->rule, tz );
+		}
+	}
+
+	return true;
+
+failed:
+	tz_zoneinfo_destroy( info );
+	return false;
+}
+
+void tz_zoneinfo_destroy( tz_zoneinfo_t* info )
+{
+	if( !info->embedded )
+	{
+		free( (void*) info->transitions );
+		free( (void*) info->indices );
+		free( (void*) info->types );
+	}
+	memset( info, 0, sizeof(*info) );
+}
+
+/*
+ * The local time type in effect at instant t.
+ */
+const tz_zoneinfo_type_t* tz_zoneinfo_lookup( const tz_zoneinfo_t* info, int64_t t )
+{
+	size_t count = info->transition_count;
+
+	if( count == 0 || t >= info->transitions[ count - 1 ] )
+	{
+		if( info->has_rule )
+		{
+			return zoneinfo_rule_lookup( &info->rule, t );
+		}
+		else if( count == 0 )
+		{
+			return &info->types[ 0 ];
+		}
+	}
+
+	if( t < info->transitions[ 0 ] )
+	{
+		return &info->types[ 0 ];
+	}
+
+	// Find the last transition at or before t.
+	size_t low  = 0;
+	size_t high = count - 1;
+
+	while( low < high )
+	{
+		size_t middle = low + (high - low + 1) / 2;
+
+		if( info->transitions[ middle ] <= t )
+		{
+			low = middle;
+		}
+		else
+		{
+			high = middle - 1;
+		}
+	}
+
+	return &info->types[ info->indices[ low ] ];
+}
+
+/*
+ * Looks up the local time types at many instants in one pass. Ascending
+ * instants walk the transitions just once, and the daylight saving
+ * dates of the footer rule are worked out once per year rather than
+ * once per instant. Instants out of order start the walk over.
+ */
+void tz_zoneinfo_lookup_sorted( const tz_zoneinfo_t* info, const int64_t* times, size_t count, const tz_zoneinfo_type_t** types )
+{
+	size_t transition_count = info->transition_count;
+	size_t next = 0; /* first transition after the previous instant */
+	zoneinfo_year_t year = { 0, 0, 0, 0 };
+	bool year_valid = false;
+
+	for( size_t i = 0; i < count; i++ )
+	{
+		int64_t t = times[ i ];
+
+		if( i > 0 && t < times[ i - 1 ] )
+		{
+			next = 0;
+		}
+
+		if( transition_count == 0 || t >= info->transitions[ transition_count - 1 ] )
+		{
+			if( info->has_rule && info->rule.has_daylight )
+			{
+				if( !year_valid || t < year.first || t >= year.next )
+				{
+					zoneinfo_rule_year( &info->rule, t, &year );
+					year_valid = true;
+				}
+				types[ i ] = zoneinfo_rule_type( &info->rule, &year, t );
+				continue;
+			}
+			else if( info->has_rule )
+			{
+				types[ i ] = &info->rule.standard;
+				continue;
+			}
+			else if( transition_count == 0 )
+			{
+				types[ i ] = &info->types[ 0 ];
+				continue;
+			}
+		}
+
+		while( next < transition_count && info->transitions[ next ] <= t )
+		{
+			next += 1;
+		}
+
+		types[ i ] = next == 0 ? &info->types[ 0 ] : &info->types[ info->indices[ next - 1 ] ];
+	}
+}
+
+/*
+ * Parses a POSIX TZ string such as "EST5EDT,M3.2.0,M11.1.0" or
+ * "<+1030>-10:30<+11>-11,M10.1.0,M4.1.0".
+ */
+bool tz_zoneinfo_parse_rule( tz_zoneinfo_rule_t* rule, const char* tz )
+{
+	const char* p = tz;
+	long offset;
+
+	memset( rule, 0, sizeof(*rule) );
+
+	p = zoneinfo_parse_name( p, rule->standard.abbreviation, sizeof(rule->standard.abbreviation) );
+	if( !p || !(p = zoneinfo_parse_time( p, &offset )) )
+	{
+		return false;
+	}
+
+	// POSIX offsets are positive west of Greenwich.
+	rule->standard.utc_offset = -offset;
+	rule->standard.dst        = false;
+
+	if( *p == '\0' )
+	{
+		return true;
+	}
+
+	p = zoneinfo_parse_name( p, rule->daylight.abbreviation, sizeof(rule->daylight.abbreviation) );
+	if( !p )
+	{
+		return false;
+	}
+
+	rule->has_daylight        = true;
+	rule->daylight.dst        = true;
+	rule->daylight.utc_offset = rule->standard.utc_offset + 3600;
+
+	if( *p != ',' && *p != '\0' )
+	{
+		if( !(p = zoneinfo_parse_time( p, &offset )) )
+		{
+			return false;
+		}
+		rule->daylight.utc_offset = -offset;
+	}
+
+	if( *p == '\0' )
+	{
+		// No rule given; use the US rules like most implementations.
+		p = ",M3.2.0,M11.1.0";
+	}
+
+	if( *p++ != ',' || !(p = zoneinfo_parse_date( p, &rule->start )) ||
+	    *p++ != ',' || !(p = zoneinfo_parse_date( p, &rule->end )) )
+	{
+		return false;
+	}
+
+	return *p == '\0';
+}
+
+/*
+ * Breaks down seconds since the epoch as UTC, like gmtime_r() but for
+ * the whole 64-bit range and without touching any global state.
+ */
+void tz_zoneinfo_gmtime( int64_t t, struct tm* tm )
+{
+	int64_t days    = zoneinfo_floor_div( t, 86400 );
+	int64_t seconds = t - days * 86400;
+	int64_t year;
+	int month;
+	int day;
+
+	zoneinfo_civil_from_days( days, &year, &month, &day );
+
+	memset( tm, 0, sizeof(*tm) );
+	tm->tm_year  = (int) (year - 1900);
+	tm->tm_mon   = month - 1;
+	tm->tm_mday  = day;
+	tm->tm_hour  = (int) (seconds / 3600);
+	tm->tm_min   = (int) (seconds / 60 % 60);
+	tm->tm_sec   = (int) (seconds % 60);
+	tm->tm_wday  = (int) (days - zoneinfo_floor_div( days + 4, 7 ) * 7 + 4); /* 1970-01-01 was a Thursday */
+	tm->tm_yday  = (int) (days - zoneinfo_days_from_civil( year, 1, 1 ));
+	tm->tm_isdst = 0;
+}
+
+void zoneinfo_counts( const unsigned char* header, zoneinfo_counts_t* counts )
+{
+	counts->isutcnt  = zoneinfo_u32( header + 20 );
+	counts->isstdcnt = zoneinfo_u32( header + 24 );
+	counts->leapcnt  = zoneinfo_u32( header + 28 );
+	counts->timecnt  = zoneinfo_u32( header + 32 );
+	counts->typecnt  = zoneinfo_u32( header + 36 );
+	counts->charcnt  = zoneinfo_u32( header + 40 );
+}
+
+size_t zoneinfo_block_size( const zoneinfo_counts_t* counts, size_t time_size )
+{
+	return counts->timecnt * (time_size + 1) +
+	       counts->typecnt * 6 +
+	       counts->charcnt +
+	       counts->leapcnt * (time_size + 4) +
+	       counts->isstdcnt +
+	       counts->isutcnt;
+}
+
+uint32_t zoneinfo_u32( const unsigned char* p )
+{
+	return ((uint32_t) p[ 0 ] << 24) | ((uint32_t) p[ 1 ] << 16) | ((uint32_t) p[ 2 ] << 8) | p[ 3 ];
+}
+
+int64_t zoneinfo_i64( const unsigned char* p )
+{
+	return (int64_t) (((uint64_t) zoneinfo_u32( p ) << 32) | zoneinfo_u32( p + 4 ));
+}
+
+/*
+ * A zone abbreviation is either alphabetic ("EST") or quoted in angle
+ * brackets ("<+0530>").
+ */
+const char* zoneinfo_parse_name( const char* p, char* abbreviation, size_t size )
+{
+	size_t length = 0;
+
+	if( *p == '<' )
+	{
+		p++;
+		while( *p && *p != '>' )
+		{
+			if( length < size - 1 )
+			{
+				abbreviation[ length++ ] = *p;
+			}
+			p++;
+		}
+
+		if( *p++ != '>' )
+		{
+			return NULL;
+		}
+	}
+	else
+	{
+		while( isalpha( (unsigned char) *p ) )
+		{
+			if( length < size - 1 )
+			{
+				abbreviation[ length++ ] = *p;
+			}
+			p++;
+		}
+	}
+
+	abbreviation[ length ] = '\0';
+	return length >= 3 ? p : NULL;
+}
+
+/*
+ * [+|-]hh[:mm[:ss]]; hours may go up to 167 in rule times.
+ */
+const char* zoneinfo_parse_time( const char* p, long* seconds )
+{
+	long sign = 1;
+	long fields[ 3 ] = { 0, 0, 0 };
+
+	if( *p == '+' || *p == '-' )
+	{
+		sign = *p++ == '-' ? -1 : 1;
+	}
+
+	for( int i = 0; i < 3; i++ )
+	{
+		if( i > 0 )
+		{
+			if( *p != ':' )
+			{
+				break;
+			}
+			p++;
+		}
+
+		if( !isdigit( (unsigned char) *p ) )
+		{
+			return NULL;
+		}
+
+		while( isdigit( (unsigned char) *p ) && fields[ i ] < 1000 )
+		{
+			fields[ i ] = fields[ i ] * 10 + (*p++ - '0');
+		}
+	}
+
+	if( fields[ 0 ] > 167 || fields[ 1 ] > 59 || fields[ 2 ] > 59 )
+	{
+		return NULL;
+	}
+
+	*seconds = sign * (fields[ 0 ] * 3600 + fields[ 1 ] * 60 + fields[ 2 ]);
+	return p;
+}
+
+/*
+ * Mm.w.d, Jn or n, optionally followed by /time (default 02:00:00).
+ */
+const char* zoneinfo_parse_date( const char* p, tz_zoneinfo_date_t* date )
+{
+	char* end;
+
+	memset( date, 0, sizeof(*date) );
+
+	if( *p == 'M' )
+	{
+		date->kind  = 'M';
+		date->month = (int) strtol( p + 1, &end, 10 );
+		if( *end != '.' ) return NULL;
+		date->week  = (int) strtol( end + 1, &end, 10 );
+		if( *end != '.' ) return NULL;
+		date->day   = (int) strtol( end + 1, &end, 10 );
+
+		if( date->month < 1 || date->month > 12 || date->week < 1 || date->week > 5 || date->day < 0 || date->day > 6 )
+		{
+			return NULL;
+		}
+	}
+	else if( *p == 'J' )
+	{
+		date->kind = 'J';
+		date->day  = (int) strtol( p + 1, &end, 10 );
+
+		if( end == p + 1 || date->day < 1 || date->day > 365 )
+		{
+			return NULL;
+		}
+	}
+	else if( isdigit( (unsigned char) *p ) )
+	{
+		date->kind = 'D';
+		date->day  = (int) strtol( p, &end, 10 );
+
+		if( date->day > 365 )
+		{
+			return NULL;
+		}
+	}
+	else
+	{
+		return NULL;
+	}
+
+	p = end;
+	date->time = 2 * 3600;
+
+	if( *p == '/' )
+	{
+		p = zoneinfo_parse_time( p + 1, &date->time );
+	}
+
+	return p;
+}
+
+/*
+ * Seconds since the epoch, in local time, that a rule date falls on.
+ */
+int64_t zoneinfo_rule_date( int64_t year, const tz_zoneinfo_date_t* date )
+{
+	int64_t days;
+
+	if( date->kind == 'J' )
+	{
+		// February 29th is never counted.
+		bool leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+		days = zoneinfo_days_from_civil( year, 1, 1 ) + date->day - 1 + (leap && date->day >= 60);
+	}
+	else if( date->kind == 'D' )
+	{
+		days = zoneinfo_days_from_civil( year, 1, 1 ) + date->day;
+	}
+	else
+	{
+		static const int month_days[] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+		bool leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+		int length = month_days[ date->month - 1 ] + (leap && date->month == 2);
+
+		int64_t first = zoneinfo_days_from_civil( year, date->month, 1 );
+		int first_weekday = (int) (first - zoneinfo_floor_div( first + 4, 7 ) * 7 + 4);
+		int day = 1 + (date->day - first_weekday + 7) % 7 + (date->week - 1) * 7;
+
+		while( day > length )
+		{
+			// Week 5 means the last one in the month.
+			day -= 7;
+		}
+
+		days = first + day - 1;
+	}
+
+	return days * 86400 + date->time;
+}
+
+const tz_zoneinfo_type_t* zoneinfo_rule_lookup( const tz_zoneinfo_rule_t* rule, int64_t t )
+{
+	if( !rule->has_daylight )
+	{
+		return &rule->standard;
+	}
+
+	zoneinfo_year_t year;
+	zoneinfo_rule_year( rule, t, &year );
+
+	return zoneinfo_rule_type( rule, &year, t );
+}
+
+void zoneinfo_rule_year( const tz_zoneinfo_rule_t* rule, int64_t t, zoneinfo_year_t* year )
+{
+	int64_t number;
+	int month;
+	int day;
+	zoneinfo_civil_from_days( zoneinfo_floor_div( t + rule->standard.utc_offset, 86400 ), &number, &month, &day );
+
+	year->first = zoneinfo_days_from_civil( number, 1, 1 ) * 86400 - rule->standard.utc_offset;
+	year->next  = zoneinfo_days_from_civil( number + 1, 1, 1 ) * 86400 - rule->standard.utc_offset;
+
+	// The start is given in standard time and the end in daylight time.
+	year->start = zoneinfo_rule_date( number, &rule->start ) - rule->standard.utc_offset;
+	year->end   = zoneinfo_rule_date( number, &rule->end ) - rule->daylight.utc_offset;
+}
+
+const tz_zoneinfo_type_t* zoneinfo_rule_type( const tz_zoneinfo_rule_t* rule, const zoneinfo_year_t* year, int64_t t )
+{
+	bool dst;
+
+	if( year->start < year->end )
+	{
+		dst = t >= year->start && t < year->end;
+	}
+	else
+	{
+		// Southern hemisphere; daylight saving spans the new year.
+		dst = t < year->end || t >= year->start;
+	}
+
+	return dst ? &rule->daylight : &rule->standard;
+}
+
+/*
+ * See http://howardhinnant.github.io/date_algorithms.html
+ */
+int64_t zoneinfo_days_from_civil( int64_t year, int month, int day )
+{
+	year -= month <= 2;
+	int64_t era = zoneinfo_floor_div( year, 400 );
+	int64_t yoe = year - era * 400;
+	int64_t doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+	int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+	return era * 146097 + doe - 719468;
+}
+
+void zoneinfo_civil_from_days( int64_t days, int64_t* year, int* month, int* day )
+{
+	days += 719468;
+	int64_t era = zoneinfo_floor_div( days, 146097 );
+	int64_t doe = days - era * 146097;
+	int64_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+	int64_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+	int64_t mp  = (5 * doy + 2) / 153;
+
+	*day   = (int) (doy - (153 * mp + 2) / 5 + 1);
+	*month = (int) (mp < 10 ? mp + 3 : mp - 9);
+	*year  = yoe + era * 400 + (*month <= 2);
+}
+
+int64_t zoneinfo_floor_div( int64_t a, int64_t b )
+{
+	int64_t q = a / b;
+	return (a % b != 0 && (a < 0) != (b < 0)) ? q - 1 : q;
+}
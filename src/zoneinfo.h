@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2019-2025, Joe Marrero. http://www.joemarrero.com/
+ * Copyright (C) 2017, End Point Corporation. http://www.endpoint.com/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef _TZ_ZONEINFO_H_
+#define _TZ_ZONEINFO_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+
+#define TZ_ZONEINFO_DIRECTORY   "/usr/share/zoneinfo"
+
+/*
+ * A local time type: what the wall clock is relative to UTC.
+ */
+typedef struct tz_zoneinfo_type {
+	long utc_offset;            /* Seconds east of UTC */
+	bool dst;
+	char abbreviation[ 8 ];     /* e.g. "EST" or "+0530" */
+} tz_zoneinfo_type_t;
+
+/*
+ * One end of a POSIX TZ daylight saving rule ("M3.2.0/2", "J60", "59").
+ */
+typedef struct tz_zoneinfo_date {
+	char kind;                  /* 'M' month/week/day, 'J' Julian day (1-365), 'D' zero-based day (0-365) */
+	int month;
+	int week;                   /* 1 to 5; 5 is the last week of the month */
+	int day;                    /* day of the week, or the day of the year */
+	long time;                  /* seconds past local midnight; may be negative or past 24h */
+} tz_zoneinfo_date_t;
+
+/*
+ * The footer of a TZif file. It describes every instant after the last
+ * transition in the table.
+ */
+typedef struct tz_zoneinfo_rule {
+	tz_zoneinfo_type_t standard;
+	tz_zoneinfo_type_t daylight;
+	bool has_daylight;
+	tz_zoneinfo_date_t start;   /* daylight saving starts (in standard time) */
+	tz_zoneinfo_date_t end;     /* daylight saving ends (in daylight time) */
+} tz_zoneinfo_rule_t;
+
+/*
+ * A compiled zone from the system tz database (RFC 8536). Transitions
+ * are sorted, so the local time type at any instant is a binary search
+ * away, without going through TZ and tzset().
+ */
+typedef struct tz_zoneinfo {
+	const int64_t* transitions;       /* Transition times, ascending */
+	const unsigned char* indices;     /* Local time type that begins at each transition */
+	size_t transition_count;
+	const tz_zoneinfo_type_t* types;
+	size_t type_count;
+	tz_zoneinfo_rule_t rule;
+	bool has_rule;
+	bool embedded;                    /* tables are compiled into the program; nothing to free */
+} tz_zoneinfo_t;
+
+/*
+ * With TZ_ZONEINFO_EMBEDDED, zones come from tables generated from a tz
+ * database at build time (see tools/zonegen.c) instead of the file
+ * system, sorted by name.
+ */
+typedef struct tz_zoneinfo_name {
+	const char* name;
+	const tz_zoneinfo_t* info;
+} tz_zoneinfo_name_t;
+
+#if defined(TZ_ZONEINFO_EMBEDDED)
+extern const tz_zoneinfo_name_t tz_zoneinfo_names[];
+extern const size_t tz_zoneinfo_name_count;
+extern const char tz_zoneinfo_version[];
+#endif
+
+bool                      tz_zoneinfo_load     ( tz_zoneinfo_t* info, const char* name );
+bool                      tz_zoneinfo_parse    ( tz_zoneinfo_t* info, const unsigned char* data, size_t size );
+void                      tz_zoneinfo_destroy  ( tz_zoneinfo_t* info );
+const tz_zoneinfo_type_t* tz_zoneinfo_lookup   ( const tz_zoneinfo_t* info, int64_t t );
+void                      tz_zoneinfo_lookup_sorted ( const tz_zoneinfo_t* info, const int64_t* times, size_t count, const tz_zoneinfo_type_t** types );
+bool                      tz_zoneinfo_parse_rule ( tz_zoneinfo_rule_t* rule, const char* tz );
+void                      tz_zoneinfo_gmtime   ( int64_t t, struct tm* tm );
+
+#endif /* _TZ_ZONEINFO_H_ */
@@ -0,0 +1,410 @@
+/*
+ * Copyright (C) 2019-2025, Joe Marrero. http://www.joemarrero.com/
+ * Copyright (C) 2017, End Point Corporation. http://www.endpoint.com/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/*
+ * Compiles a tz database directory into C tables for zoneinfo.c. Every
+ * zone becomes constant arrays of its transitions and local time types
+ * plus its rule, and a table sorted by name points at them. Zones with
+ * the same data, such as links, share one set of arrays.
+ *
+ *   zonegen /usr/share/zoneinfo > src/zonedata.c
+ */
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <string.h>
+#include <limits.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include "../src/zoneinfo.h"
+
+#define ZONEGEN_MAX_FILE_SIZE   (1024 * 1024)
+
+typedef struct zonegen_zone {
+	char* name;                 /* relative to the database */
+	tz_zoneinfo_t info;
+	size_t data;                /* zone whose arrays this one uses */
+} zonegen_zone_t;
+
+typedef struct zonegen {
+	zonegen_zone_t* zones;
+	size_t count;
+	size_t capacity;
+} zonegen_t;
+
+static bool zonegen_scan        ( zonegen_t* zonegen, const char* root, const char* relative );
+static bool zonegen_add         ( zonegen_t* zonegen, const char* filename, const char* name );
+static bool zonegen_equal       ( const tz_zoneinfo_t* left, const tz_zoneinfo_t* right );
+static bool zonegen_equal_types ( const tz_zoneinfo_type_t* left, const tz_zoneinfo_type_t* right );
+static bool zonegen_equal_dates ( const tz_zoneinfo_date_t* left, const tz_zoneinfo_date_t* right );
+static int  zonegen_compare     ( const void* left, const void* right );
+static void zonegen_version     ( const char* root, char* version, size_t size );
+static void zonegen_print_type  ( const tz_zoneinfo_type_t* type );
+static void zonegen_print_date  ( const tz_zoneinfo_date_t* date );
+static void zonegen_print_zone  ( size_t index, const tz_zoneinfo_t* info );
+
+
+int main( int argc, char* argv[] )
+{
+	zonegen_t zonegen = { NULL, 0, 0 };
+	char version[ 128 ];
+
+	if( argc != 2 )
+	{
+		fprintf( stderr, "Usage: %s <zoneinfo directory>\n", argv[ 0 ] );
+		return 1;
+	}
+
+	if( !zonegen_scan( &zonegen, argv[ 1 ], "" ) || zonegen.count == 0 )
+	{
+		fprintf( stderr, "No zones found in '%s'.\n", argv[ 1 ] );
+		return 1;
+	}
+
+	qsort( zonegen.zones, zonegen.count, sizeof(zonegen_zone_t), zonegen_compare );
+	zonegen_version( argv[ 1 ], version, sizeof(version) );
+
+	printf( "/* Generated by tools/zonegen from %s (%s). Do not edit. */\n", argv[ 1 ], version );
+	printf( "#include <stdint.h>\n" );
+	printf( "#include \"zoneinfo.h\"\n\n" );
+
+	size_t unique = 0;
+
+	for( size_t i = 0; i < zonegen.count; i++ )
+	{
+		zonegen.zones[ i ].data = i;
+
+		for( size_t j = 0; j < i; j++ )
+		{
+			if( zonegen.zones[ j ].data == j && zonegen_equal( &zonegen.zones[ i ].info, &zonegen.zones[ j ].info ) )
+			{
+				zonegen.zones[ i ].data = j;
+				break;
+			}
+		}
+
+		if( zonegen.zones[ i ].data == i )
+		{
+			zonegen_print_zone( i, &zonegen.zones[ i ].info );
+			unique += 1;
+		}
+	}
+
+	printf( "const tz_zoneinfo_name_t tz_zoneinfo_names[] = {\n" );
+	for( size_t i = 0; i < zonegen.count; i++ )
+	{
+		printf( "\t{ \"%s\", &zone_%zu },\n", zonegen.zones[ i ].name, zonegen.zones[ i ].data );
+	}
+	printf( "};\n\n" );
+	printf( "const size_t tz_zoneinfo_name_count = %zu;\n", zonegen.count );
+	printf( "const char tz_zoneinfo_version[] = \"%s\";\n", version );
+
+	fprintf( stderr, "Embedded %zu zones (%zu distinct) from %s.\n", zonegen.count, unique, argv[ 1 ] );
+
+	for( size_t i = 0; i < zonegen.count; i++ )
+	{
+		free( zonegen.zones[ i ].name );
+		tz_zoneinfo_destroy( &zonegen.zones[ i ].info );
+	}
+	free( zonegen.zones );
+	return 0;
+}
+
+/*
+ * Adds every TZif file under the directory. The posix/ and right/ trees
+ * repeat the database, and localtime and posixrules depend on the host,
+ * so they are left out.
+ */
+bool zonegen_scan( zonegen_t* zonegen, const char* root, const char* relative )
+{
+	char path[ PATH_MAX ];
+	snprintf( path, sizeof(path), "%s%s%s", root, *relative ? "/" : "", relative );
+
+	DIR* directory = opendir( path );
+	if( !directory )
+	{
+		return false;
+	}
+
+	struct dirent* entry;
+	bool result = true;
+
+	while( result && (entry = readdir( directory )) != NULL )
+	{
+		const char* base = entry->d_name;
+		char name[ PATH_MAX ];
+		char filename[ PATH_MAX ];
+		struct stat status;
+
+		if( *base == '.' || strcmp( base, "posix" ) == 0 || strcmp( base, "right" ) == 0 ||
+		    strcmp( base, "localtime" ) == 0 || strcmp( base, "posixrules" ) == 0 )
+		{
+			continue;
+		}
+
+		if( (size_t) snprintf( name, sizeof(name), "%s%s%s", relative, *relative ? "/" : "", base ) >= sizeof(name) ||
+		    (size_t) snprintf( filename, sizeof(filename), "%s/%s", root, name ) >= sizeof(filename) ||
+		    stat( filename, &status ) != 0 )
+		{
+			continue;
+		}
+
+		if( S_ISDIR(status.st_mode) )
+		{
+			result = zonegen_scan( zonegen, root, name );
+		}
+		else if( S_ISREG(status.st_mode) )
+		{
+			result = zonegen_add( zonegen, filename, name );
+		}
+	}
+
+	closedir( directory );
+	return result;
+}
+
+/*
+ * Adds the zone if the file is TZif; anything else (zone.tab,
+ * tzdata.zi, ...) is skipped.
+ */
+bool zonegen_add( zonegen_t* zonegen, const char* filename, const char* name )
+{
+	FILE* file = fopen( filename, "rb" );
+	if( !file )
+	{
+		return true;
+	}
+
+	unsigned char* data = malloc( ZONEGEN_MAX_FILE_SIZE );
+	size_t size = data ? fread( data, 1, ZONEGEN_MAX_FILE_SIZE, file ) : 0;
+	fclose( file );
+
+	tz_zoneinfo_t info;
+
+	if( !data || size == ZONEGEN_MAX_FILE_SIZE || !tz_zoneinfo_parse( &info, data, size ) )
+	{
+		free( data );
+		return data != NULL;
+	}
+	free( data );
+
+	if( zonegen->count == zonegen->capacity )
+	{
+		size_t capacity = zonegen->capacity * 2 + 64;
+		zonegen_zone_t* zones = realloc( zonegen->zones, sizeof(zonegen_zone_t) * capacity );
+
+		if( !zones )
+		{
+			tz_zoneinfo_destroy( &info );
+			return false;
+		}
+		zonegen->zones    = zones;
+		zonegen->capacity = capacity;
+	}
+
+	zonegen_zone_t* zone = &zonegen->zones[ zonegen->count ];
+	zone->name = malloc( strlen( name ) + 1 );
+	zone->info = info;
+
+	if( !zone->name )
+	{
+		tz_zoneinfo_destroy( &info );
+		return false;
+	}
+	strcpy( zone->name, name );
+
+	zonegen->count += 1;
+	return true;
+}
+
+bool zonegen_equal( const tz_zoneinfo_t* left, const tz_zoneinfo_t* right )
+{
+	if( left->transition_count != right->transition_count || left->type_count != right->type_count ||
+	    left->has_rule != right->has_rule )
+	{
+		return false;
+	}
+
+	if( memcmp( left->transitions, right->transitions, sizeof(int64_t) * left->transition_count ) != 0 ||
+	    memcmp( left->indices, right->indices, left->transition_count ) != 0 )
+	{
+		return false;
+	}
+
+	for( size_t i = 0; i < left->type_count; i++ )
+	{
+		if( !zonegen_equal_types( &left->types[ i ], &right->types[ i ] ) )
+		{
+			return false;
+		}
+	}
+
+	return !left->has_rule ||
+	       (zonegen_equal_types( &left->rule.standard, &right->rule.standard ) &&
+	        left->rule.has_daylight == right->rule.has_daylight &&
+	        (!left->rule.has_daylight ||
+	         (zonegen_equal_types( &left->rule.daylight, &right->rule.daylight ) &&
+	          zonegen_equal_dates( &left->rule.start, &right->rule.start ) &&
+	          zonegen_equal_dates( &left->rule.end, &right->rule.end ))));
+}
+
+bool zonegen_equal_types( const tz_zoneinfo_type_t* left, const tz_zoneinfo_type_t* right )
+{
+	return left->utc_offset == right->utc_offset && left->dst == right->dst &&
+	       strcmp( left->abbreviation, right->abbreviation ) == 0;
+}
+
+bool zonegen_equal_dates( const tz_zoneinfo_date_t* left, const tz_zoneinfo_date_t* right )
+{
+	return left->kind == right->kind && left->month == right->month && left->week == right->week &&
+	       left->day == right->day && left->time == right->time;
+}
+
+int zonegen_compare( const void* left, const void* right )
+{
+	const zonegen_zone_t* l = left;
+	const zonegen_zone_t* r = right;
+	return strcmp( l->name, r->name );
+}
+
+/*
+ * The release of the database, from +VERSION or the first line of
+ * tzdata.zi ("# version 2025b").
+ */
+void zonegen_version( const char* root, char* version, size_t size )
+{
+	char filename[ PATH_MAX ];
+	char line[ 128 ] = "";
+	FILE* file;
+
+	snprintf( version, size, "unknown" );
+
+	snprintf( filename, sizeof(filename), "%s/+VERSION", root );
+	if( (file = fopen( filename, "r" )) != NULL )
+	{
+		if( fgets( line, sizeof(line), file ) )
+		{
+			line[ strcspn( line, "\r\n" ) ] = '\0';
+			snprintf( version, size, "%s", line );
+		}
+		fclose( file );
+		return;
+	}
+
+	snprintf( filename, sizeof(filename), "%s/tzdata.zi", root );
+	if( (file = fopen( filename, "r" )) != NULL )
+	{
+		if( fgets( line, sizeof(line), file ) && strncmp( line, "# version ", 10 ) == 0 )
+		{
+			line[ strcspn( line, "\r\n" ) ] = '\0';
+			snprintf( version, size, "%s", line + 10 );
+		}
+		fclose( file );
+	}
+}
+
+void zonegen_print_type( const tz_zoneinfo_type_t* type )
+{
+	// Abbreviations are letters, digits, '+' and '-'.
+	printf( "{ %ld, %s, \"%s\" }", type->utc_offset, type->dst ? "true" : "false", type->abbreviation );
+}
+
+void zonegen_print_date( const tz_zoneinfo_date_t* date )
+{
+	if( date->kind )
+	{
+		printf( "{ '%c', %d, %d, %d, %ld }", date->kind, date->month, date->week, date->day, date->time );
+	}
+	else
+	{
+		printf( "{ 0, %d, %d, %d, %ld }", date->month, date->week, date->day, date->time );
+	}
+}
+
+void zonegen_print_zone( size_t index, const tz_zoneinfo_t* info )
+{
+	if( info->transition_count > 0 )
+	{
+		printf( "static const int64_t zone_%zu_transitions[] = {", index );
+		for( size_t i = 0; i < info->transition_count; i++ )
+		{
+			int64_t t = info->transitions[ i ];
+
+			printf( "%s", i % 6 == 0 ? "\n\t" : " " );
+			if( t == INT64_MIN )
+			{
+				printf( "INT64_MIN," );
+			}
+			else
+			{
+				printf( "INT64_C(%" PRId64 "),", t );
+			}
+		}
+		printf( "\n};\n" );
+
+		printf( "static const unsigned char zone_%zu_indices[] = {", index );
+		for( size_t i = 0; i < info->transition_count; i++ )
+		{
+			printf( "%s%u,", i % 24 == 0 ? "\n\t" : " ", info->indices[ i ] );
+		}
+		printf( "\n};\n" );
+	}
+
+	printf( "static const tz_zoneinfo_type_t zone_%zu_types[] = {\n", index );
+	for( size_t i = 0; i < info->type_count; i++ )
+	{
+		printf( "\t" );
+		zonegen_print_type( &info->types[ i ] );
+		printf( ",\n" );
+	}
+	printf( "};\n" );
+
+	printf( "static const tz_zoneinfo_t zone_%zu = {\n", index );
+	if( info->transition_count > 0 )
+	{
+		printf( "\t.transitions = zone_%zu_transitions,\n", index );
+		printf( "\t.indices = zone_%zu_indices,\n", index );
+	}
+	printf( "\t.transition_count = %zu,\n", info->transition_count );
+	printf( "\t.types = zone_%zu_types,\n", index );
+	printf( "\t.type_count = %zu,\n", info->type_count );
+
+	if( info->has_rule )
+	{
+		printf( "\t.rule = {\n\t\t.standard = " );
+		zonegen_print_type( &info->rule.standard );
+		printf( ",\n\t\t.daylight = " );
+		zonegen_print_type( &info->rule.daylight );
+		printf( ",\n\t\t.has_daylight = %s,\n\t\t.start = ", info->rule.has_daylight ? "true" : "false" );
+		zonegen_print_date( &info->rule.start );
+		printf( ",\n\t\t.end = " );
+		zonegen_print_date( &info->rule.end );
+		printf( "\n\t},\n" );
+		printf( "\t.has_rule = true,\n" );
+	}
+
+	printf( "\t.embedded = true\n" );
+	printf( "};\n\n" );
+}